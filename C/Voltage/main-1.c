@@ -3,6 +3,9 @@
  *  \author  Peter Chapin <spicacality@kelseymountain.org>
  */
 
+// Needed for the futex used by the barriers.
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
@@ -12,16 +15,18 @@
 #endif
 #include "Timer.h"
 #include "shared.h"
+#include "../../Gaussian/C/spin_barrier.h"
 
 // The barriers need to be global so that all threads can see them.
-static pthread_barrier_t pass_barrier;
-static pthread_barrier_t evaluation_barrier;
+static SpinBarrier pass_barrier;
+static SpinBarrier evaluation_barrier;
 static int good_enough = FALSE;
 
 struct WorkUnit {
     int start_row;  // The first row for the thread to process.
     int stop_row;   // Just past the last row for the thread to process.
     int found_big_change; // Used to indicate if more work is needed.
+    int thread_number;    // Identifies the thread at the barriers.
 };
 
 
@@ -43,8 +48,8 @@ static void *row_processor( void *raw )
                 workspace[i][j] = temp;
             }
         }
-        pthread_barrier_wait( &pass_barrier );
-        pthread_barrier_wait( &evaluation_barrier );
+        spin_barrier_wait( &pass_barrier, arg->thread_number );
+        spin_barrier_wait( &evaluation_barrier, arg->thread_number );
         if( good_enough ) break;
     }
 
@@ -66,15 +71,17 @@ int main_1( void )
     #else
     int processor_count = pthread_num_processors_np( );
     #endif
+    if( processor_count < 1 ) processor_count = 1;
 
     // Initialize barriers.
-    pthread_barrier_init( &pass_barrier, NULL, processor_count + 1 );
-    pthread_barrier_init( &evaluation_barrier, NULL, processor_count + 1 );
+    spin_barrier_init( &pass_barrier, processor_count + 1, SPIN_BARRIER_AUTO );
+    spin_barrier_init( &evaluation_barrier, processor_count + 1, SPIN_BARRIER_AUTO );
 
     // Split problem into subproblems (let each thread work on a subset of the rows)
     struct WorkUnit *work_units = (struct WorkUnit *)malloc( processor_count * sizeof(struct WorkUnit) );
     int rows_per_processor = ( SIZE - 2 ) / processor_count;
     for( int i = 0; i < processor_count; ++i ) {
+        work_units[i].thread_number = i;
         work_units[i].start_row = 1 + i*rows_per_processor;
         if( i == processor_count - 1 ) {
             work_units[i].stop_row = SIZE - 1;
@@ -95,7 +102,7 @@ int main_1( void )
 
     while( 1 ) {
         // Wait on a barrier until the threads complete this pass.
-        pthread_barrier_wait( &pass_barrier );
+        spin_barrier_wait( &pass_barrier, processor_count );
         ++iteration_count;
 
         if( iteration_count % 500 == 0 ) {
@@ -111,12 +118,12 @@ int main_1( void )
         if( !found_big_change ) {
             printf( "\rCompleted iteration %d\n", iteration_count );
             good_enough = TRUE;
-            pthread_barrier_wait( &evaluation_barrier );
+            spin_barrier_wait( &evaluation_barrier, processor_count );
             break;
         }
 
         // Ensure the other threads don't progress until evaluation is complete.
-        pthread_barrier_wait( &evaluation_barrier );
+        spin_barrier_wait( &evaluation_barrier, processor_count );
     }
 
     // Join with the threads.
@@ -129,8 +136,8 @@ int main_1( void )
     free( work_units );
 
     // Destroy the barriers.
-    pthread_barrier_destroy( &evaluation_barrier );
-    pthread_barrier_destroy( &pass_barrier );
+    spin_barrier_destroy( &evaluation_barrier );
+    spin_barrier_destroy( &pass_barrier );
 
     // Display the answer.
     printf( "Saving result...\n" );
@@ -0,0 +1,172 @@
+/*!
+ * \file   barrier_benchmark.c
+ * \brief  Compares the latency of pthread_barrier_t with the barriers in spin_barrier.h.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * A team of threads passes through a barrier many times in a row with no work in between, so
+ * the time per episode is the latency of the barrier itself. This is the cost paid twice per
+ * pivot by the barrier versions of the solver. Optionally each thread does a small, fixed
+ * amount of work between barriers to simulate threads that don't arrive at exactly the same
+ * moment.
+ *
+ * Usage: BarrierBenchmark [-t threads,...] [-n episodes] [-u work]
+ */
+
+// Needed for the futex used by the barriers.
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../C/spin_barrier.h"
+
+enum Kind { KIND_PTHREAD, KIND_FLAT, KIND_TREE, KIND_COUNT };
+
+static const char *const kind_names[KIND_COUNT] = { "pthread", "spin-flat", "spin-tree" };
+
+struct Team {
+    enum Kind         kind;
+    int               thread_count;
+    long              episodes;
+    long              work;
+    pthread_barrier_t system_barrier;
+    SpinBarrier       spin_barrier;
+};
+
+struct Member {
+    struct Team *team;
+    int          thread_number;
+};
+
+// Prevents the compiler from removing the simulated work.
+static volatile double sink;
+
+
+static void barrier_wait( struct Team *team, int thread_number )
+{
+    if( team->kind == KIND_PTHREAD )
+        pthread_barrier_wait( &team->system_barrier );
+    else
+        spin_barrier_wait( &team->spin_barrier, thread_number );
+}
+
+
+static void *member_main( void *raw )
+{
+    struct Member *member = (struct Member *)raw;
+    struct Team   *team   = member->team;
+    double         sum    = 0.0;
+
+    for( long episode = 0; episode < team->episodes; ++episode ) {
+        // Threads with higher numbers do a little more work so that they arrive later.
+        for( long i = 0; i < team->work * ( 1 + member->thread_number % 4 ); ++i ) sum += i * 0.5;
+        barrier_wait( team, member->thread_number );
+    }
+    sink = sum;
+    return NULL;
+}
+
+
+static double now( void )
+{
+    struct timespec t;
+    clock_gettime( CLOCK_MONOTONIC, &t );
+    return t.tv_sec + t.tv_nsec / 1.0E9;
+}
+
+
+//! Returns the mean time per episode in nanoseconds, or a negative value on error.
+static double measure( enum Kind kind, int thread_count, long episodes, long work )
+{
+    struct Team team;
+    team.kind         = kind;
+    team.thread_count = thread_count;
+    team.episodes     = episodes;
+    team.work         = work;
+
+    int rc;
+    if( kind == KIND_PTHREAD )
+        rc = pthread_barrier_init( &team.system_barrier, NULL, thread_count );
+    else
+        rc = spin_barrier_init( &team.spin_barrier, thread_count, kind == KIND_FLAT ? SPIN_BARRIER_FLAT : SPIN_BARRIER_TREE );
+    if( rc != 0 ) return -1.0;
+
+    struct Member *members = (struct Member *)malloc( thread_count * sizeof( struct Member ) );
+    pthread_t     *thread_IDs = (pthread_t *)malloc( thread_count * sizeof( pthread_t ) );
+
+    // The calling thread is member zero.
+    double start = now( );
+    for( int i = 0; i < thread_count; ++i ) {
+        members[i].team = &team;
+        members[i].thread_number = i;
+        if( i != 0 ) pthread_create( &thread_IDs[i], NULL, member_main, &members[i] );
+    }
+    member_main( &members[0] );
+    for( int i = 1; i < thread_count; ++i ) {
+        pthread_join( thread_IDs[i], NULL );
+    }
+    double elapsed = now( ) - start;
+
+    free( thread_IDs );
+    free( members );
+    if( kind == KIND_PTHREAD )
+        pthread_barrier_destroy( &team.system_barrier );
+    else
+        spin_barrier_destroy( &team.spin_barrier );
+
+    return elapsed / episodes * 1.0E9;
+}
+
+
+int main( int argc, char *argv[] )
+{
+    char thread_list[256];
+    long episodes = 100000;
+    long work = 0;
+    int  option;
+
+    snprintf( thread_list, sizeof( thread_list ), "1,2,4,%ld", sysconf( _SC_NPROCESSORS_ONLN ) );
+    while( ( option = getopt( argc, argv, "t:n:u:" ) ) != -1 ) {
+        switch( option ) {
+        case 't':
+            snprintf( thread_list, sizeof( thread_list ), "%s", optarg );
+            break;
+        case 'n':
+            episodes = atol( optarg );
+            break;
+        case 'u':
+            work = atol( optarg );
+            break;
+        default:
+            fprintf( stderr, "Usage: %s [-t threads,...] [-n episodes] [-u work]\n", argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+    if( episodes <= 0 || work < 0 ) {
+        fprintf( stderr, "The number of episodes must be positive and the work non-negative\n" );
+        return EXIT_FAILURE;
+    }
+
+    printf( "Nanoseconds per barrier episode (%ld episodes, work %ld)\n", episodes, work );
+    printf( "%8s", "threads" );
+    for( int kind = 0; kind < KIND_COUNT; ++kind ) printf( " %12s", kind_names[kind] );
+    printf( "\n" );
+
+    for( char *item = strtok( thread_list, "," ); item != NULL; item = strtok( NULL, "," ) ) {
+        const int thread_count = atoi( item );
+        if( thread_count <= 0 ) continue;
+        printf( "%8d", thread_count );
+        for( int kind = 0; kind < KIND_COUNT; ++kind ) {
+            const double latency = measure( (enum Kind)kind, thread_count, episodes, work );
+            if( latency < 0.0 ) printf( " %12s", "error" );
+            else printf( " %12.1f", latency );
+            fflush( stdout );
+        }
+        printf( "\n" );
+    }
+    return EXIT_SUCCESS;
+}
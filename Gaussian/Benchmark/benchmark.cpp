@@ -0,0 +1,422 @@
+/*!
+    \file   benchmark.cpp
+    \brief  Measures every version of the Gaussian Elimination solver in one run.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    Each selected backend (see ../Library/backend.h) is run on random, diagonally dominant systems of each
+    requested size. Backends that use threads are also run with each requested thread count.
+    Every measurement is preceded by warm-up runs that are not timed. All backends see exactly
+    the same systems; the systems are diagonally dominant because the MPI version does not
+    pivot.
+
+    For each measurement the minimum, median, and maximum times are reported along with the
+    rate (in GFLOP/s, based on the median time and the usual 2/3 n^3 + 2 n^2 operation count)
+    and the relative residual |b - Ax| / |b| of the last solution. The results are printed as a
+    table and can also be written as CSV (-c) and JSON (-j). The CSV file is written as results
+    are produced so a partial run still leaves useful data.
+
+    When built with MPI=1 the program must be started with mpirun. The MPI backends are run
+    first by every process. After that only process zero continues; the others wait without
+    spinning so they don't steal processors from the threaded backends.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#ifdef BENCHMARK_MPI
+#include <mpi.h>
+#include <time.h>
+#endif
+#include "../C/splitmix64.h"
+#include "../C/thread_count.h"
+#include "../Library/backend.h"
+
+namespace {
+
+    struct Options {
+        std::vector< std::size_t > sizes;
+        std::vector< int >         thread_counts;
+        std::vector< std::string > selected;       // Empty means all backends.
+        int         warm_up_count;
+        int         repetition_count;
+        std::uint64_t seed;
+        const char *csv_name;
+        const char *json_name;
+    };
+
+    struct Result {
+        std::string backend;
+        std::size_t size;
+        int         thread_count;
+        int         process_count;
+        int         repetition_count;
+        double      minimum;
+        double      median;
+        double      maximum;
+        double      gflops;
+        double      residual;
+        std::string status;
+    };
+
+    int my_rank = 0;
+    int process_count = 1;
+
+
+    //! Creates a diagonally dominant system. Every process creates the same system.
+    void make_system( std::size_t size, std::uint64_t seed, std::vector< double > &a, std::vector< double > &b )
+    {
+        a.resize( size * size );
+        b.resize( size );
+        for( std::size_t i = 0; i < size; ++i ) {
+            double *row = &a[i * size];
+            double off_diagonal = 0.0;
+            for( std::size_t j = 0; j < size; ++j ) {
+                row[j] = splitmix64_uniform( seed, static_cast<std::uint64_t>( i ) * ( size + 1 ) + j );
+                if( j != i ) off_diagonal += std::fabs( row[j] );
+            }
+            row[i] = ( row[i] < 0.0 ? -1.0 : 1.0 ) * ( off_diagonal + 1.0 );
+            b[i] = splitmix64_uniform( seed, static_cast<std::uint64_t>( i ) * ( size + 1 ) + size );
+        }
+    }
+
+
+    //! Returns |b - Ax| / |b| using the 2-norm.
+    double relative_residual( std::size_t size, const std::vector< double > &a, const std::vector< double > &b, const double *x )
+    {
+        double residual_sum = 0.0;
+        double b_sum = 0.0;
+        for( std::size_t i = 0; i < size; ++i ) {
+            const double *row = &a[i * size];
+            double sum = b[i];
+            for( std::size_t j = 0; j < size; ++j ) sum -= row[j] * x[j];
+            residual_sum += sum * sum;
+            b_sum += b[i] * b[i];
+        }
+        return ( b_sum == 0.0 ) ? std::sqrt( residual_sum ) : std::sqrt( residual_sum / b_sum );
+    }
+
+
+    double now( )
+    {
+        using namespace std::chrono;
+        return duration_cast< duration<double> >( steady_clock::now( ).time_since_epoch( ) ).count( );
+    }
+
+
+    //! Runs one backend on one system with the current thread count.
+    Result measure(
+        const Backend &backend, const Options &options, std::size_t size, int thread_count,
+        const std::vector< double > &a, const std::vector< double > &b )
+    {
+        const bool is_mpi = ( backend.flags & BACKEND_MPI ) != 0;
+        Result result = { backend.name, size, thread_count, is_mpi ? process_count : 1, 0, 0.0, 0.0, 0.0, 0.0, 0.0, "ok" };
+        std::vector< double > a_work( a.size( ) );
+        std::vector< double > b_work( b.size( ) );
+        std::vector< double > times;
+
+        for( int run = 0; run < options.warm_up_count + options.repetition_count; ++run ) {
+            a_work = a;
+            b_work = b;
+            #ifdef BENCHMARK_MPI
+            if( is_mpi ) MPI_Barrier( MPI_COMM_WORLD );
+            #endif
+            const double start = now( );
+            const int error = backend.solve( size, a_work.data( ), b_work.data( ) );
+            const double stop = now( );
+
+            // For an MPI backend every process makes the same decision because the result on
+            // process zero is distributed.
+            int failed = ( error != 0 );
+            #ifdef BENCHMARK_MPI
+            if( is_mpi ) MPI_Bcast( &failed, 1, MPI_INT, 0, MPI_COMM_WORLD );
+            #endif
+            if( failed ) {
+                result.status = "failed";
+                return result;
+            }
+            if( run >= options.warm_up_count ) times.push_back( stop - start );
+        }
+
+        std::sort( times.begin( ), times.end( ) );
+        const double n = static_cast<double>( size );
+        result.repetition_count = static_cast<int>( times.size( ) );
+        result.minimum = times.front( );
+        result.maximum = times.back( );
+        result.median = ( times.size( ) % 2 == 1 ) ?
+            times[times.size( ) / 2] : 0.5 * ( times[times.size( ) / 2 - 1] + times[times.size( ) / 2] );
+        result.gflops = ( 2.0 * n * n * n / 3.0 + 2.0 * n * n ) / result.median / 1.0E9;
+        if( my_rank == 0 ) result.residual = relative_residual( size, a, b, b_work.data( ) );
+        return result;
+    }
+
+
+    void print_result( const Result &result )
+    {
+        std::printf( "%-14s %7zu %7d %5d %11.4f %11.4f %9.3f %11.3e  %s\n",
+                     result.backend.c_str( ), result.size, result.thread_count, result.process_count,
+                     result.minimum, result.median, result.gflops, result.residual, result.status.c_str( ) );
+        std::fflush( stdout );
+    }
+
+
+    void write_csv_header( std::FILE *csv )
+    {
+        std::fprintf( csv, "backend,size,threads,processes,repetitions,min_seconds,median_seconds,max_seconds,gflops,residual,status\n" );
+    }
+
+
+    void write_csv( std::FILE *csv, const Result &result )
+    {
+        std::fprintf( csv, "%s,%zu,%d,%d,%d,%.6e,%.6e,%.6e,%.6e,%.6e,%s\n",
+                      result.backend.c_str( ), result.size, result.thread_count, result.process_count,
+                      result.repetition_count, result.minimum, result.median, result.maximum,
+                      result.gflops, result.residual, result.status.c_str( ) );
+        std::fflush( csv );
+    }
+
+
+    bool write_json( const char *name, const Options &options, const std::vector< Result > &results )
+    {
+        std::FILE *json = std::fopen( name, "w" );
+        if( json == nullptr ) return false;
+
+        std::fprintf( json, "{\n  \"warm_up\": %d,\n  \"repetitions\": %d,\n  \"seed\": %llu,\n  \"results\": [\n",
+                      options.warm_up_count, options.repetition_count, static_cast<unsigned long long>( options.seed ) );
+        for( std::size_t i = 0; i < results.size( ); ++i ) {
+            const Result &result = results[i];
+            std::fprintf( json,
+                          "    { \"backend\": \"%s\", \"size\": %zu, \"threads\": %d, \"processes\": %d, "
+                          "\"repetitions\": %d, \"min_seconds\": %.6e, \"median_seconds\": %.6e, "
+                          "\"max_seconds\": %.6e, \"gflops\": %.6e, \"residual\": %.6e, \"status\": \"%s\" }%s\n",
+                          result.backend.c_str( ), result.size, result.thread_count, result.process_count,
+                          result.repetition_count, result.minimum, result.median, result.maximum,
+                          result.gflops, result.residual, result.status.c_str( ),
+                          ( i + 1 < results.size( ) ) ? "," : "" );
+        }
+        std::fprintf( json, "  ]\n}\n" );
+        return std::fclose( json ) == 0;
+    }
+
+
+    bool is_selected( const Options &options, const char *name )
+    {
+        return options.selected.empty( ) ||
+               std::find( options.selected.begin( ), options.selected.end( ), name ) != options.selected.end( );
+    }
+
+
+    //! Splits a comma separated list.
+    std::vector< std::string > split( const char *list )
+    {
+        std::vector< std::string > result;
+        std::string item;
+        for( const char *p = list; ; ++p ) {
+            if( *p == ',' || *p == '\0' ) {
+                if( !item.empty( ) ) result.push_back( item );
+                item.clear( );
+                if( *p == '\0' ) break;
+            }
+            else {
+                item += *p;
+            }
+        }
+        return result;
+    }
+
+
+    //! Returns 1, 2, 4, ... up to (and including) the number of processors.
+    std::vector< int > default_thread_counts( )
+    {
+        std::vector< int > result;
+        const int processor_count = gaussian_thread_count( );
+        for( int count = 1; count < processor_count; count *= 2 ) result.push_back( count );
+        result.push_back( processor_count );
+        return result;
+    }
+
+
+    //! Runs every selected backend that has (or lacks) the MPI flag.
+    void run_backends( const Options &options, bool mpi_backends, std::FILE *csv, std::vector< Result > &results )
+    {
+        std::vector< double > a;
+        std::vector< double > b;
+
+        for( std::size_t size : options.sizes ) {
+            bool have_system = false;
+            for( std::size_t i = 0; i < backend_count; ++i ) {
+                const Backend &backend = backend_table[i];
+                if( ( ( backend.flags & BACKEND_MPI ) != 0 ) != mpi_backends ) continue;
+                if( !is_selected( options, backend.name ) ) continue;
+                if( !have_system ) {
+                    make_system( size, options.seed, a, b );
+                    have_system = true;
+                }
+
+                const bool threaded = ( backend.flags & BACKEND_THREADED ) != 0;
+                const std::vector< int > single( 1, 1 );
+                for( int thread_count : ( threaded ? options.thread_counts : single ) ) {
+                    const std::string setting = std::to_string( thread_count );
+                    setenv( GAUSSIAN_THREADS_VARIABLE, setting.c_str( ), 1 );
+
+                    Result result;
+                    if( backend.prepare != nullptr && backend.prepare( thread_count ) != 0 ) {
+                        result = Result{ backend.name, size, thread_count, 1, 0, 0.0, 0.0, 0.0, 0.0, 0.0, "unavailable" };
+                    }
+                    else {
+                        result = measure( backend, options, size, thread_count, a, b );
+                        if( backend.release != nullptr ) backend.release( );
+                    }
+
+                    if( my_rank == 0 ) {
+                        print_result( result );
+                        if( csv != nullptr ) write_csv( csv, result );
+                        results.push_back( result );
+                    }
+                }
+            }
+        }
+    }
+
+}
+
+
+int main( int argc, char **argv )
+{
+    Options options = { { 250, 500, 1000 }, default_thread_counts( ), { }, 1, 3, 0, nullptr, nullptr };
+    bool valid = true;
+    bool list = false;
+
+    #ifdef BENCHMARK_MPI
+    MPI_Init( &argc, &argv );
+    MPI_Comm_rank( MPI_COMM_WORLD, &my_rank );
+    MPI_Comm_size( MPI_COMM_WORLD, &process_count );
+    #endif
+
+    for( int i = 1; i < argc && valid; ++i ) {
+        if( std::strcmp( argv[i], "-s" ) == 0 && i + 1 < argc ) {
+            options.sizes.clear( );
+            for( const std::string &item : split( argv[++i] ) ) {
+                const long long size = std::atoll( item.c_str( ) );
+                if( size <= 0 ) valid = false;
+                else options.sizes.push_back( static_cast<std::size_t>( size ) );
+            }
+        }
+        else if( std::strcmp( argv[i], "-t" ) == 0 && i + 1 < argc ) {
+            options.thread_counts.clear( );
+            for( const std::string &item : split( argv[++i] ) ) {
+                const int count = std::atoi( item.c_str( ) );
+                if( count <= 0 ) valid = false;
+                else options.thread_counts.push_back( count );
+            }
+        }
+        else if( std::strcmp( argv[i], "-b" ) == 0 && i + 1 < argc ) {
+            options.selected = split( argv[++i] );
+        }
+        else if( std::strcmp( argv[i], "-w" ) == 0 && i + 1 < argc ) {
+            options.warm_up_count = std::atoi( argv[++i] );
+            if( options.warm_up_count < 0 ) valid = false;
+        }
+        else if( std::strcmp( argv[i], "-r" ) == 0 && i + 1 < argc ) {
+            options.repetition_count = std::atoi( argv[++i] );
+            if( options.repetition_count <= 0 ) valid = false;
+        }
+        else if( std::strcmp( argv[i], "-e" ) == 0 && i + 1 < argc ) {
+            options.seed = std::strtoull( argv[++i], 0, 10 );
+        }
+        else if( std::strcmp( argv[i], "-c" ) == 0 && i + 1 < argc ) {
+            options.csv_name = argv[++i];
+        }
+        else if( std::strcmp( argv[i], "-j" ) == 0 && i + 1 < argc ) {
+            options.json_name = argv[++i];
+        }
+        else if( std::strcmp( argv[i], "-l" ) == 0 ) {
+            list = true;
+        }
+        else {
+            valid = false;
+        }
+    }
+    for( const std::string &name : options.selected ) {
+        bool known = false;
+        for( std::size_t i = 0; i < backend_count; ++i ) {
+            if( name == backend_table[i].name ) known = true;
+        }
+        if( !known ) {
+            if( my_rank == 0 ) std::fprintf( stderr, "Unknown backend: %s\n", name.c_str( ) );
+            valid = false;
+        }
+    }
+
+    if( !valid || list || options.sizes.empty( ) || options.thread_counts.empty( ) ) {
+        if( my_rank == 0 ) {
+            if( !list ) {
+                std::fprintf( stderr,
+                    "Usage: %s [-s sizes] [-t threads] [-b backends] [-w warm-up] [-r repetitions] [-e seed]\n"
+                    "          [-c csv-file] [-j json-file] [-l]\n"
+                    "   Lists are separated by commas. Use -l to list the available backends.\n",
+                    argv[0] );
+            }
+            for( std::size_t i = 0; i < backend_count; ++i ) {
+                std::fprintf( list ? stdout : stderr, "   %-14s %s\n", backend_table[i].name, backend_table[i].description );
+            }
+        }
+        #ifdef BENCHMARK_MPI
+        MPI_Finalize( );
+        #endif
+        return ( valid && list ) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::FILE *csv = nullptr;
+    if( my_rank == 0 && options.csv_name != nullptr ) {
+        if( ( csv = std::fopen( options.csv_name, "w" ) ) == nullptr ) {
+            std::fprintf( stderr, "Unable to open %s\n", options.csv_name );
+        }
+        else {
+            write_csv_header( csv );
+        }
+    }
+
+    if( my_rank == 0 ) {
+        std::printf( "%-14s %7s %7s %5s %11s %11s %9s %11s  %s\n",
+                     "backend", "size", "threads", "procs", "min (s)", "median (s)", "GFLOP/s", "residual", "status" );
+    }
+
+    std::vector< Result > results;
+    run_backends( options, true, csv, results );
+
+    #ifdef BENCHMARK_MPI
+    // The other processes wait for process zero to finish. A blocking barrier would spin.
+    MPI_Request done;
+    if( my_rank == 0 ) {
+        run_backends( options, false, csv, results );
+        MPI_Ibarrier( MPI_COMM_WORLD, &done );
+        MPI_Wait( &done, MPI_STATUS_IGNORE );
+    }
+    else {
+        int finished = 0;
+        const struct timespec pause = { 0, 1000000 };
+        MPI_Ibarrier( MPI_COMM_WORLD, &done );
+        while( MPI_Test( &done, &finished, MPI_STATUS_IGNORE ), !finished ) nanosleep( &pause, nullptr );
+    }
+    #else
+    run_backends( options, false, csv, results );
+    #endif
+
+    int status = EXIT_SUCCESS;
+    if( csv != nullptr && std::fclose( csv ) != 0 ) status = EXIT_FAILURE;
+    if( my_rank == 0 && options.json_name != nullptr && !write_json( options.json_name, options, results ) ) {
+        std::fprintf( stderr, "Unable to write %s\n", options.json_name );
+        status = EXIT_FAILURE;
+    }
+
+    #ifdef BENCHMARK_MPI
+    MPI_Finalize( );
+    #endif
+    return status;
+}
@@ -0,0 +1,171 @@
+/*!
+ * \file   gaussian.c
+ * \brief  A Gaussian Elimination solver.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * This is the OpenMP version of the algorithm. A single parallel region covers the entire
+ * elimination. One thread of the team searches for each pivot and exchanges the rows; the row
+ * updates are then divided into tasks with `omp taskloop` which the other threads (waiting at
+ * the end of the `single` construct) pick up. The taskloop doesn't finish until all of its
+ * tasks have, so the next pivot isn't searched for until the column below the current one has
+ * been eliminated. Only the columns to the right of the pivot column are updated and each
+ * row update is vectorized with `omp simd`. Each task also finds the largest element of the
+ * next pivot column among its rows, so the search for the next pivot only has to compare one
+ * candidate per task.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "gaussian.h"
+#include "../pivot_threshold.h"
+#include "../thread_count.h"
+#include "../triangular_solve.h"
+
+// For profiling, it is best for all functions to be public.
+#define PRIVATE // static
+#define PUBLIC
+
+// Each task updates at least this many elements (unless there are fewer left).
+#define TASK_MINIMUM_ELEMENTS 32768
+
+// No more than this many tasks per thread are created for each pivot.
+#define TASKS_PER_THREAD 4
+
+//! The largest |a[j][i + 1]| found by a task, and the row where it was found.
+struct PivotCandidate {
+    floating_type value;
+    size_t        row;
+};
+
+//! Subtracts multiples of row i from the rows below it, using the other threads of the team.
+/*!
+ * The rows are divided into task_count contiguous ranges, one per task. While it updates its
+ * rows each task also looks for the largest element in column i + 1 (the next pivot column)
+ * and leaves it in candidates[task].
+ */
+PRIVATE void update_rows(
+    size_t size, floating_type (* restrict a)[size], floating_type * restrict b, size_t i, size_t task_count,
+    struct PivotCandidate *candidates )
+{
+    const size_t rows = size - i - 1;
+    const floating_type *const restrict pivot_row = a[i];
+    const floating_type pivot = pivot_row[i];
+    const floating_type pivot_b = b[i];
+
+    // With only one task there is nothing to share; do the work without deferring it.
+    #pragma omp taskloop grainsize( 1 ) if( task_count > 1 )
+    for( size_t task = 0; task < task_count; ++task ) {
+        struct PivotCandidate best = { -1.0, size };
+        const size_t first = i + 1 + task * rows / task_count;
+        const size_t last  = i + 1 + ( task + 1 ) * rows / task_count;
+
+        for( size_t j = first; j < last; ++j ) {
+            floating_type *const restrict row = a[j];
+            const floating_type m = row[i] / pivot;
+
+            // Column i of row j becomes zero. It isn't needed again so it isn't stored.
+            #pragma omp simd
+            for( size_t k = i + 1; k < size; ++k )
+                row[k] -= m * pivot_row[k];
+            b[j] -= m * pivot_b;
+            if( fabs( row[i + 1] ) > best.value ) {
+                best.value = fabs( row[i + 1] );
+                best.row = j;
+            }
+        }
+        candidates[task] = best;
+    }
+}
+
+
+//! Does the elimination step of reducing the system. O(n^3)
+PRIVATE enum GaussianResult elimination( size_t size, floating_type (* restrict a)[size], floating_type * restrict b )
+{
+    const int thread_count = gaussian_thread_count( );
+    const size_t most_tasks = (size_t)TASKS_PER_THREAD * thread_count;
+    struct PivotCandidate *candidates = (struct PivotCandidate *)malloc( most_tasks * sizeof( struct PivotCandidate ) );
+    size_t task_count = 0;
+    enum GaussianResult result = gaussian_success;
+
+    const double threshold = pivot_threshold( size, size, &a[0][0], size );
+
+    #pragma omp parallel num_threads( thread_count )
+    #pragma omp single
+    for( size_t i = 0; i < size - 1; ++i ) {
+
+        // Find the row with the largest value of |a[j][i]|, j = i, ..., n - 1. After the first
+        // pass each task has already found the largest value among its rows while updating
+        // them, so only those candidates need to be compared. The tasks' rows are in order, so
+        // taking the first of equal candidates gives the same pivot as a full search.
+        size_t k = i;
+        floating_type m = fabs( a[i][i] );
+        if( i == 0 ) {
+            for( size_t j = i + 1; j < size; ++j ) {
+                if( fabs( a[j][i] ) > m ) {
+                    k = j;
+                    m = fabs( a[j][i] );
+                }
+            }
+        }
+        else {
+            m = -1.0;
+            for( size_t task = 0; task < task_count; ++task ) {
+                if( candidates[task].value > m ) {
+                    k = candidates[task].row;
+                    m = candidates[task].value;
+                }
+            }
+        }
+
+        // Check for |a[k][i]| zero.
+        if( fabs( a[k][i] ) <= threshold ) {
+            result = gaussian_degenerate;
+            break;
+        }
+
+        // Exchange row i and row k, if necessary. The columns left of i are no longer used.
+        if( k != i ) {
+            for( size_t column = i; column < size; ++column ) {
+                const floating_type temp = a[i][column];
+                a[i][column] = a[k][column];
+                a[k][column] = temp;
+            }
+
+            // Exchange corresponding elements of b.
+            const floating_type temp = b[i];
+            b[i] = b[k];
+            b[k] = temp;
+        }
+
+        // Divide the remaining rows into tasks of a reasonable size.
+        task_count = ( size - i - 1 ) * ( size - i ) / TASK_MINIMUM_ELEMENTS;
+        if( task_count > most_tasks ) task_count = most_tasks;
+        if( task_count > size - i - 1 ) task_count = size - i - 1;
+        if( task_count < 1 ) task_count = 1;
+        update_rows( size, a, b, i, task_count, candidates );
+    }
+    free( candidates );
+    return result;
+}
+
+
+//! Does the back substitution step of solving the system. O(n^2)
+PRIVATE enum GaussianResult back_substitution( size_t size, floating_type (* restrict a)[size], floating_type * restrict b )
+{
+    if( upper_triangular_solve( size, 1, &a[0][0], size, b, 1, gaussian_thread_count( ) ) != 0 )
+        return gaussian_degenerate;
+    return gaussian_success;
+}
+
+
+PUBLIC enum GaussianResult gaussian_solve( size_t size, floating_type (* restrict a)[size], floating_type * restrict b )
+{
+    // We can deal with a 1x1 system, but not an empty system.
+    if( size == 0 ) return gaussian_error;
+
+    enum GaussianResult return_code = elimination( size, a, b );
+    if( return_code == gaussian_success )
+        return_code = back_substitution( size, a, b );
+    return return_code;
+}
@@ -10,6 +10,8 @@
 #include <string.h>
 
 #include "gaussian.h"
+#include "../pivot_threshold.h"
+#include "../triangular_solve.h"
 
 // For profiling, it is best for all functions to be public.
 #define PRIVATE // static
@@ -23,6 +25,8 @@ PRIVATE enum GaussianResult elimination( size_t size, floating_type (* restrict
     size_t         i, j, k;
     floating_type  temp, m;
 
+    const double threshold = pivot_threshold( size, size, &a[0][0], size );
+
     for( i = 0; i < size - 1; ++i ) {
 
         // Find the row with the largest value of |a[j][i]|, j = i, ..., n - 1
@@ -36,8 +40,7 @@ PRIVATE enum GaussianResult elimination( size_t size, floating_type (* restrict
         }
 
         // Check for |a[k][i]| zero.
-        // TODO: The value 1.0E-6 is arbitrary. A more disciplined value should be used.
-        if( fabs( a[k][i] ) <= 1.0E-6 ) {
+        if( fabs( a[k][i] ) <= threshold ) {
             //free( temp_array );
             return gaussian_degenerate;
         }
@@ -70,24 +73,9 @@ PRIVATE enum GaussianResult elimination( size_t size, floating_type (* restrict
 //! Does the back substitution step of solving the system. O(n^2)
 PRIVATE enum GaussianResult back_substitution( size_t size, floating_type (* restrict a)[size], floating_type * restrict b )
 {
-    floating_type sum;
-    size_t        i, j;
-    size_t        counter;
-
-    // We can't count i down from size - 1 to zero (inclusive) because it is unsigned.
-    for( counter = 0; counter < size; ++counter ) {
-        i = ( size - 1 ) - counter;
-        // TODO: The value 1.0E-6 is arbitrary. A more disciplined value should be used.
-        if( fabs( a[i][i] ) <= 1.0E-6 ) {
-            return gaussian_degenerate;
-        }
-
-        sum = b[i];
-        for( j = i + 1; j < size; ++j ) {
-            sum -= a[i][j] * b[j];
-        }
-        b[i] = sum / a[i][i];
-    }
+    // This version does not (yet) use threads so only one is used for the triangular solve.
+    if( upper_triangular_solve( size, 1, &a[0][0], size, b, 1, 1 ) != 0 )
+        return gaussian_degenerate;
     return gaussian_success;
 }
 
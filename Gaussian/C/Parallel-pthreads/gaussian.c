@@ -3,17 +3,25 @@
  * \brief  A Gaussian Elimination solver.
  * \author (C) Copyright 2024 by Peter Chapin <pchapin@vermontstate.edu>
  *
- * This is the pthreads version of the algorithm. It uses pthreads in a "simple" way.
+ * This is the pthreads version of the algorithm. It uses pthreads in a "simple" way. A new team
+ * of threads is created for each pass, but each thread always updates the same rows (see
+ * row_affinity.h) and runs on the same processor, so those rows stay in its cache.
  */
 
+// Needed for pinning threads to processors.
+#define _GNU_SOURCE
+
 #include <math.h>
+#include <stdint.h>
 #include <string.h>
 #include <pthread.h>
-#if defined(__GLIBC__) || defined(__CYGWIN__)
-#include <sys/sysinfo.h>
-#endif
 
 #include "gaussian.h"
+#include "../phase_timer.h"
+#include "../pivot_threshold.h"
+#include "../row_affinity.h"
+#include "../thread_count.h"
+#include "../triangular_solve.h"
 
 // For profiling, it is best for all functions to be public.
 #define PRIVATE // static
@@ -26,19 +34,24 @@
 //
 struct WorkUnit {
     size_t base_row;   //!< The row which contains the diagonal element we are processing.
-    size_t start_row;  //!< The first row this thread must update.
-    size_t stop_row;   //!< Just past the last row this thread must update.
+    size_t block;      //!< The number of rows in each block of rows owned by a thread.
     size_t size;       //!< The size of the overall system: 'size' equations with 'size' unknowns.
     floating_type *a;  //!< Pointer to the matrix of coefficients as a linear array.
     floating_type *b;  //!< Pointer to the driving vector.
+    int thread_number; //!< Identifies the thread, and hence the rows it owns.
+    int thread_count;  //!< The number of threads sharing the rows.
+    floating_type pivot_value; //!< The largest |a[j][base_row + 1]| among the rows this thread updated...
+    size_t pivot_row;          //!< ... and the row where it was found (size if there were none).
+    uint64_t issued;   //!< When the thread was created (only used by the instrumentation).
+    uint64_t finished; //!< When the thread finished (only used by the instrumentation).
 };
 
 //! Zeros out the column beneath the diagonal element at position (base_row, base_row).
 /*!
  * This function is executed by multiple threads with each thread getting a different work unit
- * structure that defines the range of rows to process. Once all the threads have completed
- * their work, the entire column beneath the diagonal element on the base row will have been
- * zeroed.
+ * structure that identifies the thread. Each thread processes the rows below the base row that
+ * it owns. Once all the threads have completed their work, the entire column beneath the
+ * diagonal element on the base row will have been zeroed.
  */
 PRIVATE void *process_rows( void *raw )
 {
@@ -51,21 +64,40 @@ PRIVATE void *process_rows( void *raw )
     // optimize accordingly.
     //
     const size_t base_row  = arg->base_row;
-    const size_t start_row = arg->start_row;
-    const size_t stop_row  = arg->stop_row;
+    const size_t block     = arg->block;
     const size_t size      = arg->size;
+    const int thread_number = arg->thread_number;
+    const int thread_count  = arg->thread_count;
     floating_type (*const restrict a)[size] = (floating_type (*)[size])arg->a;
     floating_type *const restrict b = arg->b;
 
     // Temporary variable.
     floating_type  m;
 
-    for( size_t j = start_row; j < stop_row; ++j ) {
+    // The time between the creation of the thread and its start is part of the dispatch cost.
+    PHASE_DECLARE( stamp );
+    PHASE_ADD( thread_number + 1, PHASE_DISPATCH, stamp - arg->issued );
+
+    // Look for the next pivot among the freshly updated rows (ties go to the first row).
+    floating_type pivot_value = -1.0;
+    size_t pivot_row = size;
+
+    for( size_t j = row_affinity_first( base_row + 1, block, thread_number, thread_count );
+         j < size;
+         j = row_affinity_next( j, block, thread_count ) ) {
         m = a[j][base_row] / a[base_row][base_row];
         for( size_t k = 0; k < size; ++k )
             a[j][k] -= m * a[base_row][k];
         b[j] -= m * b[base_row];
+        if( fabs( a[j][base_row + 1] ) > pivot_value ) {
+            pivot_value = fabs( a[j][base_row + 1] );
+            pivot_row = j;
+        }
     }
+    arg->pivot_value = pivot_value;
+    arg->pivot_row = pivot_row;
+    PHASE_MARK( thread_number + 1, PHASE_ROW_UPDATE, stamp );
+    PHASE_NOW( arg->finished );
     return NULL;
 }
 
@@ -78,33 +110,56 @@ PRIVATE enum GaussianResult elimination( size_t size, floating_type (* restrict
     size_t         i, j, k;
     floating_type  temp, m;
 
-    #if defined(__GLIBC__) || defined(__CYGWIN__)
-    int processor_count = get_nprocs( );
-    #else
-    int processor_count = pthread_num_processors_np( );
-    #endif
+    int processor_count = gaussian_thread_count( );
     //int processor_count = 8;
 
     pthread_t *thread_IDs = (pthread_t *)malloc( processor_count * sizeof( pthread_t ) );
     struct WorkUnit *work_units = ( struct WorkUnit * )malloc( processor_count * sizeof( struct WorkUnit ) );
+    enum GaussianResult result = gaussian_success;
+
+    // Each thread owns a fixed set of rows and always runs on the same processor.
+    const size_t block = row_affinity_block( size, sizeof( floating_type ) );
+    pthread_attr_t *thread_attributes = (pthread_attr_t *)malloc( processor_count * sizeof( pthread_attr_t ) );
+    for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
+        pthread_attr_init( &thread_attributes[thread_counter] );
+        row_affinity_pin_attributes( &thread_attributes[thread_counter], thread_counter );
+    }
 
+    const double threshold = pivot_threshold( size, size, &a[0][0], size );
+    PHASE_TIMER_START( "Parallel-pthreads" );
+    PHASE_DECLARE( stamp );
     for( i = 0; i < size - 1; ++i ) {
 
-        // Find the row with the largest value of |a[j][i]|, j = i, ..., n - 1
-        k = i;
-        m = fabs( a[i][i] );
-        for( j = i + 1; j < size; ++j ) {
-            if( fabs( a[j][i] ) > m ) {
-                k = j;
-                m = fabs( a[j][i] );
+        // Find the row with the largest value of |a[j][i]|, j = i, ..., n - 1. After the first
+        // pass each thread has already found the largest value among its rows while updating
+        // them, so only those candidates need to be compared.
+        if( i == 0 ) {
+            k = i;
+            m = fabs( a[i][i] );
+            for( j = i + 1; j < size; ++j ) {
+                if( fabs( a[j][i] ) > m ) {
+                    k = j;
+                    m = fabs( a[j][i] );
+                }
             }
         }
+        else {
+            k = size;
+            m = -1.0;
+            for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
+                const struct WorkUnit *candidate = &work_units[thread_counter];
+                if( candidate->pivot_value > m || ( candidate->pivot_value == m && candidate->pivot_row < k ) ) {
+                    k = candidate->pivot_row;
+                    m = candidate->pivot_value;
+                }
+            }
+        }
+        PHASE_MARK( 0, PHASE_PIVOT_SEARCH, stamp );
 
         // Check for |a[k][i]| zero.
-        // TODO: The value 1.0E-6 is arbitrary. A more disciplined value should be used.
-        if( fabs( a[k][i] ) <= 1.0E-6 ) {
-            //free( temp_array );
-            return gaussian_degenerate;
+        if( fabs( a[k][i] ) <= threshold ) {
+            result = gaussian_degenerate;
+            break;
         }
 
         // Exchange row i and row k, if necessary.
@@ -118,33 +173,37 @@ PRIVATE enum GaussianResult elimination( size_t size, floating_type (* restrict
             b[i] = b[k];
             b[k] = temp;
         }
+        PHASE_MARK( 0, PHASE_ROW_SWAP, stamp );
 
         // Subtract multiples of row i from subsequent rows.
 
         // Create a team of threads to do this work...
         for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
             // Set up the work unit for the current thread.
-            int rows_per_processor = ( size - i - 1 ) / processor_count;
             work_units[thread_counter].base_row = i;
-            work_units[thread_counter].start_row = i + 1 + ( thread_counter * rows_per_processor );
-            if( thread_counter == processor_count - 1 ) {
-                work_units[thread_counter].stop_row = size;
-            }
-            else {
-                work_units[thread_counter].stop_row = i + 1 + ( ( thread_counter + 1 ) * rows_per_processor );
-            }
+            work_units[thread_counter].block = block;
             work_units[thread_counter].size = size;
             work_units[thread_counter].a = (floating_type *)a;
             work_units[thread_counter].b = b;
+            work_units[thread_counter].thread_number = thread_counter;
+            work_units[thread_counter].thread_count = processor_count;
 
             // Launch the current thread.
-            pthread_create( &thread_IDs[thread_counter], NULL, process_rows, &work_units[thread_counter] );
+            PHASE_NOW( work_units[thread_counter].issued );
+            pthread_create( &thread_IDs[thread_counter], &thread_attributes[thread_counter], process_rows, &work_units[thread_counter] );
         }
+        PHASE_MARK( 0, PHASE_DISPATCH, stamp );
 
         // Wait for the threads to end.
         for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
             pthread_join( thread_IDs[thread_counter], NULL );
         }
+        PHASE_MARK( 0, PHASE_WAIT, stamp );
+
+        // Each thread waited from the time it finished until the last thread was joined.
+        for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
+            PHASE_ADD( thread_counter + 1, PHASE_WAIT, stamp - work_units[thread_counter].finished );
+        }
 
         // This is the code that is now being done in parallel.
         //
@@ -156,34 +215,23 @@ PRIVATE enum GaussianResult elimination( size_t size, floating_type (* restrict
         //}
     }
 
+    for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
+        pthread_attr_destroy( &thread_attributes[thread_counter] );
+    }
+    free( thread_attributes );
     free( work_units );
     free( thread_IDs );
     //free( temp_array );
-    return gaussian_success;
+    return result;
 }
 
 
 //! Does the back substitution step of solving the system. O(n^2)
 PRIVATE enum GaussianResult back_substitution( size_t size, floating_type (* restrict a)[size], floating_type * restrict b )
 {
-    floating_type sum;
-    size_t        i, j;
-    size_t        counter;
-
-    // We can't count i down from size - 1 to zero (inclusive) because it is unsigned.
-    for( counter = 0; counter < size; ++counter ) {
-        i = ( size - 1 ) - counter;
-        // TODO: The value 1.0E-6 is arbitrary. A more disciplined value should be used.
-        if( fabs( a[i][i] ) <= 1.0E-6 ) {
-            return gaussian_degenerate;
-        }
-
-        sum = b[i];
-        for( j = i + 1; j < size; ++j ) {
-            sum -= a[i][j] * b[j];
-        }
-        b[i] = sum / a[i][i];
-    }
+    // The blocked triangular solver divides the row updates among all processors.
+    if( upper_triangular_solve( size, 1, &a[0][0], size, b, 1, 0 ) != 0 )
+        return gaussian_degenerate;
     return gaussian_success;
 }
 
@@ -194,7 +242,10 @@ PUBLIC enum GaussianResult gaussian_solve( size_t size, floating_type (* restric
     if( size == 0 ) return gaussian_error;
 
     enum GaussianResult return_code = elimination( size, a, b );
-    if( return_code == gaussian_success )
+    if( return_code == gaussian_success ) {
+        PHASE_DECLARE( stamp );
         return_code = back_substitution( size, a, b );
+        PHASE_MARK( 0, PHASE_BACK_SUBSTITUTION, stamp );
+    }
     return return_code;
 }
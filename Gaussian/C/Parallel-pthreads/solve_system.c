@@ -4,6 +4,9 @@
  *  \author (C) Copyright 2024 by Peter Chapin <pchapin@vermontstate.edu>
  */
 
+// Needed for pinning threads to processors.
+#define _GNU_SOURCE
+
 #include <stdlib.h>
 #include <stdio.h>
 #if defined(__GLIBC__) || defined(__CYGWIN__)
@@ -11,6 +14,7 @@
 #endif
 
 #include "gaussian.h"
+#include "../row_affinity.h"
 #include "Timer.h"
 
 
@@ -44,8 +48,9 @@ int main( int argc, char *argv[] )
     //floating_type a[size][size];
     //floating_type b[size];
 
-    // Allocate the arrays dynamically.
-    floating_type (*a)[size] = (floating_type (*)[size])malloc( size * size * sizeof( floating_type ) );
+    // Allocate the arrays dynamically. Each row of the matrix is first touched by the thread that
+    // will update it so that it is placed in memory near that thread.
+    floating_type (*a)[size] = (floating_type (*)[size])row_affinity_allocate( size, sizeof( floating_type ) );
     floating_type *b = (floating_type *)malloc( size * sizeof( floating_type ) );
 
     // Get coefficients.
@@ -10,6 +10,9 @@
 #include <string.h>
 
 #include "gaussian.h"
+#include "../phase_timer.h"
+#include "../pivot_threshold.h"
+#include "../triangular_solve.h"
 
 #define PRIVATE static
 #define PUBLIC
@@ -21,6 +24,9 @@ PRIVATE enum GaussianResult elimination( size_t size, floating_type *a, floating
     size_t         i, j, k;
     floating_type  temp, m;
 
+    const double threshold = pivot_threshold( size, size, a, size );
+    PHASE_TIMER_START( "Serial" );
+    PHASE_DECLARE( stamp );
     for( i = 0; i < size - 1; ++i ) {
 
         // Find the row with the largest value of |a[j][i]|, j = i, ..., n - 1
@@ -32,10 +38,10 @@ PRIVATE enum GaussianResult elimination( size_t size, floating_type *a, floating
                 m = fabs( MATRIX_GET( a, size, j, i ) );
             }
         }
+        PHASE_MARK( 0, PHASE_PIVOT_SEARCH, stamp );
 
         // Check for |a[k][i]| zero.
-        // TODO: The value 1.0E-6 is arbitrary. A more disciplined value should be used.
-        if( fabs( MATRIX_GET( a, size, k, i ) ) <= 1.0E-6 ) {
+        if( fabs( MATRIX_GET( a, size, k, i ) ) <= threshold ) {
             free( temp_array );
             return gaussian_degenerate;
         }
@@ -51,6 +57,7 @@ PRIVATE enum GaussianResult elimination( size_t size, floating_type *a, floating
             b[i] = b[k];
             b[k] = temp;
         }
+        PHASE_MARK( 0, PHASE_ROW_SWAP, stamp );
 
         // Subtract multiples of row i from subsequent rows.
         for( j = i + 1; j < size; ++j ) {
@@ -59,6 +66,7 @@ PRIVATE enum GaussianResult elimination( size_t size, floating_type *a, floating
                 MATRIX_PUT( a, size, j, k, MATRIX_GET( a, size, j, k ) - m * MATRIX_GET( a, size, i, k ) );
             b[j] -= m * b[i];
         }
+        PHASE_MARK( 0, PHASE_ROW_UPDATE, stamp );
     }
     free( temp_array );
     return gaussian_success;
@@ -68,24 +76,9 @@ PRIVATE enum GaussianResult elimination( size_t size, floating_type *a, floating
 //! Does the back substitution step of solving the system. O(n^2)
 PRIVATE enum GaussianResult back_substitution( size_t size, floating_type *a, floating_type *b )
 {
-    floating_type sum;
-    size_t        i, j;
-    size_t        counter;
-
-    // We can't count i down from size - 1 to zero (inclusive) because it is unsigned.
-    for( counter = 0; counter < size; ++counter ) {
-        i = ( size - 1 ) - counter;
-        // TODO: The value 1.0E-6 is arbitrary. A more disciplined value should be used.
-        if( fabs( MATRIX_GET( a, size, i, i ) ) <= 1.0E-6 ) {
-            return gaussian_degenerate;
-        }
-
-        sum = b[i];
-        for( j = i + 1; j < size; ++j ) {
-            sum -= MATRIX_GET( a, size, i, j ) * b[j];
-        }
-        b[i] = sum / MATRIX_GET( a, size, i, i );
-    }
+    // This is the serial version so only one thread is used for the triangular solve also.
+    if( upper_triangular_solve( size, 1, a, size, b, 1, 1 ) != 0 )
+        return gaussian_degenerate;
     return gaussian_success;
 }
 
@@ -96,7 +89,10 @@ PUBLIC enum GaussianResult gaussian_solve( size_t size, floating_type *a, floati
     if( size == 0 ) return gaussian_error;
 
     enum GaussianResult return_code = elimination( size, a, b );
-    if( return_code == gaussian_success )
+    if( return_code == gaussian_success ) {
+        PHASE_DECLARE( stamp );
         return_code = back_substitution( size, a, b );
+        PHASE_MARK( 0, PHASE_BACK_SUBSTITUTION, stamp );
+    }
     return return_code;
 }
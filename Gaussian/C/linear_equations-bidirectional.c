@@ -9,29 +9,36 @@
  * recently loaded into the cache.
  */
 
-#define _POSIX_C_SOURCE 200112L
+// Needed for barriers and for pinning threads to processors.
+#define _GNU_SOURCE
 
 #include <math.h>
 #include <string.h>
 #include <pthread.h>
-#ifdef __GLIBC__
-#include <sys/sysinfo.h>
-#endif
 #include "linear_equations.h"
+#include "phase_timer.h"
+#include "pivot_threshold.h"
+#include "row_affinity.h"
+#include "spin_barrier.h"
+#include "thread_count.h"
+#include "triangular_solve.h"
 
 struct WorkUnit {
     int base_row;     // The row being combined with the other rows.
-    int start_row;    // The first row in the range we are to process.
-    int stop_row;     // The last row in the range we are to process.
+    size_t block;     // The number of rows in each block of rows owned by a thread.
     int size;         // The size of the system.
     floating_type *a; // The system (as a one dimensional array).
     floating_type *b; // The driving vector.
     int done;         // =TRUE when there is no more work (this is otherwise an invalid unit).
+    int thread_number; // Identifies the thread, and hence the rows it owns.
+    int thread_count;  // The number of threads sharing the rows.
+    floating_type pivot_value; // The largest |a[j][base_row + 1]| among the rows this thread updated...
+    int pivot_row;             // ... and the row where it was found (size if there were none).
 };
 
 
-pthread_barrier_t work_ready;
-pthread_barrier_t work_finished;
+SpinBarrier work_ready;
+SpinBarrier work_finished;
 
 
 void *bidirectional_row_processor( void *arg )
@@ -43,38 +50,70 @@ void *bidirectional_row_processor( void *arg )
 
     struct WorkUnit *work_unit = (struct WorkUnit *)arg;
 
+    // This thread updates the same rows on every pass so keep it on the same processor.
+    row_affinity_pin_self( work_unit->thread_number );
+
+    // Time spent at the barriers includes the time the main thread spends searching for the
+    // pivot and swapping rows. The workers are idle during that time.
+    PHASE_DECLARE( stamp );
+
     while( 1 ) {
-        pthread_barrier_wait( &work_ready );
+        spin_barrier_wait( &work_ready, work_unit->thread_number );
+        PHASE_MARK( work_unit->thread_number + 1, PHASE_WAIT, stamp );
         if( work_unit->done ) break;
 
         // Extract the parameters from the given structure as a notational convenience.
         const int base_row     = work_unit->base_row;
-        const int start_row    = work_unit->start_row;
-        const int stop_row     = work_unit->stop_row;
+        const size_t block     = work_unit->block;
         const int size         = work_unit->size;
+        const int thread       = work_unit->thread_number;
+        const int thread_count = work_unit->thread_count;
         floating_type *const a = work_unit->a;
         floating_type *const b = work_unit->b;
 
+        // Look for the next pivot among the freshly updated rows (ties go to the first row).
+        floating_type pivot_value = -1.0;
+        int pivot_row = size;
+
         if( direction == DOWN ) {
-            for( int j = start_row; j < stop_row; ++j ) {
+            for( size_t j = row_affinity_first( base_row + 1, block, thread, thread_count );
+                 j < (size_t)size;
+                 j = row_affinity_next( j, block, thread_count ) ) {
                 m = MATRIX_GET( a, size, j, base_row ) / MATRIX_GET( a, size, base_row, base_row );
                 for( int k = 0; k < size; ++k )
                     MATRIX_PUT( a, size, j, k, MATRIX_GET( a, size, j, k ) - m * MATRIX_GET( a, size, base_row, k ) );
                 b[j] -= m * b[base_row];
+                const floating_type candidate = fabs( MATRIX_GET( a, size, j, base_row + 1 ) );
+                if( candidate > pivot_value || ( candidate == pivot_value && (int)j < pivot_row ) ) {
+                    pivot_value = candidate;
+                    pivot_row = (int)j;
+                }
             }
             direction = UP;
         }
         else {
-            for( int j = stop_row - 1; j >= start_row; --j ) {
+            for( size_t j = row_affinity_last( size, block, thread, thread_count );
+                 j != ROW_AFFINITY_NONE && j > (size_t)base_row;
+                 j = row_affinity_previous( j, block, thread_count ) ) {
                 m = MATRIX_GET( a, size, j, base_row ) / MATRIX_GET( a, size, base_row, base_row );
                 for( int k = 0; k < size; ++k )
                     MATRIX_PUT( a, size, j, k, MATRIX_GET( a, size, j, k ) - m * MATRIX_GET( a, size, base_row, k ) );
                 b[j] -= m * b[base_row];
+                const floating_type candidate = fabs( MATRIX_GET( a, size, j, base_row + 1 ) );
+                if( candidate > pivot_value || ( candidate == pivot_value && (int)j < pivot_row ) ) {
+                    pivot_value = candidate;
+                    pivot_row = (int)j;
+                }
             }
             direction = DOWN;
         }
+        work_unit->pivot_value = pivot_value;
+        work_unit->pivot_row = pivot_row;
 
-        pthread_barrier_wait( &work_finished );
+        PHASE_MARK( work_unit->thread_number + 1, PHASE_ROW_UPDATE, stamp );
+
+        spin_barrier_wait( &work_finished, work_unit->thread_number );
+        PHASE_MARK( work_unit->thread_number + 1, PHASE_WAIT, stamp );
     }
     return NULL;
 }
@@ -86,12 +125,9 @@ static int elimination( int size, floating_type *a, floating_type *b )
     floating_type *temp_array = (floating_type *)malloc( size * sizeof( floating_type ) );
     int            i, j, k;
     floating_type  temp, m;
+    int            result = 0;
 
-    #ifdef __GLIBC__
-    int processor_count = get_nprocs( );
-    #else
-    int processor_count = pthread_num_processors_np( );
-    #endif
+    int processor_count = gaussian_thread_count( );
 
     pthread_t *thread_IDs =
         (pthread_t *)malloc( processor_count * sizeof( pthread_t ) );
@@ -99,29 +135,54 @@ static int elimination( int size, floating_type *a, floating_type *b )
         ( struct WorkUnit * )malloc( processor_count * sizeof( struct WorkUnit ) );
 
     // Initialize the synchronization primitives.
-    pthread_barrier_init( &work_ready, NULL, processor_count + 1 );
-    pthread_barrier_init( &work_finished, NULL, processor_count + 1 );
+    spin_barrier_init( &work_ready, processor_count + 1, SPIN_BARRIER_AUTO );
+    spin_barrier_init( &work_finished, processor_count + 1, SPIN_BARRIER_AUTO );
 
     // Create the threads.
-    for( k = 0; k < processor_count; ++k )
+    for( k = 0; k < processor_count; ++k ) {
+        work_units[k].thread_number = k;
+        work_units[k].thread_count = processor_count;
+        work_units[k].block = row_affinity_block( size, sizeof( floating_type ) );
         pthread_create( &thread_IDs[k], NULL, bidirectional_row_processor, &work_units[k] );
+    }
+
+    const double threshold = pivot_threshold( size, size, a, size );
+    PHASE_TIMER_START( "linear_equations-bidirectional" );
+    PHASE_DECLARE( stamp );
 
     for( i = 0; i < size - 1; ++i ) {
 
-        // Find the row with the largest value of |a[j][i]|, j = i, ..., n - 1
-        k = i;
-        m = fabs( MATRIX_GET( a, size, i, i ) );
-        for( j = i + 1; j < size; ++j ) {
-            if( fabs( MATRIX_GET( a, size, j, i ) ) > m ) {
-                k = j;
-                m = fabs( MATRIX_GET( a, size, j, i ) );
+        // Find the row with the largest value of |a[j][i]|, j = i, ..., n - 1. After the first
+        // pass each thread has already found the largest value among its rows while updating
+        // them, so only those candidates need to be compared.
+        if( i == 0 ) {
+            k = i;
+            m = fabs( MATRIX_GET( a, size, i, i ) );
+            for( j = i + 1; j < size; ++j ) {
+                if( fabs( MATRIX_GET( a, size, j, i ) ) > m ) {
+                    k = j;
+                    m = fabs( MATRIX_GET( a, size, j, i ) );
+                }
+            }
+        }
+        else {
+            k = size;
+            m = -1.0;
+            for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
+                const struct WorkUnit *candidate = &work_units[thread_counter];
+                if( candidate->pivot_value > m || ( candidate->pivot_value == m && candidate->pivot_row < k ) ) {
+                    k = candidate->pivot_row;
+                    m = candidate->pivot_value;
+                }
             }
         }
+        PHASE_MARK( 0, PHASE_PIVOT_SEARCH, stamp );
 
         // Check for |a[k][i]| zero.
-        if( fabs( MATRIX_GET( a, size, k, i ) ) <= 1.0E-5 ) {
-            // TODO: Need to kill the worker threads!
-            return -2;
+        // The workers are waiting for work; they are stopped below like after the last pass.
+        if( fabs( MATRIX_GET( a, size, k, i ) ) <= threshold ) {
+            result = -2;
+            break;
         }
 
         // Exchange row i and row k, if necessary.
@@ -135,24 +196,14 @@ static int elimination( int size, floating_type *a, floating_type *b )
             b[i] = b[k];
             b[k] = temp;
         }
+        PHASE_MARK( 0, PHASE_ROW_SWAP, stamp );
 
         // Subtract multiples of row i from subsequent rows.
         // Direct the existing team of threads...
 
         // Set up the work units.
         for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
-            int rows_per_processor  = (size - i - 1) / processor_count;
-            work_units[thread_counter].base_row  = i;
-            work_units[thread_counter].start_row =
-                i + 1 + ( thread_counter * rows_per_processor );
-            if( thread_counter == processor_count - 1 ) {
-                work_units[thread_counter].stop_row =
-                    size;
-            }
-            else {
-                work_units[thread_counter].stop_row =
-                    i + 1 + ( (thread_counter + 1) * rows_per_processor );
-            }
+            work_units[thread_counter].base_row = i;
             work_units[thread_counter].size = size;
             work_units[thread_counter].a    = a;
             work_units[thread_counter].b    = b;
@@ -160,47 +211,41 @@ static int elimination( int size, floating_type *a, floating_type *b )
         }
 
         // Release the beasts.
-        pthread_barrier_wait( &work_ready );
+        spin_barrier_wait( &work_ready, processor_count );
+        PHASE_MARK( 0, PHASE_DISPATCH, stamp );
 
         // Wait for the threads to complete this increment of work.
-        pthread_barrier_wait( &work_finished );
+        spin_barrier_wait( &work_finished, processor_count );
+        PHASE_MARK( 0, PHASE_WAIT, stamp );
     }
 
     // Tell the threads that there is no more work to do.
     for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
         work_units[thread_counter].done = 1;
     }
-    pthread_barrier_wait( &work_ready );
+    spin_barrier_wait( &work_ready, processor_count );
 
     // Wait for the threads to end.
     for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
         pthread_join( thread_IDs[thread_counter], NULL );
     }
 
-    pthread_barrier_destroy( &work_ready );
-    pthread_barrier_destroy( &work_finished );
+    spin_barrier_destroy( &work_ready );
+    spin_barrier_destroy( &work_finished );
 
-    return 0;
+    free( work_units );
+    free( thread_IDs );
+    free( temp_array );
+    return result;
 }
 
 
 //! Does the back substitution step of solving the system.
 static int back_substitution( int size, floating_type *a, floating_type *b )
 {
-    floating_type sum;
-    int           i, j;
-
-    for( i = size - 1; i >= 0; --i ) {
-        if( fabs( MATRIX_GET( a, size, i, i ) ) <= 1.0E-6 ) {
-            return -2;
-        }
-
-        sum = b[i];
-        for( j = i + 1; j < size; ++j ) {
-            sum -= MATRIX_GET( a, size, i, j ) * b[j];
-        }
-        b[i] = sum / MATRIX_GET( a, size, i, i );
-    }
+    // The blocked triangular solver divides the row updates among all processors.
+    if( upper_triangular_solve( size, 1, a, size, b, 1, 0 ) != 0 )
+        return -2;
     return 0;
 }
 
@@ -213,7 +258,10 @@ static int back_substitution( int size, floating_type *a, floating_type *b )
 int gaussian_solve_bidirectional( int size, floating_type *a, floating_type *b )
 {
     int return_code = elimination( size, a, b );
-    if( return_code == 0 )
+    if( return_code == 0 ) {
+        PHASE_DECLARE( stamp );
         return_code = back_substitution( size, a, b );
+        PHASE_MARK( 0, PHASE_BACK_SUBSTITUTION, stamp );
+    }
     return return_code;
 }
@@ -8,60 +8,90 @@
  * to reduce memory latency by reusing items recently loaded into the cache.
  */
 
+// Needed for the futex used by the thread pool batches.
+#define _GNU_SOURCE
+
 #include <math.h>
 #include <string.h>
-#ifdef __GLIBC__
-#include <sys/sysinfo.h>
-#endif
 #include "ThreadPool.h"
 #include "linear_equations.h"
+#include "pivot_threshold.h"
+#include "row_affinity.h"
+#include "thread_count.h"
+#include "thread_pool_batch.h"
+#include "triangular_solve.h"
 
 typedef enum { DOWN, UP } direction_t;
 
 struct WorkUnit {
     int base_row;      //!< The row which contains the diagonal element we are processing.
-    int start_row;     //!< The first row this thread must update.
-    int stop_row;      //!< Just past the last row this thread must update.
+    size_t block;      //!< The number of rows in each block of rows owned by a task.
+    int thread_number; //!< Identifies the task, and hence the rows it owns.
+    int thread_count;  //!< The number of tasks sharing the rows.
     int size;          //!< The size of the overall system: 'size' equations with 'size' unknowns.
     floating_type *a;  //!< Pointer to the matrix of coefficients as a linear array.
     floating_type *b;  //!< Pointer to the driving vector.
     direction_t direction;  //!< Indicates which direction the rows should be processed this time. 
+    floating_type pivot_value; //!< The largest |a[j][base_row + 1]| among the rows this task updated...
+    int pivot_row;             //!< ... and the row where it was found (size if there were none).
 };
 
 //! Zeros out the column beneath the diagonal element at position (base_row, base_row).
 /*!
  * This function is executed by multiple threads with each thread getting a different work
- * unit structure that defines the range of rows to process. Once all the threads have
- * completed their work, the entire column beneath the diagonal element on the base row will
- * have been zeroed.
+ * unit structure. Task n always processes the same rows (see row_affinity.h) so that, as far
+ * as the pool's scheduling allows, rows stay in the cache of the thread that last updated
+ * them. Once all the threads have completed their work, the entire column beneath the
+ * diagonal element on the base row will have been zeroed.
  */
 static void *process_rows( void *raw )
 {
-    const struct WorkUnit *arg = ( const struct WorkUnit * )raw;
+    struct WorkUnit *arg = ( struct WorkUnit * )raw;
     int base_row  = arg->base_row;
-    int start_row = arg->start_row;
-    int stop_row  = arg->stop_row;
+    size_t block  = arg->block;
     int size      = arg->size;
+    int thread    = arg->thread_number;
+    int thread_count = arg->thread_count;
     floating_type *a = arg->a;
     floating_type *b = arg->b;
     floating_type  m;
 
+    // Look for the next pivot among the freshly updated rows (ties go to the first row).
+    floating_type pivot_value = -1.0;
+    int pivot_row = size;
+
     if( arg->direction == DOWN ) {
-        for( int j = start_row; j < stop_row; ++j ) {
+        for( size_t j = row_affinity_first( base_row + 1, block, thread, thread_count );
+             j < (size_t)size;
+             j = row_affinity_next( j, block, thread_count ) ) {
             m = MATRIX_GET( a, size, j, base_row ) / MATRIX_GET( a, size, base_row, base_row );
             for( int k = 0; k < size; ++k )
                 MATRIX_PUT( a, size, j, k, MATRIX_GET( a, size, j, k ) - m * MATRIX_GET( a, size, base_row, k ) );
             b[j] -= m * b[base_row];
+            const floating_type candidate = fabs( MATRIX_GET( a, size, j, base_row + 1 ) );
+            if( candidate > pivot_value || ( candidate == pivot_value && (int)j < pivot_row ) ) {
+                pivot_value = candidate;
+                pivot_row = (int)j;
+            }
         }
     }
     else {
-        for( int j = stop_row - 1; j > start_row - 1; --j ) {
+        for( size_t j = row_affinity_last( size, block, thread, thread_count );
+             j != ROW_AFFINITY_NONE && j > (size_t)base_row;
+             j = row_affinity_previous( j, block, thread_count ) ) {
             m = MATRIX_GET( a, size, j, base_row ) / MATRIX_GET( a, size, base_row, base_row );
             for( int k = 0; k < size; ++k )
                 MATRIX_PUT( a, size, j, k, MATRIX_GET( a, size, j, k ) - m * MATRIX_GET( a, size, base_row, k ) );
             b[j] -= m * b[base_row];
+            const floating_type candidate = fabs( MATRIX_GET( a, size, j, base_row + 1 ) );
+            if( candidate > pivot_value || ( candidate == pivot_value && (int)j < pivot_row ) ) {
+                pivot_value = candidate;
+                pivot_row = (int)j;
+            }
         }
     }
+    arg->pivot_value = pivot_value;
+    arg->pivot_row = pivot_row;
     return NULL;
 }
 
@@ -72,22 +102,59 @@ static int elimination( ThreadPool *pool, int size, floating_type *a, floating_t
     floating_type *temp_array = (floating_type *)malloc( size * sizeof(floating_type) );
     int            i, j, k;
     floating_type  temp, m;
+    int            return_code = 0;
+
+    // The work units are set up once and handed to the pool as a batch on each pass.
+    int processor_count = gaussian_thread_count( );
+    struct WorkUnit *work_units = ( struct WorkUnit * )malloc( processor_count * sizeof( struct WorkUnit ) );
+    for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
+        work_units[thread_counter].block = row_affinity_block( size, sizeof( floating_type ) );
+        work_units[thread_counter].thread_number = thread_counter;
+        work_units[thread_counter].thread_count = processor_count;
+        work_units[thread_counter].size = size;
+        work_units[thread_counter].a = a;
+        work_units[thread_counter].b = b;
+    }
+    ThreadPoolBatch batch;
+    if( ThreadPoolBatch_open( &batch, pool, processor_count ) != 0 ) {
+        free( work_units );
+        free( temp_array );
+        return -1;
+    }
+
+    const double threshold = pivot_threshold( size, size, a, size );
 
     for( i = 0; i < size - 1; ++i ) {
 
-        // Find the row with the largest value of |a[j][i]|, j = i, ..., n - 1
-        k = i;
-        m = fabs( MATRIX_GET( a, size, i, i ) );
-        for( j = i + 1; j < size; ++j ) {
-            if( fabs( MATRIX_GET( a, size, j, i ) ) > m ) {
-                k = j;
-                m = fabs( MATRIX_GET( a, size, j, i ) );
+        // Find the row with the largest value of |a[j][i]|, j = i, ..., n - 1. After the first
+        // pass each task has already found the largest value among its rows while updating
+        // them, so only those candidates need to be compared.
+        if( i == 0 ) {
+            k = i;
+            m = fabs( MATRIX_GET( a, size, i, i ) );
+            for( j = i + 1; j < size; ++j ) {
+                if( fabs( MATRIX_GET( a, size, j, i ) ) > m ) {
+                    k = j;
+                    m = fabs( MATRIX_GET( a, size, j, i ) );
+                }
+            }
+        }
+        else {
+            k = size;
+            m = -1.0;
+            for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
+                const struct WorkUnit *candidate = &work_units[thread_counter];
+                if( candidate->pivot_value > m || ( candidate->pivot_value == m && candidate->pivot_row < k ) ) {
+                    k = candidate->pivot_row;
+                    m = candidate->pivot_value;
+                }
             }
         }
 
         // Check for |a[k][i]| zero.
-        if( fabs( MATRIX_GET( a, size, k, i ) ) <= 1.0E-6 ) {
-            return -2;
+        if( fabs( MATRIX_GET( a, size, k, i ) ) <= threshold ) {
+            return_code = -2;
+            break;
         }
 
         // Exchange row i and row k, if necessary.
@@ -103,59 +170,26 @@ static int elimination( ThreadPool *pool, int size, floating_type *a, floating_t
         }
 
         // Subtract multiples of row i from subsequent rows.
-        #ifdef __GLIBC__
-        int processor_count = get_nprocs( );
-        #else
-        int processor_count = pthread_num_processors_np( );
-        #endif
-        threadid_t *thread_IDs = (threadid_t *)malloc( processor_count * sizeof( threadid_t ) );
-        struct WorkUnit *work_units = ( struct WorkUnit * )malloc( processor_count * sizeof( struct WorkUnit ) );
         for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
-            // Set up the work unit for the current thread.
-            int rows_per_processor = ( size - i - 1 ) / processor_count;
             work_units[thread_counter].base_row = i;
-            work_units[thread_counter].start_row = i + 1 + ( thread_counter * rows_per_processor );
-            if( thread_counter == processor_count - 1 ) {
-                work_units[thread_counter].stop_row = size;
-            }
-            else {
-                work_units[thread_counter].stop_row = i + 1 + ( ( thread_counter + 1 ) * rows_per_processor );
-            }
             work_units[thread_counter].direction = ( i & 0x1 ) ? UP : DOWN;
-            work_units[thread_counter].size = size;
-            work_units[thread_counter].a = a;
-            work_units[thread_counter].b = b;
-
-            // Launch the current thread.
-            thread_IDs[thread_counter] = ThreadPool_start( pool, process_rows, &work_units[thread_counter] );
-        }
-        for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
-            ThreadPool_result( pool, thread_IDs[thread_counter] );
         }
-        free( thread_IDs );
-        free( work_units );
+        ThreadPoolBatch_submit( &batch, process_rows, work_units, sizeof( struct WorkUnit ), processor_count );
+        ThreadPoolBatch_wait( &batch );
     }
-    return 0;
+    ThreadPoolBatch_close( &batch );
+    free( work_units );
+    free( temp_array );
+    return return_code;
 }
 
 
 //! Does the back substitution step of solving the system.
 static int back_substitution( int size, floating_type *a, floating_type *b )
 {
-    floating_type sum;
-    int           i, j;
-
-    for( i = size - 1; i >=0; --i ) {
-        if( fabs( MATRIX_GET( a, size, i, i ) ) <= 1.0E-6 ) {
-            return -2;
-        }
-
-        sum = b[i];
-        for( j = i + 1; j < size; ++j ) {
-            sum -= MATRIX_GET( a, size, i, j ) * b[j];
-        }
-        b[i] = sum / MATRIX_GET( a, size, i, i );
-    }
+    // The blocked triangular solver divides the row updates among all processors.
+    if( upper_triangular_solve( size, 1, a, size, b, 1, 0 ) != 0 )
+        return -2;
     return 0;
 }
 
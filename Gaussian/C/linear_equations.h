@@ -0,0 +1,36 @@
+/*!
+ * \file   linear_equations.h
+ * \brief  Interface to the loose linear_equations-*.c solvers.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * These solvers predate the Serial, Parallel-pthreads, and Parallel-VLA folders and use the
+ * older conventions of the MPI version: an int size, a flat matrix handled with the macros
+ * below, and an int result. Each solver returns -1 if there is a problem with the parameters
+ * and -2 if the system is degenerate. Otherwise it returns zero and the solution in the array
+ * 'b'. The thread pool versions (linear_equations-pool-*.c) also take a pointer to the Spica
+ * ThreadPool they should use; they are declared in those files.
+ */
+
+#ifndef LINEAR_EQUATIONS_H
+#define LINEAR_EQUATIONS_H
+
+#include <stdlib.h>
+
+typedef double floating_type;
+
+// Macros for handling matricies.
+// These macros manipulate a linear array as if it was a two dimensional array.
+#define MATRIX_MAKE( size )  ((floating_type *)malloc( (size) * (size) * sizeof( floating_type ) ))
+#define MATRIX_DESTROY( matrix )                       ( free( matrix ) )
+#define MATRIX_GET( matrix, size, row, column )        ( (matrix)[(row)*(size) + (column)] )
+#define MATRIX_GET_REF( matrix, size, row, column )    (&(matrix)[(row)*(size) + (column)] )
+#define MATRIX_GET_ROW( matrix, size, row )            (&(matrix)[(row)*(size)] )
+#define MATRIX_PUT( matrix, size, row, column, value ) ( (matrix)[(row)*(size) + (column)] = (value) )
+
+//! Uses a team of threads that synchronize with barriers between passes.
+int gaussian_solve_barriers( int size, floating_type *a, floating_type *b );
+
+//! As gaussian_solve_barriers, but alternates the direction rows are processed on each pass.
+int gaussian_solve_bidirectional( int size, floating_type *a, floating_type *b );
+
+#endif
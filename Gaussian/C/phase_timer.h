@@ -0,0 +1,162 @@
+/*!
+ * \file   phase_timer.h
+ * \brief  Optional per-thread timing of the phases of the elimination loop.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * When GAUSSIAN_INSTRUMENT is defined the macros below accumulate, for each thread, the time
+ * spent in each phase of the solver (pivot search, row swap, dispatching work to threads, row
+ * updates, waiting at barriers or joins, and back substitution). A table showing the breakdown
+ * is printed to stderr when the program exits. Comparing the update times of the threads shows
+ * load imbalance; the dispatch and wait times show the cost of synchronization. When
+ * GAUSSIAN_INSTRUMENT is not defined the macros expand to nothing.
+ *
+ * Time is measured with CLOCK_MONOTONIC in nanoseconds. Each thread has its own slot (slot 0 is
+ * the thread that calls the solver; worker n uses slot n + 1), padded to avoid false sharing.
+ * Threads beyond PHASE_TIMER_SLOTS share the last slot. The counters are static, so each source
+ * file that includes this header keeps (and reports) its own counters.
+ *
+ * The table covers the whole process: it is the sum over every solve made by the source file,
+ * including solves running at the same time (for example, several threads calling
+ * gaussian_solve in libgaussian), whose threads add to the same slots. The counters are
+ * therefore updated with relaxed atomic adds. A slot is normally used by one thread at a time,
+ * so the adds are uncontended and cheap next to reading the clock.
+ *
+ * Typical use, where each PHASE_MARK charges the time since the previous mark to a phase:
+ *
+ *     PHASE_TIMER_START( "Parallel-pthreads" );
+ *     PHASE_DECLARE( stamp );
+ *     ... search for the pivot ...
+ *     PHASE_MARK( 0, PHASE_PIVOT_SEARCH, stamp );
+ *     ... swap rows ...
+ *     PHASE_MARK( 0, PHASE_ROW_SWAP, stamp );
+ */
+
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+enum Phase {
+    PHASE_PIVOT_SEARCH,
+    PHASE_ROW_SWAP,
+    PHASE_DISPATCH,
+    PHASE_ROW_UPDATE,
+    PHASE_WAIT,
+    PHASE_BACK_SUBSTITUTION,
+    PHASE_COUNT
+};
+
+#ifdef GAUSSIAN_INSTRUMENT
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Threads beyond this number share the last slot (see above).
+#define PHASE_TIMER_SLOTS 256
+
+union PhaseSlot {
+    struct {
+        uint64_t nanoseconds[PHASE_COUNT];
+        uint64_t events[PHASE_COUNT];
+    } counters;
+    char padding[128];   // At least one cache line, even on machines with 128 byte lines.
+};
+
+static union PhaseSlot phase_slots[PHASE_TIMER_SLOTS];
+static const char *phase_timer_label;
+
+static inline uint64_t phase_timer_now( void )
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static inline void phase_timer_add( int slot, enum Phase phase, uint64_t nanoseconds )
+{
+    if( slot >= PHASE_TIMER_SLOTS ) slot = PHASE_TIMER_SLOTS - 1;
+    __atomic_fetch_add( &phase_slots[slot].counters.nanoseconds[phase], nanoseconds, __ATOMIC_RELAXED );
+    __atomic_fetch_add( &phase_slots[slot].counters.events[phase], 1, __ATOMIC_RELAXED );
+}
+
+static void phase_timer_report( void )
+{
+    static const char *const names[PHASE_COUNT] = {
+        "pivot", "swap", "dispatch", "update", "wait", "back sub"
+    };
+    uint64_t phase_totals[PHASE_COUNT] = { 0 };
+    uint64_t grand_total = 0;
+    double   update_sum = 0.0;
+    double   update_max = 0.0;
+    int      worker_count = 0;
+
+    fprintf( stderr, "\nPhase times (ms) for %s\n%6s", phase_timer_label, "thread" );
+    for( int phase = 0; phase < PHASE_COUNT; ++phase ) fprintf( stderr, " %11s", names[phase] );
+    fprintf( stderr, " %11s\n", "total" );
+
+    for( int slot = 0; slot < PHASE_TIMER_SLOTS; ++slot ) {
+        const union PhaseSlot *counters = &phase_slots[slot];
+        uint64_t slot_total = 0;
+        for( int phase = 0; phase < PHASE_COUNT; ++phase ) slot_total += counters->counters.nanoseconds[phase];
+        if( slot_total == 0 ) continue;
+
+        if( slot == 0 ) fprintf( stderr, "%6s", "main" );
+        else fprintf( stderr, "%6d", slot - 1 );
+        for( int phase = 0; phase < PHASE_COUNT; ++phase ) {
+            fprintf( stderr, " %11.3f", counters->counters.nanoseconds[phase] / 1.0E6 );
+            phase_totals[phase] += counters->counters.nanoseconds[phase];
+        }
+        fprintf( stderr, " %11.3f\n", slot_total / 1.0E6 );
+        grand_total += slot_total;
+
+        if( slot != 0 ) {
+            const double update = (double)counters->counters.nanoseconds[PHASE_ROW_UPDATE];
+            update_sum += update;
+            if( update > update_max ) update_max = update;
+            ++worker_count;
+        }
+    }
+    if( grand_total == 0 ) return;
+
+    fprintf( stderr, "%6s", "%" );
+    for( int phase = 0; phase < PHASE_COUNT; ++phase ) {
+        fprintf( stderr, " %11.1f", 100.0 * phase_totals[phase] / grand_total );
+    }
+    fprintf( stderr, "\n" );
+
+    // The ratio of the slowest worker's update time to the average is 1.0 for perfect balance.
+    if( worker_count > 0 && update_sum > 0.0 ) {
+        fprintf( stderr, "Update imbalance (max / mean over %d threads): %.3f\n",
+                 worker_count, update_max / ( update_sum / worker_count ) );
+    }
+}
+
+static inline void phase_timer_start( const char *label )
+{
+    // Only the first solve (of possibly several starting at once) registers the report.
+    const char *expected = NULL;
+    if( __atomic_load_n( &phase_timer_label, __ATOMIC_RELAXED ) == NULL &&
+        __atomic_compare_exchange_n( &phase_timer_label, &expected, label, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) ) {
+        atexit( phase_timer_report );
+    }
+}
+
+#define PHASE_TIMER_START( label )         phase_timer_start( label )
+#define PHASE_DECLARE( stamp )             uint64_t stamp = phase_timer_now( )
+#define PHASE_NOW( stamp )                 ( (stamp) = phase_timer_now( ) )
+#define PHASE_MARK( slot, phase, stamp )   \
+    do { uint64_t phase_now_ = phase_timer_now( ); \
+         phase_timer_add( (slot), (phase), phase_now_ - (stamp) ); (stamp) = phase_now_; } while( 0 )
+#define PHASE_ADD( slot, phase, nanoseconds ) phase_timer_add( (slot), (phase), (nanoseconds) )
+
+#else
+
+#define PHASE_TIMER_START( label )            ( (void)0 )
+#define PHASE_DECLARE( stamp )
+#define PHASE_NOW( stamp )                    ( (void)0 )
+#define PHASE_MARK( slot, phase, stamp )      ( (void)0 )
+#define PHASE_ADD( slot, phase, nanoseconds ) ( (void)0 )
+
+#endif
+
+#endif
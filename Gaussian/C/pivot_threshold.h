@@ -0,0 +1,62 @@
+/*!
+ * \file   pivot_threshold.h
+ * \brief  The test every solver uses to decide that a system is singular.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * A pivot is treated as zero if its magnitude is no more than PIVOT_TOLERANCE times the largest
+ * magnitude among the coefficients of the matrix being factored. Because the threshold is
+ * relative to the matrix, scaling a system by any factor doesn't change whether it is solved.
+ * The tolerance is a few times the precision of float so that the single precision
+ * factorizations (used by the mixed precision solver) reject the same systems as the double
+ * precision ones. For coefficients of order one, such as those in the systems made by
+ * CreateSystem, the threshold is about 1.0E-6.
+ *
+ * The functions here compute the threshold for a matrix. Call them before the matrix is
+ * changed by the factorization. In C++ a template version handles both float and double.
+ */
+
+#ifndef PIVOT_THRESHOLD_H
+#define PIVOT_THRESHOLD_H
+
+#define PIVOT_TOLERANCE 1.0E-6
+
+#ifdef __cplusplus
+
+#include <cmath>
+#include <cstddef>
+
+//! Returns the pivot threshold for the rows x columns matrix at a (with rows lda elements apart).
+template< typename FloatingType >
+inline double pivot_threshold( std::size_t rows, std::size_t columns, const FloatingType *a, std::size_t lda )
+{
+    FloatingType largest = 0;
+    for( std::size_t i = 0; i < rows; ++i ) {
+        const FloatingType *row = a + i*lda;
+        for( std::size_t j = 0; j < columns; ++j ) {
+            if( std::abs( row[j] ) > largest ) largest = std::abs( row[j] );
+        }
+    }
+    return PIVOT_TOLERANCE * largest;
+}
+
+#else
+
+#include <math.h>
+#include <stddef.h>
+
+//! Returns the pivot threshold for the rows x columns matrix at a (with rows lda elements apart).
+static inline double pivot_threshold( size_t rows, size_t columns, const double *a, size_t lda )
+{
+    double largest = 0.0;
+    for( size_t i = 0; i < rows; ++i ) {
+        const double *row = a + i*lda;
+        for( size_t j = 0; j < columns; ++j ) {
+            if( fabs( row[j] ) > largest ) largest = fabs( row[j] );
+        }
+    }
+    return PIVOT_TOLERANCE * largest;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,192 @@
+/*!
+ * \file   row_affinity.h
+ * \brief  A static, block cyclic assignment of rows to threads.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * Dividing the remaining rows into contiguous bands on each pass of the elimination loop moves
+ * most rows to a different thread on every pass (and gives the last thread the remainder). A
+ * row then has to be fetched from the cache, or worse, the memory of another processor. Here
+ * instead each row is owned by one thread for the whole factorization: the rows are grouped
+ * into blocks and the blocks are dealt to the threads in turn. As the elimination proceeds the
+ * remaining rows stay evenly divided to within a block per thread.
+ *
+ * A block is (at least) one page of memory so that when the owners touch their rows first
+ * (see row_affinity_allocate) each page is placed in the memory of the node where its owner
+ * runs. Threads are pinned to processors (see row_affinity_pin_self) so a thread also stays
+ * near its rows. Pinning can be disabled by setting the environment variable GAUSSIAN_PIN to
+ * zero. Threads are pinned to the processors the process is allowed to use, in order, so
+ * processes that are already bound (for example by mpirun) are respected. Pinning requires
+ * glibc and _GNU_SOURCE defined before any system header is included; otherwise it does
+ * nothing.
+ */
+
+#ifndef ROW_AFFINITY_H
+#define ROW_AFFINITY_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "thread_count.h"
+
+// Assumed size of a page of memory. A smaller actual page size is harmless.
+#define ROW_AFFINITY_PAGE_SIZE 4096
+
+// Returned by row_affinity_last and row_affinity_previous when there is no such row.
+#define ROW_AFFINITY_NONE SIZE_MAX
+
+//! Returns the number of rows in each block for a system of the given size.
+static inline size_t row_affinity_block( size_t size, size_t element_size )
+{
+    const size_t row_bytes = size * element_size;
+    return ( row_bytes >= ROW_AFFINITY_PAGE_SIZE ) ? 1 : ( ROW_AFFINITY_PAGE_SIZE + row_bytes - 1 ) / row_bytes;
+}
+
+//! Returns the thread that owns a row.
+static inline int row_affinity_owner( size_t row, size_t block, int thread_count )
+{
+    return (int)( ( row / block ) % (size_t)thread_count );
+}
+
+//! Returns the first row >= row owned by the thread. The result may be past the last row.
+static inline size_t row_affinity_first( size_t row, size_t block, int thread, int thread_count )
+{
+    const size_t block_number = row / block;
+    const size_t offset = ( (size_t)thread + thread_count - block_number % thread_count ) % thread_count;
+    return ( offset == 0 ) ? row : ( block_number + offset ) * block;
+}
+
+//! Returns the next row after row (which must be owned by the thread) owned by the thread.
+static inline size_t row_affinity_next( size_t row, size_t block, int thread_count )
+{
+    return ( ( row + 1 ) % block != 0 ) ? row + 1 : row + 1 + ( thread_count - 1 ) * block;
+}
+
+//! Returns the last row < size owned by the thread, or ROW_AFFINITY_NONE.
+static inline size_t row_affinity_last( size_t size, size_t block, int thread, int thread_count )
+{
+    const size_t last_block = ( size - 1 ) / block;
+    if( last_block < (size_t)thread ) return ROW_AFFINITY_NONE;
+    const size_t block_number = last_block - ( last_block - thread ) % thread_count;
+    const size_t end = ( block_number + 1 ) * block;
+    return ( end < size ? end : size ) - 1;
+}
+
+//! Returns the row before row (which must be owned by the thread) owned by the thread, or ROW_AFFINITY_NONE.
+static inline size_t row_affinity_previous( size_t row, size_t block, int thread_count )
+{
+    if( row % block != 0 ) return row - 1;
+    if( row < thread_count * block ) return ROW_AFFINITY_NONE;
+    return row - ( thread_count - 1 ) * block - 1;
+}
+
+#if defined(__GLIBC__) && defined(CPU_SETSIZE)
+//! Selects the processor for the given thread number. Returns zero if the thread shouldn't be pinned.
+static inline int row_affinity_choose( int thread, cpu_set_t *mine )
+{
+    const char *setting = getenv( "GAUSSIAN_PIN" );
+    if( setting != NULL && atoi( setting ) == 0 ) return 0;
+
+    cpu_set_t allowed;
+    if( sched_getaffinity( 0, sizeof( allowed ), &allowed ) != 0 ) return 0;
+    const int allowed_count = CPU_COUNT( &allowed );
+    if( allowed_count <= 1 ) return 0;
+
+    int wanted = thread % allowed_count;
+    for( int cpu = 0; cpu < CPU_SETSIZE; ++cpu ) {
+        if( !CPU_ISSET( cpu, &allowed ) ) continue;
+        if( wanted-- == 0 ) {
+            CPU_ZERO( mine );
+            CPU_SET( cpu, mine );
+            return 1;
+        }
+    }
+    return 0;
+}
+#endif
+
+//! Pins the calling thread to the processor used by the given thread number.
+static inline void row_affinity_pin_self( int thread )
+{
+    #if defined(__GLIBC__) && defined(CPU_SETSIZE)
+    cpu_set_t mine;
+    if( row_affinity_choose( thread, &mine ) )
+        pthread_setaffinity_np( pthread_self( ), sizeof( mine ), &mine );
+    #else
+    (void)thread;
+    #endif
+}
+
+//! Arranges for threads created with the given attributes to be pinned as for the thread number.
+static inline void row_affinity_pin_attributes( pthread_attr_t *attributes, int thread )
+{
+    #if defined(__GLIBC__) && defined(CPU_SETSIZE)
+    cpu_set_t mine;
+    if( row_affinity_choose( thread, &mine ) )
+        pthread_attr_setaffinity_np( attributes, sizeof( mine ), &mine );
+    #else
+    (void)attributes;
+    (void)thread;
+    #endif
+}
+
+struct RowAffinityTouch {
+    char  *base;
+    size_t size;
+    size_t row_bytes;
+    size_t block;
+    int    thread;
+    int    thread_count;
+};
+
+static inline void *row_affinity_touch( void *raw )
+{
+    const struct RowAffinityTouch *touch = (const struct RowAffinityTouch *)raw;
+    row_affinity_pin_self( touch->thread );
+    for( size_t row = row_affinity_first( 0, touch->block, touch->thread, touch->thread_count );
+         row < touch->size;
+         row = row_affinity_next( row, touch->block, touch->thread_count ) ) {
+        memset( touch->base + row * touch->row_bytes, 0, touch->row_bytes );
+    }
+    return NULL;
+}
+
+//! Allocates a size x size matrix with each row first touched by the thread that will own it.
+/*!
+ * The rows are zeroed by a team of gaussian_thread_count( ) pinned threads, each zeroing the
+ * rows it will own during the elimination, so the operating system places each page in memory
+ * local to its owner. The matrix should be released with free( ). Returns NULL if the memory
+ * can't be allocated.
+ */
+static inline void *row_affinity_allocate( size_t size, size_t element_size )
+{
+    const size_t row_bytes = size * element_size;
+    char *base = (char *)malloc( size * row_bytes );
+    if( base == NULL ) return NULL;
+
+    const int thread_count = gaussian_thread_count( );
+    const size_t block = row_affinity_block( size, element_size );
+    pthread_t *threads = (pthread_t *)malloc( thread_count * sizeof( pthread_t ) );
+    struct RowAffinityTouch *touches = (struct RowAffinityTouch *)malloc( thread_count * sizeof( struct RowAffinityTouch ) );
+    if( threads == NULL || touches == NULL ) {
+        free( threads );
+        free( touches );
+        memset( base, 0, size * row_bytes );
+        return base;
+    }
+
+    for( int thread = 0; thread < thread_count; ++thread ) {
+        struct RowAffinityTouch touch = { base, size, row_bytes, block, thread, thread_count };
+        touches[thread] = touch;
+        pthread_create( &threads[thread], NULL, row_affinity_touch, &touches[thread] );
+    }
+    for( int thread = 0; thread < thread_count; ++thread ) {
+        pthread_join( threads[thread], NULL );
+    }
+    free( threads );
+    free( touches );
+    return base;
+}
+
+#endif
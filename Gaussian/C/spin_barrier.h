@@ -0,0 +1,242 @@
+/*!
+ * \file   spin_barrier.h
+ * \brief  A sense reversing barrier that spins briefly before sleeping.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * The solvers that keep a team of threads alive between passes wait at a barrier two or more
+ * times per pass. On Linux pthread_barrier_wait puts every thread but the last to sleep in the
+ * kernel and the last thread must then wake them all, which costs tens of microseconds per
+ * barrier. When the threads arrive at nearly the same time (as they do when the work is evenly
+ * divided) it is far cheaper for them to spin for a short while on a shared flag.
+ *
+ * A SpinBarrier counts arrivals. The last thread to arrive resets the count and reverses the
+ * "sense" flag, which releases the others. A waiting thread spins on the flag for a bounded
+ * number of iterations and then sleeps on it with a futex, so a thread that waits a long time
+ * (for example a worker while the main thread searches for a pivot) doesn't burn a processor.
+ * The futex wake system call is only made if some thread is actually asleep. When there are
+ * more threads than processors spinning is useless, so waiting threads sleep at once.
+ *
+ * With many threads the single arrival counter becomes a point of contention. A tree barrier
+ * (SPIN_BARRIER_TREE) instead counts arrivals in a tree of counters with SPIN_BARRIER_FAN_IN
+ * arrivals at each node; the last arrival at a node goes on to the node's parent and the last
+ * arrival at the root releases everyone. Each thread passes its thread number to
+ * spin_barrier_wait so that it knows which leaf to start from.
+ *
+ * The implementation uses the GCC atomic builtins. The futex is used on Linux when _GNU_SOURCE
+ * is defined before any system header is included; elsewhere a waiting thread yields instead
+ * of sleeping. Other compilers get a thin wrapper around pthread_barrier_t.
+ *
+ * The Voltage program in C/Voltage includes this header as well.
+ */
+
+#ifndef SPIN_BARRIER_H
+#define SPIN_BARRIER_H
+
+#include <pthread.h>
+#include <stdlib.h>
+
+// Returned by spin_barrier_wait to exactly one thread (the one that released the others).
+#define SPIN_BARRIER_SERIAL_THREAD (-1)
+
+// The number of arrivals counted at each node of a tree barrier.
+#define SPIN_BARRIER_FAN_IN 4
+
+// SPIN_BARRIER_AUTO uses a tree barrier for at least this many threads.
+#define SPIN_BARRIER_TREE_THRESHOLD 16
+
+// The number of times a waiting thread checks the flag before sleeping.
+#define SPIN_BARRIER_SPIN_LIMIT 4000
+
+enum SpinBarrierKind {
+    SPIN_BARRIER_AUTO,   // Flat for a few threads, a tree otherwise.
+    SPIN_BARRIER_FLAT,   // A single arrival counter.
+    SPIN_BARRIER_TREE    // A tree of arrival counters.
+};
+
+#if defined(__GNUC__)
+
+#include <sched.h>
+#include <unistd.h>
+#if defined(__linux__) && defined(_GNU_SOURCE)
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#define SPIN_BARRIER_FUTEX
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SPIN_BARRIER_PAUSE( ) __builtin_ia32_pause( )
+#elif defined(__aarch64__)
+#define SPIN_BARRIER_PAUSE( ) __asm__ __volatile__( "yield" )
+#else
+#define SPIN_BARRIER_PAUSE( ) ( (void)0 )
+#endif
+
+// Counters are kept on separate cache lines (even on machines with 128 byte lines).
+#define SPIN_BARRIER_LINE 128
+
+union SpinBarrierNode {
+    struct {
+        int count;   // The number of arrivals still expected in this episode.
+        int width;   // The number of arrivals expected in each episode.
+        int parent;  // The index of the parent node, or -1 for the root.
+    } node;
+    char padding[SPIN_BARRIER_LINE];
+};
+
+typedef struct {
+    union SpinBarrierNode *nodes;  // The leaves come first, the root is last.
+    int fan_in;
+    int spin_limit;
+    union {
+        struct {
+            unsigned sense;     // Reversed by the last arrival of each episode.
+            unsigned sleepers;  // The number of threads that might be asleep on sense.
+        } flag;
+        char padding[SPIN_BARRIER_LINE];
+    } release;
+} SpinBarrier;
+
+
+static inline void spin_barrier_sleep( unsigned *sense, unsigned value )
+{
+    #ifdef SPIN_BARRIER_FUTEX
+    syscall( SYS_futex, sense, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0 );
+    #else
+    (void)sense;
+    (void)value;
+    sched_yield( );
+    #endif
+}
+
+static inline void spin_barrier_wake( unsigned *sense )
+{
+    #ifdef SPIN_BARRIER_FUTEX
+    syscall( SYS_futex, sense, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0 );
+    #else
+    (void)sense;
+    #endif
+}
+
+
+//! Initializes a barrier for thread_count threads. Returns zero on success.
+static inline int spin_barrier_init( SpinBarrier *barrier, int thread_count, enum SpinBarrierKind kind )
+{
+    if( thread_count <= 0 ) return -1;
+    if( kind == SPIN_BARRIER_AUTO )
+        kind = ( thread_count >= SPIN_BARRIER_TREE_THRESHOLD ) ? SPIN_BARRIER_TREE : SPIN_BARRIER_FLAT;
+    barrier->fan_in = ( kind == SPIN_BARRIER_TREE ) ? SPIN_BARRIER_FAN_IN : thread_count;
+    if( barrier->fan_in < 2 ) barrier->fan_in = 2;
+
+    const long processor_count = sysconf( _SC_NPROCESSORS_ONLN );
+    barrier->spin_limit = ( processor_count > 0 && thread_count > processor_count ) ? 0 : SPIN_BARRIER_SPIN_LIMIT;
+    barrier->release.flag.sense = 0;
+    barrier->release.flag.sleepers = 0;
+
+    // Count the nodes in all levels of the tree.
+    int node_count = 0;
+    for( int arrivals = thread_count; ; ) {
+        const int level_count = ( arrivals + barrier->fan_in - 1 ) / barrier->fan_in;
+        node_count += level_count;
+        if( level_count == 1 ) break;
+        arrivals = level_count;
+    }
+
+    void *raw;
+    if( posix_memalign( &raw, SPIN_BARRIER_LINE, node_count * sizeof( union SpinBarrierNode ) ) != 0 )
+        return -1;
+    barrier->nodes = (union SpinBarrierNode *)raw;
+
+    // Fill in the tree one level at a time.
+    int first = 0;
+    for( int arrivals = thread_count; ; ) {
+        const int level_count = ( arrivals + barrier->fan_in - 1 ) / barrier->fan_in;
+        for( int i = 0; i < level_count; ++i ) {
+            const int remaining = arrivals - i * barrier->fan_in;
+            union SpinBarrierNode *node = &barrier->nodes[first + i];
+            node->node.width  = ( remaining < barrier->fan_in ) ? remaining : barrier->fan_in;
+            node->node.count  = node->node.width;
+            node->node.parent = ( level_count == 1 ) ? -1 : first + level_count + i / barrier->fan_in;
+        }
+        if( level_count == 1 ) break;
+        first += level_count;
+        arrivals = level_count;
+    }
+    return 0;
+}
+
+
+//! Waits until all threads have arrived. Each thread passes its own number in [0, thread_count).
+/*!
+ * Returns SPIN_BARRIER_SERIAL_THREAD to one of the threads and zero to the others. Memory
+ * operations done by any thread before it arrives are visible to all threads after they leave.
+ */
+static inline int spin_barrier_wait( SpinBarrier *barrier, int thread )
+{
+    unsigned *sense = &barrier->release.flag.sense;
+
+    // The sense can't change until this thread arrives so it can be read first.
+    const unsigned my_sense = __atomic_load_n( sense, __ATOMIC_ACQUIRE );
+
+    union SpinBarrierNode *node = &barrier->nodes[thread / barrier->fan_in];
+    while( __atomic_sub_fetch( &node->node.count, 1, __ATOMIC_ACQ_REL ) == 0 ) {
+        // The last arrival at a node resets it. Nobody touches it again until after the release.
+        __atomic_store_n( &node->node.count, node->node.width, __ATOMIC_RELAXED );
+        if( node->node.parent < 0 ) {
+            __atomic_store_n( sense, !my_sense, __ATOMIC_SEQ_CST );
+            if( __atomic_load_n( &barrier->release.flag.sleepers, __ATOMIC_SEQ_CST ) != 0 )
+                spin_barrier_wake( sense );
+            return SPIN_BARRIER_SERIAL_THREAD;
+        }
+        node = &barrier->nodes[node->node.parent];
+    }
+
+    for( int spin = 0; spin < barrier->spin_limit; ++spin ) {
+        if( __atomic_load_n( sense, __ATOMIC_ACQUIRE ) != my_sense ) return 0;
+        SPIN_BARRIER_PAUSE( );
+    }
+
+    // Announce the intention to sleep before checking the sense for the last time. The futex
+    // call only sleeps if the sense is still unchanged, so a release can't be missed.
+    __atomic_add_fetch( &barrier->release.flag.sleepers, 1, __ATOMIC_SEQ_CST );
+    while( __atomic_load_n( sense, __ATOMIC_ACQUIRE ) == my_sense )
+        spin_barrier_sleep( sense, my_sense );
+    __atomic_sub_fetch( &barrier->release.flag.sleepers, 1, __ATOMIC_SEQ_CST );
+    return 0;
+}
+
+
+//! Releases the resources used by a barrier. No thread may be waiting on it.
+static inline void spin_barrier_destroy( SpinBarrier *barrier )
+{
+    free( barrier->nodes );
+    barrier->nodes = NULL;
+}
+
+#else
+
+// Without the GCC builtins fall back to the system's barrier.
+typedef struct {
+    pthread_barrier_t barrier;
+} SpinBarrier;
+
+static inline int spin_barrier_init( SpinBarrier *barrier, int thread_count, enum SpinBarrierKind kind )
+{
+    (void)kind;
+    return pthread_barrier_init( &barrier->barrier, NULL, thread_count );
+}
+
+static inline int spin_barrier_wait( SpinBarrier *barrier, int thread )
+{
+    (void)thread;
+    return ( pthread_barrier_wait( &barrier->barrier ) == PTHREAD_BARRIER_SERIAL_THREAD ) ? SPIN_BARRIER_SERIAL_THREAD : 0;
+}
+
+static inline void spin_barrier_destroy( SpinBarrier *barrier )
+{
+    pthread_barrier_destroy( &barrier->barrier );
+}
+
+#endif
+
+#endif
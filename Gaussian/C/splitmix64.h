@@ -0,0 +1,34 @@
+/*!
+ * \file   splitmix64.h
+ * \brief  The random numbers used to create test systems.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * CreateSystem, the benchmark driver, and the calibration in libgaussian all create random
+ * systems. Each value is computed from a seed and the position of the value in the system
+ * rather than drawn from a sequence, so rows can be created in any order (or in parallel, or on
+ * different processes) and the same seed always gives the same system. Using these functions
+ * in every program keeps their systems the same.
+ */
+
+#ifndef SPLITMIX64_H
+#define SPLITMIX64_H
+
+#include <stdint.h>
+
+//! The SplitMix64 finalizer. Consecutive inputs give unrelated outputs.
+static inline uint64_t splitmix64( uint64_t x )
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = ( x ^ ( x >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    x = ( x ^ ( x >> 27 ) ) * 0x94D049BB133111EBULL;
+    return x ^ ( x >> 31 );
+}
+
+//! Returns a value in the range (-1.0, +1.0) determined by the seed and the key.
+static inline double splitmix64_uniform( uint64_t seed, uint64_t key )
+{
+    const uint64_t bits = splitmix64( key + splitmix64( seed ) );
+    return ( (double)( bits >> 11 ) + 0.5 ) * ( 2.0 / 9007199254740992.0 ) - 1.0;
+}
+
+#endif
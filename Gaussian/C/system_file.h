@@ -0,0 +1,85 @@
+/*!
+ * \file   system_file.h
+ * \brief  Layout of the binary system definition format.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * The text format produced by CreateSystem is convenient, but converting it takes longer than
+ * solving a moderately sized system, and a dense text file can't describe a large sparse system
+ * at all. The binary format holds the same information with no conversion needed (beyond a
+ * possible change of precision) and can store either a dense or a sparse system.
+ *
+ * A binary file starts with the header below. A dense system follows with size rows, each
+ * containing size coefficients and then the driving vector value, exactly as in the text
+ * format. A sparse system follows with its matrix in compressed sparse row form: size + 1
+ * row start positions (uint64_t), element_count column numbers (uint64_t), element_count
+ * coefficients, and finally the size driving vector values. Column numbers must be increasing
+ * within each row. All values are stored in the byte order of the machine that wrote the file.
+ * The version field is also used to detect a file written with the other byte order.
+ *
+ * The header is 32 bytes long so every array in the file is suitably aligned for its elements.
+ * This allows a file to be memory mapped and its arrays used in place.
+ */
+
+#ifndef SYSTEM_FILE_H
+#define SYSTEM_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define SYSTEM_FILE_MAGIC   "GSYS"
+#define SYSTEM_FILE_VERSION 1
+
+/* Flags. */
+#define SYSTEM_FILE_SPARSE  0x0001u   /* The matrix is stored in compressed sparse row form. */
+
+struct system_file_header {
+    char     magic[4];       /* SYSTEM_FILE_MAGIC (not null terminated). */
+    uint32_t version;        /* SYSTEM_FILE_VERSION. */
+    uint32_t element_size;   /* sizeof(float) or sizeof(double). */
+    uint32_t flags;
+    uint64_t size;           /* Number of equations (and unknowns). */
+    uint64_t element_count;  /* Number of stored coefficients. */
+};
+
+//! Fills in a header for a system with the given properties.
+static inline void system_file_init_header(
+    struct system_file_header *header, uint64_t size, uint32_t element_size, int sparse, uint64_t element_count )
+{
+    memcpy( header->magic, SYSTEM_FILE_MAGIC, 4 );
+    header->version = SYSTEM_FILE_VERSION;
+    header->element_size = element_size;
+    header->flags = sparse ? SYSTEM_FILE_SPARSE : 0u;
+    header->size = size;
+    header->element_count = sparse ? element_count : size * size;
+}
+
+//! Returns non-zero if the first bytes of a file (at least four) are the binary format's magic.
+static inline int system_file_is_binary( const void *data, size_t length )
+{
+    return length >= 4 && memcmp( data, SYSTEM_FILE_MAGIC, 4 ) == 0;
+}
+
+//! Returns non-zero if the header is one this version of the software understands.
+static inline int system_file_header_valid( const struct system_file_header *header )
+{
+    return memcmp( header->magic, SYSTEM_FILE_MAGIC, 4 ) == 0 &&
+           header->version == SYSTEM_FILE_VERSION &&
+           ( header->element_size == sizeof( float ) || header->element_size == sizeof( double ) ) &&
+           ( header->flags & ~SYSTEM_FILE_SPARSE ) == 0 &&
+           header->size != 0;
+}
+
+//! Returns the total size, in bytes, of a file with the given header.
+static inline uint64_t system_file_length( const struct system_file_header *header )
+{
+    const uint64_t n = header->size;
+    if( header->flags & SYSTEM_FILE_SPARSE ) {
+        return sizeof( struct system_file_header ) +
+               ( n + 1 + header->element_count ) * sizeof( uint64_t ) +
+               ( header->element_count + n ) * header->element_size;
+    }
+    return sizeof( struct system_file_header ) + n * ( n + 1 ) * header->element_size;
+}
+
+#endif
@@ -0,0 +1,39 @@
+/*!
+ * \file   thread_count.h
+ * \brief  Decides how many threads the parallel solvers use.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * By default the parallel solvers use one thread per processor. Setting the environment
+ * variable GAUSSIAN_THREADS to a positive integer overrides that choice. This allows the
+ * scaling of a solver to be measured without rebuilding it (the benchmark driver sets this
+ * variable before each run).
+ */
+
+#ifndef THREAD_COUNT_H
+#define THREAD_COUNT_H
+
+#include <stdlib.h>
+#if defined(__GLIBC__) || defined(__CYGWIN__)
+#include <sys/sysinfo.h>
+#endif
+
+#define GAUSSIAN_THREADS_VARIABLE "GAUSSIAN_THREADS"
+
+//! Returns the number of threads a parallel solver should use. The result is at least one.
+static inline int gaussian_thread_count( void )
+{
+    const char *setting = getenv( GAUSSIAN_THREADS_VARIABLE );
+    if( setting != NULL ) {
+        int count = atoi( setting );
+        if( count > 0 ) return count;
+    }
+
+    #if defined(__GLIBC__) || defined(__CYGWIN__)
+    int processor_count = get_nprocs( );
+    #else
+    int processor_count = pthread_num_processors_np( );
+    #endif
+    return ( processor_count > 0 ) ? processor_count : 1;
+}
+
+#endif
@@ -0,0 +1,317 @@
+/*!
+ * \file   thread_pool_batch.h
+ * \brief  Submits an array of work units to a Spica ThreadPool in one call.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * The thread pool versions of the solver used to start one pool task per thread for every
+ * pivot and then collect the result of each task, so the cost of each pass grew with the number
+ * of threads. A ThreadPoolBatch instead borrows a team of the pool's threads for as long as it
+ * is open. Each borrowed thread runs a loop that waits for a batch of work units, processes
+ * units until none are left, and waits again. Submitting a batch is a single store (plus a
+ * wake up if a thread is asleep) and the submitter waits on a latch that counts the units still
+ * unfinished.
+ *
+ * The calling thread is member zero of the team and processes units too; the pool supplies the
+ * other members. Unit u is processed by member u % team size when that member is ready for it,
+ * so a unit that always refers to the same rows (see row_affinity.h) tends to run on the same
+ * thread. Any member that runs out of its own units takes the units of members that are late.
+ * Thus if the pool has fewer free threads than requested the batch still completes (the
+ * borrowed threads that haven't started yet just find nothing to do).
+ *
+ * Waiting members spin briefly and then sleep, in the same way as in spin_barrier.h. Other
+ * compilers get a fallback that starts one pool task per unit, as before.
+ *
+ * Typical use:
+ *
+ *     ThreadPoolBatch batch;
+ *     ThreadPoolBatch_open( &batch, pool, thread_count );
+ *     for( ... ) {
+ *         ... fill in work_units ...
+ *         ThreadPoolBatch_submit( &batch, process_rows, work_units, sizeof( struct WorkUnit ), thread_count );
+ *         ThreadPoolBatch_wait( &batch );
+ *     }
+ *     ThreadPoolBatch_close( &batch );
+ */
+
+#ifndef THREAD_POOL_BATCH_H
+#define THREAD_POOL_BATCH_H
+
+#include <stdlib.h>
+#include "ThreadPool.h"
+#include "spin_barrier.h"
+
+#if defined(__GNUC__)
+
+#include <stdint.h>
+
+struct ThreadPoolBatchMember;
+
+// The position of a member in its own units. The generation is in the upper half.
+union ThreadPoolBatchCursor {
+    uint64_t cursor;
+    char     padding[SPIN_BARRIER_LINE];
+};
+
+typedef struct {
+    ThreadPool *pool;
+    int         team_size;    // Including the thread that opened the batch.
+    int         spin_limit;
+    struct ThreadPoolBatchMember *members;
+    threadid_t *member_IDs;
+    union ThreadPoolBatchCursor *cursors;
+
+    // The current batch. These are only changed while no unit is being processed.
+    void     *( *function )( void * );
+    char       *units;
+    size_t      unit_size;
+    int         count;
+    int         stop;
+
+    union {
+        struct {
+            unsigned generation;   // Advanced for each batch (and when the batch is closed).
+            unsigned sleepers;     // The number of members that might be asleep on generation.
+        } flag;
+        char padding[SPIN_BARRIER_LINE];
+    } start;
+    union {
+        struct {
+            unsigned remaining;    // The number of units of the current batch not yet finished.
+            unsigned sleepers;     // Non-zero if the submitter might be asleep on remaining.
+        } flag;
+        char padding[SPIN_BARRIER_LINE];
+    } latch;
+} ThreadPoolBatch;
+
+struct ThreadPoolBatchMember {
+    ThreadPoolBatch *batch;
+    int              number;
+};
+
+
+//! Claims the next unit of the given owner in the given generation. Returns -1 if there are none left.
+/*!
+ * The units of member m are m, m + team_size, m + 2 * team_size, ... A member that has fallen
+ * behind (its generation is not the current one) never succeeds in claiming a unit.
+ */
+static inline int thread_pool_batch_claim( ThreadPoolBatch *batch, int owner, unsigned generation )
+{
+    uint64_t *cursor = &batch->cursors[owner].cursor;
+
+    // The count is stored after the cursors are reset so a member that sees a new count also sees the new cursors.
+    const int count = __atomic_load_n( &batch->count, __ATOMIC_ACQUIRE );
+    uint64_t position = __atomic_load_n( cursor, __ATOMIC_ACQUIRE );
+    for( ;; ) {
+        if( (unsigned)( position >> 32 ) != generation ) return -1;
+        const int u = owner + (int)(uint32_t)position * batch->team_size;
+        if( u >= count ) return -1;
+        if( __atomic_compare_exchange_n( cursor, &position, position + 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ) )
+            return u;
+    }
+}
+
+
+//! Processes the units of the given generation: first the member's own, then any left over.
+static inline void thread_pool_batch_work( ThreadPoolBatch *batch, int number, unsigned generation )
+{
+    for( int i = 0; i < batch->team_size; ++i ) {
+        const int owner = ( number + i ) % batch->team_size;
+        int u;
+        while( ( u = thread_pool_batch_claim( batch, owner, generation ) ) >= 0 ) {
+            // Claiming a unit of the current generation means the batch can't have finished, so
+            // the batch description is still the one for that generation.
+            batch->function( batch->units + u * batch->unit_size );
+            if( __atomic_sub_fetch( &batch->latch.flag.remaining, 1, __ATOMIC_ACQ_REL ) == 0 &&
+                __atomic_load_n( &batch->latch.flag.sleepers, __ATOMIC_SEQ_CST ) != 0 )
+                spin_barrier_wake( &batch->latch.flag.remaining );
+        }
+    }
+}
+
+
+//! The loop run by each borrowed pool thread.
+static void *thread_pool_batch_member( void *raw )
+{
+    const struct ThreadPoolBatchMember *member = (const struct ThreadPoolBatchMember *)raw;
+    ThreadPoolBatch *batch = member->batch;
+    unsigned *generation = &batch->start.flag.generation;
+    unsigned  seen = 0;
+
+    for( ;; ) {
+        // Wait for the generation to advance.
+        unsigned current;
+        int spin = 0;
+        while( ( current = __atomic_load_n( generation, __ATOMIC_ACQUIRE ) ) == seen ) {
+            if( spin < batch->spin_limit ) {
+                ++spin;
+                SPIN_BARRIER_PAUSE( );
+                continue;
+            }
+            __atomic_add_fetch( &batch->start.flag.sleepers, 1, __ATOMIC_SEQ_CST );
+            if( __atomic_load_n( generation, __ATOMIC_SEQ_CST ) == seen )
+                spin_barrier_sleep( generation, seen );
+            __atomic_sub_fetch( &batch->start.flag.sleepers, 1, __ATOMIC_SEQ_CST );
+        }
+        seen = current;
+        if( __atomic_load_n( &batch->stop, __ATOMIC_ACQUIRE ) ) return NULL;
+        thread_pool_batch_work( batch, member->number, current );
+    }
+}
+
+
+//! Borrows team_size - 1 threads from the pool. Returns zero on success.
+/*!
+ * The borrowed threads are returned to the pool by ThreadPoolBatch_close.
+ */
+static inline int ThreadPoolBatch_open( ThreadPoolBatch *batch, ThreadPool *pool, int team_size )
+{
+    if( team_size <= 0 ) return -1;
+    batch->pool = pool;
+    batch->team_size = team_size;
+    const long processor_count = sysconf( _SC_NPROCESSORS_ONLN );
+    batch->spin_limit = ( processor_count > 0 && team_size > processor_count ) ? 0 : SPIN_BARRIER_SPIN_LIMIT;
+    batch->function = NULL;
+    batch->units = NULL;
+    batch->unit_size = 0;
+    batch->count = 0;
+    batch->stop = 0;
+    batch->start.flag.generation = 0;
+    batch->start.flag.sleepers = 0;
+    batch->latch.flag.remaining = 0;
+    batch->latch.flag.sleepers = 0;
+
+    void *raw;
+    if( posix_memalign( &raw, SPIN_BARRIER_LINE, team_size * sizeof( union ThreadPoolBatchCursor ) ) != 0 )
+        return -1;
+    batch->cursors = (union ThreadPoolBatchCursor *)raw;
+    for( int number = 0; number < team_size; ++number ) batch->cursors[number].cursor = 0;
+
+    batch->members = (struct ThreadPoolBatchMember *)malloc( team_size * sizeof( struct ThreadPoolBatchMember ) );
+    batch->member_IDs = (threadid_t *)malloc( team_size * sizeof( threadid_t ) );
+    if( batch->members == NULL || batch->member_IDs == NULL ) {
+        free( batch->members );
+        free( batch->member_IDs );
+        free( batch->cursors );
+        return -1;
+    }
+    for( int number = 1; number < team_size; ++number ) {
+        batch->members[number].batch = batch;
+        batch->members[number].number = number;
+        batch->member_IDs[number] = ThreadPool_start( pool, thread_pool_batch_member, &batch->members[number] );
+    }
+    return 0;
+}
+
+
+//! Starts processing count units of unit_size bytes each, at units, by applying function to each one.
+/*!
+ * Returns zero on success. The previous batch (if any) must have been waited for. The units
+ * must not be changed until ThreadPoolBatch_wait returns, but may be reused after that.
+ */
+static inline int ThreadPoolBatch_submit(
+    ThreadPoolBatch *batch, void *( *function )( void * ), void *units, size_t unit_size, int count )
+{
+    const unsigned generation = batch->start.flag.generation + 1;
+
+    for( int number = 0; number < batch->team_size; ++number )
+        __atomic_store_n( &batch->cursors[number].cursor, (uint64_t)generation << 32, __ATOMIC_RELAXED );
+    batch->function = function;
+    batch->units = (char *)units;
+    batch->unit_size = unit_size;
+    __atomic_store_n( &batch->count, count, __ATOMIC_RELEASE );
+    __atomic_store_n( &batch->latch.flag.remaining, (unsigned)count, __ATOMIC_RELAXED );
+
+    // Publish the batch.
+    __atomic_store_n( &batch->start.flag.generation, generation, __ATOMIC_SEQ_CST );
+    if( __atomic_load_n( &batch->start.flag.sleepers, __ATOMIC_SEQ_CST ) != 0 )
+        spin_barrier_wake( &batch->start.flag.generation );
+    return 0;
+}
+
+
+//! Processes units of the current batch and then waits until all of them are finished.
+static inline void ThreadPoolBatch_wait( ThreadPoolBatch *batch )
+{
+    unsigned *remaining = &batch->latch.flag.remaining;
+
+    thread_pool_batch_work( batch, 0, batch->start.flag.generation );
+    for( int spin = 0; spin < batch->spin_limit; ++spin ) {
+        if( __atomic_load_n( remaining, __ATOMIC_ACQUIRE ) == 0 ) return;
+        SPIN_BARRIER_PAUSE( );
+    }
+
+    unsigned value;
+    __atomic_store_n( &batch->latch.flag.sleepers, 1, __ATOMIC_SEQ_CST );
+    while( ( value = __atomic_load_n( remaining, __ATOMIC_ACQUIRE ) ) != 0 )
+        spin_barrier_sleep( remaining, value );
+    __atomic_store_n( &batch->latch.flag.sleepers, 0, __ATOMIC_SEQ_CST );
+}
+
+
+//! Returns the borrowed threads to the pool and releases the resources used by the batch.
+static inline void ThreadPoolBatch_close( ThreadPoolBatch *batch )
+{
+    __atomic_store_n( &batch->stop, 1, __ATOMIC_RELAXED );
+    __atomic_add_fetch( &batch->start.flag.generation, 1, __ATOMIC_SEQ_CST );
+    if( __atomic_load_n( &batch->start.flag.sleepers, __ATOMIC_SEQ_CST ) != 0 )
+        spin_barrier_wake( &batch->start.flag.generation );
+    for( int number = 1; number < batch->team_size; ++number ) {
+        ThreadPool_result( batch->pool, batch->member_IDs[number] );
+    }
+    free( batch->member_IDs );
+    free( batch->members );
+    free( batch->cursors );
+}
+
+#else
+
+// Without the GCC builtins each unit is started as a separate pool task.
+typedef struct {
+    ThreadPool *pool;
+    int         count;
+    int         capacity;
+    threadid_t *IDs;
+} ThreadPoolBatch;
+
+static inline int ThreadPoolBatch_open( ThreadPoolBatch *batch, ThreadPool *pool, int team_size )
+{
+    (void)team_size;
+    batch->pool = pool;
+    batch->count = 0;
+    batch->capacity = 0;
+    batch->IDs = NULL;
+    return 0;
+}
+
+static inline int ThreadPoolBatch_submit(
+    ThreadPoolBatch *batch, void *( *function )( void * ), void *units, size_t unit_size, int count )
+{
+    if( count > batch->capacity ) {
+        threadid_t *IDs = (threadid_t *)realloc( batch->IDs, count * sizeof( threadid_t ) );
+        if( IDs == NULL ) return -1;
+        batch->IDs = IDs;
+        batch->capacity = count;
+    }
+    batch->count = count;
+    for( int u = 0; u < count; ++u ) {
+        batch->IDs[u] = ThreadPool_start( batch->pool, function, (char *)units + u * unit_size );
+    }
+    return 0;
+}
+
+static inline void ThreadPoolBatch_wait( ThreadPoolBatch *batch )
+{
+    for( int u = 0; u < batch->count; ++u ) {
+        ThreadPool_result( batch->pool, batch->IDs[u] );
+    }
+    batch->count = 0;
+}
+
+static inline void ThreadPoolBatch_close( ThreadPoolBatch *batch )
+{
+    free( batch->IDs );
+}
+
+#endif
+
+#endif
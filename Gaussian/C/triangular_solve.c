@@ -0,0 +1,45 @@
+/*!
+ * \file   triangular_solve.c
+ * \brief  A blocked, parallel triangular solver.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * The matrix is processed in blocks of TRIANGULAR_BLOCK_SIZE rows. Once the unknowns for a
+ * block are known, all remaining rows are updated using those unknowns. These updates are
+ * independent of each other and are divided among a team of threads. The work per block is a
+ * matrix-vector product (for a single right hand side) or a matrix-matrix product (for many
+ * right hand sides), so only two barriers per block are needed.
+ */
+
+// Needed for the futex used by the barriers.
+#define _GNU_SOURCE
+
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "pivot_threshold.h"
+#include "spin_barrier.h"
+#include "thread_count.h"
+#include "triangular_solve.h"
+
+// The number of rows in each block.
+#define TRIANGULAR_BLOCK_SIZE 128
+
+static int triangular_processor_count( void )
+{
+    return gaussian_thread_count( );
+}
+
+// Create the double precision versions.
+#define ELEMENT double
+#define NAME( name ) name
+#include "triangular_solve_generic.h"
+#undef NAME
+#undef ELEMENT
+
+// Create the single precision versions.
+#define ELEMENT float
+#define NAME( name ) name ## _f
+#include "triangular_solve_generic.h"
+#undef NAME
+#undef ELEMENT
@@ -0,0 +1,73 @@
+/*!
+ * \file   triangular_solve.h
+ * \brief  Interface to a blocked, parallel triangular solver.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * The functions here solve triangular systems with any number of right hand sides. They are
+ * used for the back substitution step of the Gaussian Elimination solvers (both C and C++) and
+ * for the forward substitution step of the LU solvers. Versions for both double and float
+ * elements are provided. In C++ the float versions are also available as overloads of the
+ * double versions so that templates can use the same name for both.
+ *
+ * All matrices are stored in row-major order. The right hand sides are the columns of a
+ * size x rhs_count matrix; with a single right hand side this is just an ordinary vector (use
+ * rhs_count == 1 and ldb == 1). The solution overwrites the right hand sides.
+ */
+
+#ifndef TRIANGULAR_SOLVE_H
+#define TRIANGULAR_SOLVE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Solves U X = B where U is upper triangular.
+/*!
+ * \param size The number of rows (and columns) in U.
+ * \param rhs_count The number of right hand sides (columns in B).
+ * \param u Points at U. Only the upper triangle (including the diagonal) is used.
+ * \param ldu The distance between rows of U (in elements). Normally ldu == size.
+ * \param b Points at B. On return B holds the solution X.
+ * \param ldb The distance between rows of B (in elements). Normally ldb == rhs_count.
+ * \param thread_count The maximum number of threads to use. Zero means use all processors.
+ * \returns Zero if successful or -1 if a diagonal element of U is too small compared to the
+ * largest one (see pivot_threshold.h), in which case B is unchanged.
+ */
+int upper_triangular_solve(
+    size_t size, size_t rhs_count, const double *u, size_t ldu, double *b, size_t ldb, int thread_count );
+
+//! Solves L X = B where L is lower triangular with an implicit unit diagonal.
+/*!
+ * The parameters are as for upper_triangular_solve except that only the strictly lower
+ * triangle of L is used. This function can't fail.
+ */
+void unit_lower_triangular_solve(
+    size_t size, size_t rhs_count, const double *l, size_t ldl, double *b, size_t ldb, int thread_count );
+
+//! Single precision version of upper_triangular_solve.
+int upper_triangular_solve_f(
+    size_t size, size_t rhs_count, const float *u, size_t ldu, float *b, size_t ldb, int thread_count );
+
+//! Single precision version of unit_lower_triangular_solve.
+void unit_lower_triangular_solve_f(
+    size_t size, size_t rhs_count, const float *l, size_t ldl, float *b, size_t ldb, int thread_count );
+
+#ifdef __cplusplus
+}
+
+inline int upper_triangular_solve(
+    size_t size, size_t rhs_count, const float *u, size_t ldu, float *b, size_t ldb, int thread_count )
+{
+    return upper_triangular_solve_f( size, rhs_count, u, ldu, b, ldb, thread_count );
+}
+
+inline void unit_lower_triangular_solve(
+    size_t size, size_t rhs_count, const float *l, size_t ldl, float *b, size_t ldb, int thread_count )
+{
+    unit_lower_triangular_solve_f( size, rhs_count, l, ldl, b, ldb, thread_count );
+}
+#endif
+
+#endif
@@ -0,0 +1,249 @@
+/*!
+ * \file   triangular_solve_generic.h
+ * \brief  Type generic implementation of the blocked triangular solvers.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * This file is included by triangular_solve.c once for each element type. Before including it,
+ * define ELEMENT as the element type and NAME( name ) to decorate the public function names
+ * (for example by adding a suffix). C doesn't have templates, so this is the next best thing.
+ * This file should not be included anywhere else.
+ */
+
+#if !defined(ELEMENT) || !defined(NAME)
+#error ELEMENT and NAME must be defined before including triangular_solve_generic.h
+#endif
+
+// Internal names are decorated also so that both instantiations can coexist.
+#define LOCAL( name ) NAME( name ## _ )
+
+struct LOCAL( SolveWork ) {
+    int           upper;        //!< Non-zero for U X = B, zero for L X = B (unit diagonal).
+    size_t        size;
+    size_t        rhs_count;
+    const ELEMENT *t;           //!< The triangular matrix.
+    size_t        ldt;
+    ELEMENT      *b;
+    size_t        ldb;
+    int           thread_count;
+    SpinBarrier   barrier;      //!< Separates the diagonal block solves from the updates.
+};
+
+struct LOCAL( SolveThread ) {
+    struct LOCAL( SolveWork ) *work;
+    int thread_number;
+};
+
+
+//! Solves the diagonal block [first, last) for the right hand sides [rhs_first, rhs_last).
+static void LOCAL( solve_diagonal_block )(
+    const struct LOCAL( SolveWork ) *work, size_t first, size_t last, size_t rhs_first, size_t rhs_last )
+{
+    const ELEMENT *t   = work->t;
+    ELEMENT       *b   = work->b;
+    const size_t   ldt = work->ldt;
+    const size_t   ldb = work->ldb;
+    size_t         counter, i, j, c;
+
+    for( counter = first; counter < last; ++counter ) {
+        i = work->upper ? ( last - 1 ) - ( counter - first ) : counter;
+        const ELEMENT *t_row = &t[i*ldt];
+        ELEMENT       *b_row = &b[i*ldb];
+
+        if( work->rhs_count == 1 ) {
+            ELEMENT sum = b_row[0];
+            if( work->upper ) {
+                for( j = i + 1; j < last; ++j ) sum -= t_row[j] * b[j*ldb];
+                b_row[0] = sum / t_row[i];
+            }
+            else {
+                for( j = first; j < i; ++j ) sum -= t_row[j] * b[j*ldb];
+                b_row[0] = sum;
+            }
+        }
+        else {
+            size_t j_first = work->upper ? i + 1 : first;
+            size_t j_last  = work->upper ? last : i;
+            for( j = j_first; j < j_last; ++j ) {
+                const ELEMENT  factor = t_row[j];
+                const ELEMENT *x_row  = &b[j*ldb];
+                for( c = rhs_first; c < rhs_last; ++c ) b_row[c] -= factor * x_row[c];
+            }
+            if( work->upper ) {
+                const ELEMENT inverse = (ELEMENT)1 / t_row[i];
+                for( c = rhs_first; c < rhs_last; ++c ) b_row[c] *= inverse;
+            }
+        }
+    }
+}
+
+
+//! Subtracts T[row_first..row_last, first..last] * X[first..last] from B[row_first..row_last].
+/*!
+ * With a single right hand side this is a matrix-vector product (GEMV). With several right
+ * hand sides it is a matrix-matrix product (GEMM).
+ */
+static void LOCAL( update_rows )(
+    const struct LOCAL( SolveWork ) *work, size_t row_first, size_t row_last, size_t first, size_t last )
+{
+    const ELEMENT *t   = work->t;
+    ELEMENT       *b   = work->b;
+    const size_t   ldt = work->ldt;
+    const size_t   ldb = work->ldb;
+    size_t         i, j, c;
+
+    for( i = row_first; i < row_last; ++i ) {
+        const ELEMENT *t_row = &t[i*ldt];
+        ELEMENT       *b_row = &b[i*ldb];
+
+        if( work->rhs_count == 1 ) {
+            ELEMENT sum = 0;
+            for( j = first; j < last; ++j ) sum += t_row[j] * b[j*ldb];
+            b_row[0] -= sum;
+        }
+        else {
+            for( j = first; j < last; ++j ) {
+                const ELEMENT  factor = t_row[j];
+                const ELEMENT *x_row  = &b[j*ldb];
+                for( c = 0; c < work->rhs_count; ++c ) b_row[c] -= factor * x_row[c];
+            }
+        }
+    }
+}
+
+
+//! Computes the part of [first, last) handled by the given thread.
+static void LOCAL( share )(
+    size_t first, size_t last, int thread_number, int thread_count, size_t *my_first, size_t *my_last )
+{
+    size_t length = last - first;
+    *my_first = first + ( length * thread_number ) / thread_count;
+    *my_last  = first + ( length * ( thread_number + 1 ) ) / thread_count;
+}
+
+
+//! Processes the blocks in order. Executed by every thread in the team.
+/*!
+ * For each diagonal block the unknowns of that block are first solved (in parallel over the
+ * right hand sides), and then the rows not yet solved are updated using those unknowns (in
+ * parallel over the rows). The updates of different rows are independent so the threads only
+ * need to synchronize twice per block.
+ */
+static void *LOCAL( solve_blocks )( void *raw )
+{
+    struct LOCAL( SolveThread ) *arg = (struct LOCAL( SolveThread ) *)raw;
+    struct LOCAL( SolveWork )   *work = arg->work;
+    const size_t size = work->size;
+    const size_t block_count = ( size + TRIANGULAR_BLOCK_SIZE - 1 ) / TRIANGULAR_BLOCK_SIZE;
+    size_t       block, first, last, my_first, my_last;
+
+    for( block = 0; block < block_count; ++block ) {
+        if( work->upper ) {
+            last  = size - block * TRIANGULAR_BLOCK_SIZE;
+            first = ( last > TRIANGULAR_BLOCK_SIZE ) ? last - TRIANGULAR_BLOCK_SIZE : 0;
+        }
+        else {
+            first = block * TRIANGULAR_BLOCK_SIZE;
+            last  = ( first + TRIANGULAR_BLOCK_SIZE < size ) ? first + TRIANGULAR_BLOCK_SIZE : size;
+        }
+
+        LOCAL( share )( 0, work->rhs_count, arg->thread_number, work->thread_count, &my_first, &my_last );
+        if( my_first < my_last ) {
+            LOCAL( solve_diagonal_block )( work, first, last, my_first, my_last );
+        }
+        if( work->thread_count > 1 ) spin_barrier_wait( &work->barrier, arg->thread_number );
+
+        // Update the rows that remain (above the block for U, below the block for L).
+        if( work->upper )
+            LOCAL( share )( 0, first, arg->thread_number, work->thread_count, &my_first, &my_last );
+        else
+            LOCAL( share )( last, size, arg->thread_number, work->thread_count, &my_first, &my_last );
+        LOCAL( update_rows )( work, my_first, my_last, first, last );
+        if( work->thread_count > 1 ) spin_barrier_wait( &work->barrier, arg->thread_number );
+    }
+    return NULL;
+}
+
+
+//! Runs solve_blocks on a team of threads. The calling thread is thread zero.
+static void LOCAL( solve )( struct LOCAL( SolveWork ) *work )
+{
+    int processor_count = work->thread_count;
+    if( processor_count <= 0 ) processor_count = triangular_processor_count( );
+
+    // Small systems don't have enough work to be worth the synchronization overhead.
+    size_t block_count = ( work->size + TRIANGULAR_BLOCK_SIZE - 1 ) / TRIANGULAR_BLOCK_SIZE;
+    if( block_count < 4 ) processor_count = 1;
+    work->thread_count = processor_count;
+
+    struct LOCAL( SolveThread ) *threads =
+        (struct LOCAL( SolveThread ) *)malloc( processor_count * sizeof( struct LOCAL( SolveThread ) ) );
+    pthread_t *thread_IDs = (pthread_t *)malloc( processor_count * sizeof( pthread_t ) );
+
+    if( processor_count > 1 ) spin_barrier_init( &work->barrier, processor_count, SPIN_BARRIER_AUTO );
+    for( int thread_counter = 0; thread_counter < processor_count; ++thread_counter ) {
+        threads[thread_counter].work = work;
+        threads[thread_counter].thread_number = thread_counter;
+        if( thread_counter != 0 )
+            pthread_create( &thread_IDs[thread_counter], NULL, LOCAL( solve_blocks ), &threads[thread_counter] );
+    }
+    LOCAL( solve_blocks )( &threads[0] );
+    for( int thread_counter = 1; thread_counter < processor_count; ++thread_counter ) {
+        pthread_join( thread_IDs[thread_counter], NULL );
+    }
+    if( processor_count > 1 ) spin_barrier_destroy( &work->barrier );
+
+    free( thread_IDs );
+    free( threads );
+}
+
+
+int NAME( upper_triangular_solve )(
+    size_t size, size_t rhs_count, const ELEMENT *u, size_t ldu, ELEMENT *b, size_t ldb, int thread_count )
+{
+    struct LOCAL( SolveWork ) work;
+    size_t i;
+
+    // Check the diagonal first so that B is unchanged if the system is degenerate. U alone
+    // doesn't say how large the original coefficients were, so the diagonal elements are
+    // compared with the largest of them.
+    ELEMENT largest = 0;
+    for( i = 0; i < size; ++i ) {
+        if( fabs( u[i*ldu + i] ) > largest ) largest = fabs( u[i*ldu + i] );
+    }
+    for( i = 0; i < size; ++i ) {
+        if( fabs( u[i*ldu + i] ) <= PIVOT_TOLERANCE * largest ) return -1;
+    }
+    if( size == 0 || rhs_count == 0 ) return 0;
+
+    work.upper = 1;
+    work.size = size;
+    work.rhs_count = rhs_count;
+    work.t = u;
+    work.ldt = ldu;
+    work.b = b;
+    work.ldb = ldb;
+    work.thread_count = thread_count;
+    LOCAL( solve )( &work );
+    return 0;
+}
+
+
+void NAME( unit_lower_triangular_solve )(
+    size_t size, size_t rhs_count, const ELEMENT *l, size_t ldl, ELEMENT *b, size_t ldb, int thread_count )
+{
+    struct LOCAL( SolveWork ) work;
+
+    if( size == 0 || rhs_count == 0 ) return;
+
+    work.upper = 0;
+    work.size = size;
+    work.rhs_count = rhs_count;
+    work.t = l;
+    work.ldt = ldl;
+    work.b = b;
+    work.ldb = ldb;
+    work.thread_count = thread_count;
+    LOCAL( solve )( &work );
+}
+
+#undef LOCAL
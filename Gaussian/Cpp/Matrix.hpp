@@ -30,6 +30,16 @@ public:
      *  \param initial_m The number of columns in the matrix. Requires initial_m >= 1.
      */
     Matrix( std::size_t initial_n, std::size_t initial_m );
+
+    //! Construct a matrix that presents existing storage as an n x m matrix.
+    /*!
+     *  The elements are not copied and the matrix does not own them; they must outlive the
+     *  matrix. This allows a solver to work in place on an array owned by someone else (for
+     *  example, a NumPy array). Copies of such a matrix have storage of their own.
+     *
+     *  \param external The n x m elements in row-major order.
+     */
+    Matrix( NumericType *external, std::size_t initial_n, std::size_t initial_m );
    ~Matrix( );
 
     //! Copies another matrix to construct this matrix.
@@ -68,27 +78,34 @@ private:
     NumericType *elements;
     std::size_t  n;
     std::size_t  m;
+    bool         owner;   // True if elements must be deleted by this matrix.
 };
 
 
 template< typename NumericType >
 Matrix<NumericType>::Matrix( std::size_t initial_n, std::size_t initial_m )
-    : elements( 0 ), n( initial_n ), m( initial_m )
+    : elements( 0 ), n( initial_n ), m( initial_m ), owner( true )
 {
     // TODO: Throw an exception if the documented requirements are violated?
     elements = new NumericType[ n * m ];
 }
 
 
+template< typename NumericType >
+Matrix<NumericType>::Matrix( NumericType *external, std::size_t initial_n, std::size_t initial_m )
+    : elements( external ), n( initial_n ), m( initial_m ), owner( false )
+{ }
+
+
 template< typename NumericType >
 Matrix<NumericType>::~Matrix( )
 {
-    delete [] elements;
+    if( owner ) delete [] elements;
 }
 
 template< typename NumericType >
 Matrix<NumericType>::Matrix( const Matrix &other )
-    : elements( 0 ), n( other.n ), m( other.m )
+    : elements( 0 ), n( other.n ), m( other.m ), owner( true )
 {
     elements = new NumericType[ n * m ];
     std::memcpy( elements, other.elements, n * m * sizeof( NumericType ) );
@@ -99,10 +116,11 @@ template< typename NumericType >
 Matrix<NumericType> &Matrix<NumericType>::operator=( const Matrix &other )
 {
     // Allocate first so that '*this' is left unchanged if an exception is thrown here.
-    NumericType *fresh_elements = new NumericType[ n * m ];
+    NumericType *fresh_elements = new NumericType[ other.n * other.m ];
 
-    delete [] elements;
+    if( owner ) delete [] elements;
     elements = fresh_elements;
+    owner = true;
     n = other.n;
     m = other.m;
     std::memcpy( elements, other.elements, n * m * sizeof( NumericType ) );
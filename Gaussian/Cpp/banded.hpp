@@ -0,0 +1,136 @@
+/*!
+    \file   banded.hpp
+    \brief  Gaussian elimination for banded systems.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    Systems arising from the discretization of differential equations are often banded: the
+    only non-zero coefficients are on, or near, the diagonal. For example a tridiagonal system
+    has one non-zero element on each side of the diagonal. Eliminating such a system as if it
+    were dense does O(n^3) work, almost all of it on zeros. Here only the band is stored and
+    updated so the work is O(n * p * q) where p and q are the lower and upper bandwidths.
+
+    Partial pivoting can move a row of the band up by as many as p rows. That widens the upper
+    part of the band by p. Space for the extra elements is included in the band storage.
+*/
+
+#ifndef BANDED_HPP
+#define BANDED_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "Matrix.hpp"
+#include "../C/pivot_threshold.h"
+
+//! A square matrix with non-zero elements only in a band around the diagonal.
+/*!
+ *  Element (i, j) may be non-zero only if i - lower <= j <= i + upper. Row i of the storage
+ *  holds columns i - lower .. i + upper + lower; the extra lower elements at the end of each row
+ *  are used for fill in during elimination with partial pivoting.
+ */
+template< typename FloatingType >
+class BandMatrix {
+public:
+    //! Creates a size x size band matrix with the given bandwidths. All elements are zero.
+    BandMatrix( std::size_t size, std::size_t lower, std::size_t upper )
+        : n( size ), p( lower ), q( upper ), width( 2 * lower + upper + 1 ), elements( size * width )
+    { }
+
+    //! Copies the band of a dense matrix. Elements outside the band are ignored.
+    BandMatrix( const Matrix<FloatingType> &dense, std::size_t lower, std::size_t upper );
+
+    //! Returns a reference to element (row, col). The element must be inside the storage band.
+    FloatingType &operator( )( std::size_t row, std::size_t col )
+        { return elements[row * width + ( col + p - row )]; }
+
+    const FloatingType &operator( )( std::size_t row, std::size_t col ) const
+        { return elements[row * width + ( col + p - row )]; }
+
+    std::size_t size( ) const { return n; }
+    std::size_t lower( ) const { return p; }
+    std::size_t upper( ) const { return q; }
+
+    //! Returns the pivot_threshold of the matrix. The storage outside the band holds zeros.
+    double pivot_threshold( ) const { return ::pivot_threshold( n, width, elements.data( ), width ); }
+
+private:
+    std::size_t n;
+    std::size_t p;
+    std::size_t q;
+    std::size_t width;
+    std::vector< FloatingType > elements;
+};
+
+
+template< typename FloatingType >
+BandMatrix<FloatingType>::BandMatrix( const Matrix<FloatingType> &dense, std::size_t lower, std::size_t upper )
+    : n( dense.row_count( ) ), p( lower ), q( upper ), width( 2 * lower + upper + 1 ), elements( n * width )
+{
+    for( std::size_t i = 0; i < n; ++i ) {
+        const std::size_t first = ( i > p ) ? i - p : 0;
+        const std::size_t last = std::min( i + q + 1, n );
+        for( std::size_t j = first; j < last; ++j ) ( *this )( i, j ) = dense( i, j );
+    }
+}
+
+
+//! Solve Ax=b using Gaussian elimination where A is a band matrix.
+/*!
+ *  The solution is returned in b if the elimination is successful. The values of a and b are
+ *  consumed in any case.
+ *
+ *  \return true if the solution was successfully found and false otherwise.
+ */
+template< typename FloatingType >
+bool banded_solve( BandMatrix<FloatingType> &a, FloatingType *b )
+{
+    const std::size_t size = a.size( );
+    const std::size_t lower = a.lower( );
+    const std::size_t upper = a.upper( ) + a.lower( );   // Upper bandwidth after fill in.
+    const double threshold = a.pivot_threshold( );
+
+    for( std::size_t i = 0; i < size; ++i ) {
+        const std::size_t row_last = std::min( i + lower + 1, size );
+        const std::size_t col_last = std::min( i + upper + 1, size );
+
+        // Find the row with the largest value of |a(j, i)|, j = i, ..., i + lower
+        std::size_t k = i;
+        FloatingType max = std::abs( a(i, i) );
+        for( std::size_t j = i + 1; j < row_last; ++j ) {
+            if( std::abs( a(j, i) ) > max ) {
+                k = j;
+                max = std::abs( a(j, i) );
+            }
+        }
+
+        if( max <= threshold ) return false;
+
+        // Exchange row i and row k, if necessary. Only the columns inside the band move.
+        if( k != i ) {
+            for( std::size_t c = i; c < col_last; ++c ) std::swap( a(i, c), a(k, c) );
+            std::swap( b[i], b[k] );
+        }
+
+        // Subtract multiples of row i from the rows below it that are inside the band.
+        const FloatingType inverse = FloatingType( 1 ) / a(i, i);
+        for( std::size_t j = i + 1; j < row_last; ++j ) {
+            const FloatingType factor = a(j, i) * inverse;
+            if( factor == FloatingType( 0 ) ) continue;
+            for( std::size_t c = i + 1; c < col_last; ++c ) a(j, c) -= factor * a(i, c);
+            b[j] -= factor * b[i];
+        }
+    }
+
+    // Back substitution.
+    for( std::size_t i = size; i > 0; --i ) {
+        const std::size_t row = i - 1;
+        const std::size_t col_last = std::min( row + upper + 1, size );
+        FloatingType sum = b[row];
+        for( std::size_t c = row + 1; c < col_last; ++c ) sum -= a(row, c) * b[c];
+        b[row] = sum / a(row, row);
+    }
+    return true;
+}
+
+#endif
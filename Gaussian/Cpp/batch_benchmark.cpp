@@ -0,0 +1,117 @@
+/*!
+    \file   batch_benchmark.cpp
+    \brief  Measures the rate at which batches of small systems are solved.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    For each of the specialized sizes a batch of random (diagonally dominant) systems is solved
+    with batched_solve and, for comparison, one system at a time with gaussian_solve. The rates
+    are reported in systems solved per second.
+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "batched_solve.hpp"
+#include "linear_equations.hpp"
+
+using namespace std;
+
+//
+// Fills a batch with random systems. Making the matrices diagonally dominant ensures that none
+// of the systems is degenerate.
+//
+void make_batch( size_t size, size_t batch_count, vector<double> &a, vector<double> &b )
+{
+    mt19937 generator( static_cast<unsigned>( size ) );
+    uniform_real_distribution<double> distribution( -1.0, 1.0 );
+
+    a.resize( batch_count * size * size );
+    b.resize( batch_count * size );
+    for( size_t i = 0; i < a.size( ); ++i ) a[i] = distribution( generator );
+    for( size_t i = 0; i < b.size( ); ++i ) b[i] = distribution( generator );
+    for( size_t system = 0; system < batch_count; ++system ) {
+        for( size_t r = 0; r < size; ++r ) a[system * size * size + r * size + r] += static_cast<double>( size );
+    }
+}
+
+
+//
+// Returns the largest |b - Ax| over all systems in the batch.
+//
+double max_residual( size_t size, size_t batch_count, const vector<double> &a, const vector<double> &b, const vector<double> &x )
+{
+    double result = 0.0;
+    for( size_t system = 0; system < batch_count; ++system ) {
+        for( size_t r = 0; r < size; ++r ) {
+            double sum = b[system * size + r];
+            for( size_t c = 0; c < size; ++c ) {
+                sum -= a[system * size * size + r * size + c] * x[system * size + c];
+            }
+            result = max( result, abs( sum ) );
+        }
+    }
+    return result;
+}
+
+
+int main( int argc, char *argv[] )
+{
+    size_t   element_budget = 64 * 1024 * 1024;   // Approximate number of matrix elements per batch.
+    unsigned thread_count = 0;
+
+    for( int i = 1; i < argc; ++i ) {
+        if( strcmp( argv[i], "-t" ) == 0 && i + 1 < argc ) {
+            thread_count = static_cast<unsigned>( atoi( argv[++i] ) );
+        }
+        else if( strcmp( argv[i], "-e" ) == 0 && i + 1 < argc ) {
+            element_budget = strtoul( argv[++i], 0, 10 );
+        }
+        else {
+            cout << "Usage: " << argv[0] << " [-t threads] [-e elements-per-batch]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    const size_t sizes[] = { 4, 8, 16, 32, 64 };
+
+    cout << "    N    systems   batched (systems/s)   one at a time (systems/s)   speedup   max residual\n";
+    for( size_t size : sizes ) {
+        const size_t batch_count = max< size_t >( 1, element_budget / ( size * size ) );
+        vector<double> a, b;
+        make_batch( size, batch_count, a, b );
+
+        // Batched.
+        vector<double> x( b );
+        chrono::steady_clock::time_point start_time = chrono::steady_clock::now( );
+        size_t failures = batched_solve( size, batch_count, a.data( ), x.data( ), 0, thread_count );
+        chrono::duration<double> batched_time = chrono::steady_clock::now( ) - start_time;
+
+        // One at a time, using a sample of the batch to keep the run time reasonable.
+        const size_t sample_count = min< size_t >( batch_count, 20000 );
+        start_time = chrono::steady_clock::now( );
+        for( size_t system = 0; system < sample_count; ++system ) {
+            Matrix<double> single( size, size );
+            boost::scoped_array<double> single_b( new double[size] );
+            memcpy( single.get_row( 0 ), &a[system * size * size], size * size * sizeof( double ) );
+            memcpy( single_b.get( ), &b[system * size], size * sizeof( double ) );
+            if( !gaussian_solve( single, single_b.get( ) ) ) ++failures;
+        }
+        chrono::duration<double> single_time = chrono::steady_clock::now( ) - start_time;
+
+        const double batched_rate = batch_count / batched_time.count( );
+        const double single_rate = sample_count / single_time.count( );
+        cout << setw(5) << size << setw(11) << batch_count
+             << setw(22) << fixed << setprecision(0) << batched_rate
+             << setw(28) << single_rate
+             << setw(10) << setprecision(1) << batched_rate / single_rate
+             << setw(15) << scientific << setprecision(2) << max_residual( size, batch_count, a, b, x ) << "\n";
+        cout.unsetf( ios::floatfield );
+        if( failures != 0 ) cout << "  (" << failures << " degenerate systems)\n";
+    }
+    return EXIT_SUCCESS;
+}
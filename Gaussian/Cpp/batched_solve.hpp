@@ -0,0 +1,231 @@
+/*!
+    \file   batched_solve.hpp
+    \brief  Solves large batches of small, independent systems.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    The other solvers in this folder are designed for one large system. For a small system
+    (say 4 x 4 up to 64 x 64) the overhead of allocating a Matrix, and of starting threads, is
+    far larger than the elimination itself. When there are many such systems it is better to
+    solve them together.
+
+    The systems in a batch are processed in groups of lane_count. The elements of the systems in
+    a group are interleaved so that element (i, j) of every system in the group is adjacent in
+    memory ("structure of arrays"). Each step of the elimination then does the same operation on
+    lane_count systems at once, and the innermost loops (over the systems in the group) are
+    easily vectorized by the compiler. The groups are divided among threads.
+
+    The common sizes are specialized at compile time so that the compiler can unroll the loops.
+    Other sizes are handled by a general version.
+*/
+
+#ifndef BATCHED_SOLVE_HPP
+#define BATCHED_SOLVE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "parallel_for.hpp"
+#include "../C/pivot_threshold.h"
+
+namespace batched {
+
+    // Number of systems processed together. Enough for 512 bit vectors of doubles.
+    const std::size_t lane_count = 8;
+
+    //! Solves one group of (at most lane_count) systems.
+    /*!
+     *  If Size is zero the size is given by runtime_size. Otherwise Size is the size and
+     *  runtime_size is ignored.
+     *
+     *  \param a The first matrix of the group (each matrix is size x size in row-major order).
+     *  \param b The first driving vector of the group. Overwritten with the solutions.
+     *  \param count The number of systems in the group.
+     *  \param work Space for size * (size + 1) * lane_count values.
+     *  \param degenerate If not null, set to one for each degenerate system and zero otherwise.
+     *  \return The number of degenerate systems in the group.
+     */
+    template< std::size_t Size, typename FloatingType >
+    std::size_t solve_group(
+        std::size_t         runtime_size,
+        const FloatingType *a,
+        FloatingType       *b,
+        std::size_t         count,
+        FloatingType       *work,
+        unsigned char      *degenerate )
+    {
+        const std::size_t n = ( Size != 0 ) ? Size : runtime_size;
+        const std::size_t L = lane_count;
+        FloatingType *m = work;               // m[( r * n + c ) * L + lane]
+        FloatingType *x = work + n * n * L;   // x[r * L + lane]
+
+        // Interleave the systems. Unused lanes get the identity matrix so they can't fail.
+        for( std::size_t lane = 0; lane < L; ++lane ) {
+            for( std::size_t r = 0; r < n; ++r ) {
+                for( std::size_t c = 0; c < n; ++c ) {
+                    m[( r * n + c ) * L + lane] =
+                        ( lane < count ) ? a[lane * n * n + r * n + c] : FloatingType( r == c );
+                }
+                x[r * L + lane] = ( lane < count ) ? b[lane * n + r] : FloatingType( 0 );
+            }
+        }
+
+        std::size_t  pivot[L];
+        double       threshold[L];
+        FloatingType max[L];
+        FloatingType inverse[L];
+        FloatingType factor[L];
+        bool         failed[L];
+        for( std::size_t lane = 0; lane < L; ++lane ) {
+            threshold[lane] = ( lane < count ) ? pivot_threshold( n, n, &a[lane * n * n], n ) : PIVOT_TOLERANCE;
+            failed[lane] = false;
+        }
+
+        for( std::size_t i = 0; i < n; ++i ) {
+
+            // Find the pivot row in each system.
+            for( std::size_t lane = 0; lane < L; ++lane ) {
+                pivot[lane] = i;
+                max[lane] = std::abs( m[( i * n + i ) * L + lane] );
+            }
+            for( std::size_t r = i + 1; r < n; ++r ) {
+                for( std::size_t lane = 0; lane < L; ++lane ) {
+                    const FloatingType value = std::abs( m[( r * n + i ) * L + lane] );
+                    const bool larger = value > max[lane];
+                    max[lane] = larger ? value : max[lane];
+                    pivot[lane] = larger ? r : pivot[lane];
+                }
+            }
+
+            // Exchange rows. The pivot rows differ between systems so this is done one at a time.
+            for( std::size_t lane = 0; lane < L; ++lane ) {
+                const std::size_t k = pivot[lane];
+                if( k == i ) continue;
+                for( std::size_t c = i; c < n; ++c ) {
+                    std::swap( m[( i * n + c ) * L + lane], m[( k * n + c ) * L + lane] );
+                }
+                std::swap( x[i * L + lane], x[k * L + lane] );
+            }
+
+            // A degenerate system carries on with a harmless pivot; its results are discarded.
+            for( std::size_t lane = 0; lane < L; ++lane ) {
+                const bool bad = max[lane] <= threshold[lane];
+                failed[lane] = failed[lane] || bad;
+                inverse[lane] = bad ? FloatingType( 1 ) : FloatingType( 1 ) / m[( i * n + i ) * L + lane];
+            }
+
+            // Subtract multiples of row i from subsequent rows.
+            for( std::size_t r = i + 1; r < n; ++r ) {
+                for( std::size_t lane = 0; lane < L; ++lane ) {
+                    factor[lane] = m[( r * n + i ) * L + lane] * inverse[lane];
+                }
+                for( std::size_t c = i + 1; c < n; ++c ) {
+                    FloatingType       *row = &m[( r * n + c ) * L];
+                    const FloatingType *pivot_row = &m[( i * n + c ) * L];
+                    for( std::size_t lane = 0; lane < L; ++lane ) row[lane] -= factor[lane] * pivot_row[lane];
+                }
+                for( std::size_t lane = 0; lane < L; ++lane ) x[r * L + lane] -= factor[lane] * x[i * L + lane];
+            }
+        }
+
+        // Back substitution.
+        for( std::size_t i = n; i > 0; --i ) {
+            const std::size_t r = i - 1;
+            for( std::size_t c = r + 1; c < n; ++c ) {
+                const FloatingType *row = &m[( r * n + c ) * L];
+                for( std::size_t lane = 0; lane < L; ++lane ) x[r * L + lane] -= row[lane] * x[c * L + lane];
+            }
+            for( std::size_t lane = 0; lane < L; ++lane ) {
+                const FloatingType diagonal = m[( r * n + r ) * L + lane];
+                x[r * L + lane] = failed[lane] ? FloatingType( 0 ) : x[r * L + lane] / diagonal;
+            }
+        }
+
+        // Copy the solutions back.
+        std::size_t failure_count = 0;
+        for( std::size_t lane = 0; lane < count; ++lane ) {
+            for( std::size_t r = 0; r < n; ++r ) b[lane * n + r] = x[r * L + lane];
+            if( degenerate != 0 ) degenerate[lane] = failed[lane];
+            if( failed[lane] ) ++failure_count;
+        }
+        return failure_count;
+    }
+
+
+    //! Solves the groups [first_group, last_group) of a batch.
+    template< std::size_t Size, typename FloatingType >
+    std::size_t solve_groups(
+        std::size_t         size,
+        std::size_t         batch_count,
+        const FloatingType *a,
+        FloatingType       *b,
+        unsigned char      *degenerate,
+        std::size_t         first_group,
+        std::size_t         last_group )
+    {
+        std::vector< FloatingType > work( size * ( size + 1 ) * lane_count );
+        std::size_t failure_count = 0;
+
+        for( std::size_t group = first_group; group < last_group; ++group ) {
+            const std::size_t first = group * lane_count;
+            const std::size_t count = std::min( lane_count, batch_count - first );
+            failure_count += solve_group< Size >(
+                size, &a[first * size * size], &b[first * size], count, work.data( ),
+                ( degenerate != 0 ) ? &degenerate[first] : 0 );
+        }
+        return failure_count;
+    }
+
+}
+
+
+//! Solves a batch of independent size x size systems.
+/*!
+ *  The systems are stored one after another: a holds batch_count matrices of size x size
+ *  elements each (in row-major order) and b holds batch_count driving vectors of size elements
+ *  each. Sizes 4, 8, 16, 32, and 64 are specialized, but any size can be used.
+ *
+ *  \param a The matrices of coefficients. They are not modified.
+ *  \param b The driving vectors. Overwritten with the solutions (zero for degenerate systems).
+ *  \param degenerate If not null, points at batch_count flags that are set to one for each
+ *  degenerate system and to zero for the others.
+ *  \param thread_count The maximum number of threads to use (zero means "all").
+ *  \return The number of degenerate systems.
+ */
+template< typename FloatingType >
+std::size_t batched_solve(
+    std::size_t         size,
+    std::size_t         batch_count,
+    const FloatingType *a,
+    FloatingType       *b,
+    unsigned char      *degenerate = 0,
+    unsigned            thread_count = 0 )
+{
+    if( size == 0 || batch_count == 0 ) return 0;
+    if( thread_count == 0 ) thread_count = default_thread_count( );
+
+    const std::size_t group_count = ( batch_count + batched::lane_count - 1 ) / batched::lane_count;
+    const unsigned    threads = static_cast<unsigned>( std::min< std::size_t >( thread_count, group_count ) );
+    std::atomic< std::size_t > failure_count( 0 );
+
+    parallel_for_ranges( 0, group_count,
+        [&]( std::size_t first, std::size_t last, unsigned )
+        {
+            std::size_t failures;
+            switch( size ) {
+            case  4: failures = batched::solve_groups<  4 >( size, batch_count, a, b, degenerate, first, last ); break;
+            case  8: failures = batched::solve_groups<  8 >( size, batch_count, a, b, degenerate, first, last ); break;
+            case 16: failures = batched::solve_groups< 16 >( size, batch_count, a, b, degenerate, first, last ); break;
+            case 32: failures = batched::solve_groups< 32 >( size, batch_count, a, b, degenerate, first, last ); break;
+            case 64: failures = batched::solve_groups< 64 >( size, batch_count, a, b, degenerate, first, last ); break;
+            default: failures = batched::solve_groups<  0 >( size, batch_count, a, b, degenerate, first, last ); break;
+            }
+            failure_count += failures;
+        },
+        threads );
+
+    return failure_count;
+}
+
+#endif
@@ -0,0 +1,246 @@
+/*!
+    \file   calu.hpp
+    \brief  A communication avoiding LU decomposition using tournament pivoting.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    With ordinary partial pivoting the pivot for each column must be found before the next
+    column can be processed. In a parallel program that means one synchronization of all threads
+    per column. CALU instead chooses the pivot rows for an entire panel at once using a
+    "tournament." The rows of the panel are divided into blocks and each block selects its best
+    candidate rows by applying partial pivoting to its own rows. Pairs of candidate sets are
+    then merged, and the best rows selected again, in a reduction tree until only one set of
+    candidates remains. Those rows become the pivot rows of the panel. The panel can then be
+    factored without any further pivoting.
+
+    The cost of pivot selection is one reduction per panel rather than one barrier per column.
+    The stability of tournament pivoting is, in practice, comparable to partial pivoting.
+
+    The result has exactly the same form as that of lu_factor so lu_solve can be used with it.
+*/
+
+#ifndef CALU_HPP
+#define CALU_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "Matrix.hpp"
+#include "lu_decomposition.hpp"
+#include "parallel_for.hpp"
+
+namespace calu {
+
+    //! Selects the best pivot rows for the panel columns [first_column, last_column).
+    /*!
+     *  Partial pivoting is applied to a copy of the panel columns of the given rows (the matrix
+     *  itself is not modified). The rows that partial pivoting would use as pivots are returned
+     *  in the order in which they were chosen.
+     *
+     *  \param rows The indices of the rows competing.
+     *  \return At most last_column - first_column row indices.
+     */
+    template< typename FloatingType >
+    std::vector< std::size_t > select_candidates(
+        const Matrix<FloatingType>       &a,
+        const std::vector< std::size_t > &rows,
+        std::size_t                       first_column,
+        std::size_t                       last_column )
+    {
+        const std::size_t width = last_column - first_column;
+        const std::size_t row_count = rows.size( );
+        const std::size_t candidate_count = std::min( width, row_count );
+
+        std::vector< FloatingType > work( row_count * width );
+        std::vector< std::size_t >  order( rows );
+        for( std::size_t j = 0; j < row_count; ++j ) {
+            std::copy( &a(rows[j], first_column), &a(rows[j], first_column) + width, &work[j * width] );
+        }
+
+        for( std::size_t i = 0; i < candidate_count; ++i ) {
+
+            // Find the row with the largest value in column i.
+            std::size_t k = i;
+            FloatingType max = std::abs( work[i * width + i] );
+            for( std::size_t j = i + 1; j < row_count; ++j ) {
+                if( std::abs( work[j * width + i] ) > max ) {
+                    k = j;
+                    max = std::abs( work[j * width + i] );
+                }
+            }
+            if( k != i ) {
+                std::swap_ranges( &work[i * width], &work[( i + 1 ) * width], &work[k * width] );
+                std::swap( order[i], order[k] );
+            }
+
+            // A zero column can't be eliminated. Let the caller discover the matrix is singular.
+            if( max == FloatingType( 0 ) ) continue;
+
+            const FloatingType *pivot_row = &work[i * width];
+            for( std::size_t j = i + 1; j < row_count; ++j ) {
+                FloatingType *row = &work[j * width];
+                const FloatingType factor = row[i] / pivot_row[i];
+                for( std::size_t c = i + 1; c < width; ++c ) {
+                    row[c] -= factor * pivot_row[c];
+                }
+            }
+        }
+        order.resize( candidate_count );
+        return order;
+    }
+
+
+    //! Factors the panel of columns [first_column, last_column) using tournament pivoting.
+    /*!
+     *  Entire rows are exchanged, as with lu::factor_panel, and the pivots are recorded in the
+     *  same way. Only rows first_column .. n - 1 are considered.
+     *
+     *  \param threshold The pivot_threshold of the original matrix.
+     *  \return false if a pivot is too small.
+     */
+    template< typename FloatingType >
+    bool factor_panel(
+        Matrix<FloatingType> &a,
+        std::size_t          *pivots,
+        std::size_t           first_column,
+        std::size_t           last_column,
+        double                threshold,
+        unsigned              thread_count )
+    {
+        const std::size_t size = a.row_count( );
+        const std::size_t row_count = size - first_column;
+        const std::size_t width = last_column - first_column;
+
+        // Each block in the first round of the tournament should have at least a panel's worth
+        // of rows, otherwise there is no real competition.
+        const std::size_t block_count =
+            std::max< std::size_t >( 1, std::min< std::size_t >( thread_count, row_count / width ) );
+
+        // First round: each block selects its candidates.
+        std::vector< std::vector< std::size_t > > candidates( block_count );
+        parallel_for( 0, block_count,
+            [&]( std::size_t block )
+            {
+                const std::size_t block_first = first_column + ( row_count * block ) / block_count;
+                const std::size_t block_last  = first_column + ( row_count * ( block + 1 ) ) / block_count;
+                std::vector< std::size_t > rows;
+                for( std::size_t j = block_first; j < block_last; ++j ) rows.push_back( j );
+                candidates[block] = select_candidates( a, rows, first_column, last_column );
+            },
+            thread_count );
+
+        // Remaining rounds: merge pairs of candidate sets until only the winners remain.
+        while( candidates.size( ) > 1 ) {
+            std::vector< std::vector< std::size_t > > next( ( candidates.size( ) + 1 ) / 2 );
+            parallel_for( 0, next.size( ),
+                [&]( std::size_t k )
+                {
+                    if( 2 * k + 1 == candidates.size( ) ) {
+                        next[k].swap( candidates[2 * k] );
+                        return;
+                    }
+                    std::vector< std::size_t > rows( candidates[2 * k] );
+                    rows.insert( rows.end( ), candidates[2 * k + 1].begin( ), candidates[2 * k + 1].end( ) );
+                    next[k] = select_candidates( a, rows, first_column, last_column );
+                },
+                thread_count );
+            candidates.swap( next );
+        }
+        const std::vector< std::size_t > &winners = candidates[0];
+
+        // Move the winners to the top of the panel. The row originally at first_column + p is
+        // now at first_column + position[p], and origin is the inverse of position.
+        std::vector< std::size_t > position( row_count );
+        std::vector< std::size_t > origin( row_count );
+        for( std::size_t p = 0; p < row_count; ++p ) position[p] = origin[p] = p;
+
+        for( std::size_t i = 0; i < width; ++i ) {
+            const std::size_t winner = winners[i] - first_column;
+            const std::size_t current = position[winner];
+            const std::size_t displaced = origin[i];
+
+            pivots[first_column + i] = first_column + current;
+            if( current != i ) lu::swap_rows( a, first_column + i, first_column + current );
+
+            origin[i] = winner;
+            position[winner] = i;
+            origin[current] = displaced;
+            position[displaced] = current;
+        }
+
+        // Factor the diagonal block without pivoting.
+        for( std::size_t i = first_column; i < last_column; ++i ) {
+            const FloatingType *pivot_row = a.get_row( i );
+            if( std::abs( pivot_row[i] ) <= threshold ) return false;
+
+            const FloatingType inverse = FloatingType( 1 ) / pivot_row[i];
+            for( std::size_t j = i + 1; j < last_column; ++j ) {
+                FloatingType *row = a.get_row( j );
+                const FloatingType factor = ( row[i] *= inverse );
+                for( std::size_t c = i + 1; c < last_column; ++c ) {
+                    row[c] -= factor * pivot_row[c];
+                }
+            }
+        }
+
+        // L21 = A21 * inverse(U11). Each row is independent.
+        parallel_for_ranges( last_column, size,
+            [&]( std::size_t first, std::size_t last, unsigned )
+            {
+                for( std::size_t j = first; j < last; ++j ) {
+                    FloatingType *row = a.get_row( j );
+                    for( std::size_t i = first_column; i < last_column; ++i ) {
+                        const FloatingType *pivot_row = a.get_row( i );
+                        const FloatingType  factor = ( row[i] /= pivot_row[i] );
+                        for( std::size_t c = i + 1; c < last_column; ++c ) {
+                            row[c] -= factor * pivot_row[c];
+                        }
+                    }
+                }
+            },
+            thread_count );
+        return true;
+    }
+
+}
+
+
+//! Factors a in place so that P*a = L*U using tournament pivoting.
+/*!
+ *  The results (and the meaning of the parameters) are the same as for lu_factor. However, the
+ *  pivots chosen are generally different from those chosen by partial pivoting.
+ *
+ *  \return true if the factorization succeeded; false if the matrix is (nearly) singular.
+ */
+template< typename FloatingType >
+bool calu_factor( Matrix<FloatingType> &a, std::size_t *pivots, unsigned thread_count = 0 )
+{
+    // Make sure we are dealing with a square matrix.
+    assert( a.row_count( ) == a.col_count( ) );
+
+    const std::size_t size = a.row_count( );
+    if( thread_count == 0 ) thread_count = default_thread_count( );
+    const double threshold = pivot_threshold( size, size, a.get_row( 0 ), size );
+
+    for( std::size_t panel_first = 0; panel_first < size; panel_first += lu::panel_width ) {
+        const std::size_t panel_last = std::min( panel_first + lu::panel_width, size );
+
+        if( !calu::factor_panel( a, pivots, panel_first, panel_last, threshold, thread_count ) ) return false;
+
+        // Give each thread at least one strip of the trailing columns.
+        const std::size_t trailing_columns = size - panel_last;
+        const std::size_t strip_count = ( trailing_columns + lu::strip_width - 1 ) / lu::strip_width;
+        const unsigned    threads = static_cast<unsigned>( std::min< std::size_t >( thread_count, strip_count ) );
+
+        parallel_for_ranges( panel_last, size,
+            [&]( std::size_t first, std::size_t last, unsigned )
+            {
+                lu::update_columns( a, panel_first, panel_last, first, last );
+            },
+            threads );
+    }
+    return true;
+}
+
+#endif
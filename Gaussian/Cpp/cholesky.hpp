@@ -0,0 +1,175 @@
+/*!
+    \file   cholesky.hpp
+    \brief  A blocked, parallel Cholesky decomposition for symmetric positive definite systems.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    A symmetric positive definite matrix can be factored as A = U^T U where U is upper
+    triangular. No pivoting is needed and only half the matrix takes part, so the factorization
+    takes about half the work of an LU decomposition.
+
+    The factorization is blocked. The rows of U in each block of rows are first computed (this
+    is done in parallel over strips of columns) and then the trailing part of the matrix is
+    updated (this is done in parallel over rows). Only the upper triangle of the matrix is used
+    or modified; the strictly lower triangle is left unchanged.
+*/
+
+#ifndef CHOLESKY_HPP
+#define CHOLESKY_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include "Matrix.hpp"
+#include "../C/pivot_threshold.h"
+#include "../C/triangular_solve.h"
+#include "parallel_for.hpp"
+
+namespace cholesky {
+
+    // Number of rows in each block.
+    const std::size_t block_size = 64;
+
+    // Width of the column strips handed to each thread when computing a block of rows of U.
+    const std::size_t strip_width = 256;
+
+    //! Computes the rows [first_row, last_row) of U in the columns [first, last).
+    /*!
+     *  The diagonal block must already have been factored. Distinct column ranges can be
+     *  processed concurrently.
+     */
+    template< typename FloatingType >
+    void compute_rows(
+        Matrix<FloatingType> &a, std::size_t first_row, std::size_t last_row, std::size_t first, std::size_t last )
+    {
+        for( std::size_t i = first_row; i < last_row; ++i ) {
+            FloatingType *u_row = a.get_row( i );
+            const FloatingType inverse = FloatingType( 1 ) / u_row[i];
+            for( std::size_t c = first; c < last; ++c ) u_row[c] *= inverse;
+
+            for( std::size_t r = i + 1; r < last_row; ++r ) {
+                FloatingType *row = a.get_row( r );
+                const FloatingType factor = u_row[r];
+                for( std::size_t c = first; c < last; ++c ) row[c] -= factor * u_row[c];
+            }
+        }
+    }
+
+
+    //! Subtracts U(block)^T * U(block) from row r of the trailing matrix (upper triangle only).
+    template< typename FloatingType >
+    void update_row( Matrix<FloatingType> &a, std::size_t first_row, std::size_t last_row, std::size_t r )
+    {
+        const std::size_t size = a.row_count( );
+        FloatingType *row = a.get_row( r );
+
+        for( std::size_t p = first_row; p < last_row; ++p ) {
+            const FloatingType *u_row = a.get_row( p );
+            const FloatingType  factor = u_row[r];
+            for( std::size_t c = r; c < size; ++c ) row[c] -= factor * u_row[c];
+        }
+    }
+
+}
+
+
+//! Factors a in place so that a = U^T U.
+/*!
+ *  On return the upper triangle of a (including the diagonal) holds U. The strictly lower
+ *  triangle is not used and is left unchanged.
+ *
+ *  \param thread_count The maximum number of threads to use (zero means "all").
+ *  \return true if the factorization succeeded; false if the matrix is not (numerically)
+ *  positive definite. In that case a is left partially factored.
+ */
+template< typename FloatingType >
+bool cholesky_factor( Matrix<FloatingType> &a, unsigned thread_count = 0 )
+{
+    // Make sure we are dealing with a square matrix.
+    assert( a.row_count( ) == a.col_count( ) );
+
+    const std::size_t size = a.row_count( );
+    if( thread_count == 0 ) thread_count = default_thread_count( );
+
+    // The largest coefficient of a positive definite matrix is on the diagonal, so only the
+    // diagonal (as a column with rows size + 1 elements apart) needs to be searched.
+    const double threshold = pivot_threshold( size, 1, a.get_row( 0 ), size + 1 );
+
+    for( std::size_t block_first = 0; block_first < size; block_first += cholesky::block_size ) {
+        const std::size_t block_last = std::min( block_first + cholesky::block_size, size );
+
+        // Factor the diagonal block. Once a diagonal element is known, the rest of the block
+        // row can be computed.
+        for( std::size_t i = block_first; i < block_last; ++i ) {
+            FloatingType &diagonal = a(i, i);
+            if( !( diagonal > threshold ) ) return false;
+            diagonal = std::sqrt( diagonal );
+
+            const FloatingType inverse = FloatingType( 1 ) / diagonal;
+            FloatingType *u_row = a.get_row( i );
+            for( std::size_t c = i + 1; c < block_last; ++c ) u_row[c] *= inverse;
+            for( std::size_t r = i + 1; r < block_last; ++r ) {
+                FloatingType *row = a.get_row( r );
+                const FloatingType factor = u_row[r];
+                for( std::size_t c = r; c < block_last; ++c ) row[c] -= factor * u_row[c];
+            }
+        }
+
+        // Compute the rest of the rows of U in this block, in parallel over strips of columns.
+        const std::size_t trailing_columns = size - block_last;
+        const std::size_t strip_count = ( trailing_columns + cholesky::strip_width - 1 ) / cholesky::strip_width;
+        const unsigned    threads = static_cast<unsigned>( std::min< std::size_t >( thread_count, strip_count ) );
+        parallel_for_ranges( block_last, size,
+            [&]( std::size_t first, std::size_t last, unsigned )
+            {
+                cholesky::compute_rows( a, block_first, block_last, first, last );
+            },
+            threads );
+
+        // Update the trailing matrix. The rows get shorter as r increases, so the rows are dealt
+        // out to the threads cyclically in small groups to balance the load.
+        const std::size_t group_size = 16;
+        const std::size_t group_count = ( trailing_columns + group_size - 1 ) / group_size;
+        const unsigned    update_threads = static_cast<unsigned>( std::min< std::size_t >( thread_count, group_count ) );
+        parallel_for_ranges( 0, update_threads,
+            [&]( std::size_t first_thread, std::size_t last_thread, unsigned )
+            {
+                for( std::size_t t = first_thread; t < last_thread; ++t ) {
+                    for( std::size_t group = t; group < group_count; group += update_threads ) {
+                        const std::size_t row_first = block_last + group * group_size;
+                        const std::size_t row_last = std::min( row_first + group_size, size );
+                        for( std::size_t r = row_first; r < row_last; ++r ) {
+                            cholesky::update_row( a, block_first, block_last, r );
+                        }
+                    }
+                }
+            },
+            update_threads );
+    }
+    return true;
+}
+
+
+//! Solves a x = b using the factor computed by cholesky_factor.
+/*!
+ *  \param u The factor returned by cholesky_factor.
+ *  \param b On entry the driving vector. On exit the solution.
+ *  \param thread_count The maximum number of threads to use (zero means "all").
+ */
+template< typename FloatingType >
+void cholesky_solve( const Matrix<FloatingType> &u, FloatingType *b, unsigned thread_count = 0 )
+{
+    const std::size_t size = u.row_count( );
+
+    // Solve U^T y = b. Row i of U is column i of U^T, so this proceeds a column at a time.
+    for( std::size_t i = 0; i < size; ++i ) {
+        const FloatingType *u_row = u.get_row( i );
+        const FloatingType  y = ( b[i] /= u_row[i] );
+        for( std::size_t j = i + 1; j < size; ++j ) b[j] -= u_row[j] * y;
+    }
+
+    // Solve U x = y. The diagonal of U was checked by cholesky_factor so this can't fail.
+    upper_triangular_solve( size, 1, u.get_row( 0 ), size, b, 1, thread_count );
+}
+
+#endif
@@ -0,0 +1,605 @@
+/*!
+    \file   iterative_solvers.hpp
+    \brief  Preconditioned Krylov subspace solvers: CG, BiCGSTAB, and restarted GMRES.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    Gaussian elimination does O(n^3) work no matter what the matrix looks like. An iterative
+    solver only needs to multiply the matrix by vectors. If the matrix is sparse each
+    multiplication is cheap, and if the matrix is well conditioned (for example, diagonally
+    dominant) few iterations are needed. The solvers here never look inside the matrix; they
+    take an "operator," any function object op such that op( x, y ) computes y = A x. A
+    SparseMatrix can be used via sparse_operator.
+
+    + conjugate_gradient requires a symmetric positive definite matrix (and preconditioner).
+    + bicgstab and gmres work with general matrices. GMRES is restarted every
+      options.restart iterations to limit its memory use.
+
+    A preconditioner is any object with a method apply( r, z ) that computes z = inverse(M) r
+    for some M that approximates A. BiCGSTAB and GMRES use right preconditioning, so all three
+    solvers test the true (unpreconditioned) residual against the tolerance.
+*/
+
+#ifndef ITERATIVE_SOLVERS_HPP
+#define ITERATIVE_SOLVERS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "parallel_for.hpp"
+#include "sparse_matrix.hpp"
+
+//! Parameters controlling an iterative solve.
+struct IterativeOptions {
+    double      tolerance;       //!< Stop when ||b - Ax|| <= tolerance * ||b||.
+    std::size_t max_iterations;  //!< Stop after this many iterations even if not converged.
+    std::size_t restart;         //!< GMRES only: the number of iterations between restarts.
+    unsigned    thread_count;    //!< The maximum number of threads to use (zero means "all").
+
+    IterativeOptions( ) : tolerance( 1.0E-8 ), max_iterations( 1000 ), restart( 30 ), thread_count( 0 ) { }
+};
+
+
+//! Describes the outcome of an iterative solve.
+struct IterativeResult {
+    std::size_t iteration_count;
+    double      residual_norm;            //!< The final value of ||b - Ax|| / ||b||.
+    bool        converged;
+    double      operator_seconds;         //!< Time spent applying the operator.
+    double      preconditioner_seconds;   //!< Time spent applying the preconditioner.
+    double      vector_seconds;           //!< Time spent in vector operations (dot products, etc).
+};
+
+
+namespace iterative {
+
+    // Vectors shorter than this are processed with a single thread.
+    const std::size_t minimum_parallel_length = 128 * 1024;
+
+    //! Adds the time between its construction and destruction to a total.
+    class PhaseTimer {
+    public:
+        explicit PhaseTimer( double &phase_total )
+            : total( phase_total ), start_time( std::chrono::steady_clock::now( ) ) { }
+
+       ~PhaseTimer( )
+        {
+            std::chrono::duration< double > elapsed = std::chrono::steady_clock::now( ) - start_time;
+            total += elapsed.count( );
+        }
+
+    private:
+        double &total;
+        std::chrono::steady_clock::time_point start_time;
+    };
+
+
+    //! Applies body( first, last ) to subranges of [0, size), in parallel if size is large.
+    template< typename Function >
+    void for_ranges( std::size_t size, Function body, unsigned thread_count )
+    {
+        if( size < minimum_parallel_length ) {
+            body( 0, size );
+        }
+        else {
+            parallel_for_ranges( 0, size,
+                [&]( std::size_t first, std::size_t last, unsigned ) { body( first, last ); },
+                thread_count );
+        }
+    }
+
+
+    //! Returns x . y
+    template< typename FloatingType >
+    FloatingType dot( std::size_t size, const FloatingType *x, const FloatingType *y, unsigned thread_count )
+    {
+        if( size < minimum_parallel_length ) thread_count = 1;
+        if( thread_count == 0 ) thread_count = default_thread_count( );
+
+        std::vector< FloatingType > partial( thread_count, FloatingType( 0 ) );
+        parallel_for_ranges( 0, size,
+            [&]( std::size_t first, std::size_t last, unsigned thread_number )
+            {
+                FloatingType sum = 0;
+                for( std::size_t i = first; i < last; ++i ) sum += x[i] * y[i];
+                partial[thread_number] = sum;
+            },
+            thread_count );
+
+        FloatingType result = 0;
+        for( FloatingType value : partial ) result += value;
+        return result;
+    }
+
+
+    //! Returns the Euclidean norm of x.
+    template< typename FloatingType >
+    FloatingType norm( std::size_t size, const FloatingType *x, unsigned thread_count )
+    {
+        return std::sqrt( dot( size, x, x, thread_count ) );
+    }
+
+
+    //! Computes r = b - A x and returns ||r||.
+    template< typename Operator, typename FloatingType >
+    FloatingType residual(
+        Operator &op, std::size_t size, const FloatingType *b, const FloatingType *x, FloatingType *r,
+        unsigned thread_count, IterativeResult &result )
+    {
+        {
+            PhaseTimer timer( result.operator_seconds );
+            op( x, r );
+        }
+        PhaseTimer timer( result.vector_seconds );
+        for_ranges( size,
+            [&]( std::size_t first, std::size_t last ) { for( std::size_t i = first; i < last; ++i ) r[i] = b[i] - r[i]; },
+            thread_count );
+        return norm( size, r, thread_count );
+    }
+
+
+    //! Prepares a result object and returns ||b||.
+    template< typename FloatingType >
+    FloatingType start( std::size_t size, const FloatingType *b, unsigned thread_count, IterativeResult &result )
+    {
+        result.iteration_count = 0;
+        result.residual_norm = 0.0;
+        result.converged = false;
+        result.operator_seconds = 0.0;
+        result.preconditioner_seconds = 0.0;
+        result.vector_seconds = 0.0;
+        return norm( size, b, thread_count );
+    }
+
+
+    //! Records the true final residual in the result.
+    template< typename Operator, typename FloatingType >
+    void finish(
+        Operator &op, std::size_t size, const FloatingType *b, const FloatingType *x, FloatingType b_norm,
+        double tolerance, unsigned thread_count, IterativeResult &result )
+    {
+        std::vector< FloatingType > r( size );
+        FloatingType r_norm = residual( op, size, b, x, r.data( ), thread_count, result );
+        result.residual_norm = ( b_norm > 0 ) ? r_norm / b_norm : r_norm;
+        result.converged = result.residual_norm <= tolerance;
+    }
+
+}
+
+
+//! A preconditioner that does nothing.
+template< typename FloatingType >
+class IdentityPreconditioner {
+public:
+    explicit IdentityPreconditioner( std::size_t size ) : n( size ) { }
+
+    void apply( const FloatingType *r, FloatingType *z ) const { std::copy( r, r + n, z ); }
+
+private:
+    std::size_t n;
+};
+
+
+//! The Jacobi (diagonal) preconditioner: M is the diagonal of A.
+template< typename FloatingType >
+class JacobiPreconditioner {
+public:
+    //! Extracts the diagonal of a. Zero diagonal elements are replaced by one.
+    explicit JacobiPreconditioner( const SparseMatrix<FloatingType> &a, unsigned thread_count = 0 );
+
+    void apply( const FloatingType *r, FloatingType *z ) const;
+
+private:
+    std::vector< FloatingType > inverse_diagonal;
+    unsigned threads;
+};
+
+
+template< typename FloatingType >
+JacobiPreconditioner<FloatingType>::JacobiPreconditioner( const SparseMatrix<FloatingType> &a, unsigned thread_count )
+    : inverse_diagonal( a.row_count( ), FloatingType( 1 ) ), threads( thread_count )
+{
+    for( std::size_t i = 0; i < a.row_count( ); ++i ) {
+        for( std::size_t k = a.row_start( )[i]; k < a.row_start( )[i + 1]; ++k ) {
+            if( a.column_index( )[k] == i && a.values( )[k] != FloatingType( 0 ) ) {
+                inverse_diagonal[i] = FloatingType( 1 ) / a.values( )[k];
+            }
+        }
+    }
+}
+
+
+template< typename FloatingType >
+void JacobiPreconditioner<FloatingType>::apply( const FloatingType *r, FloatingType *z ) const
+{
+    iterative::for_ranges( inverse_diagonal.size( ),
+        [&]( std::size_t first, std::size_t last )
+        {
+            for( std::size_t i = first; i < last; ++i ) z[i] = inverse_diagonal[i] * r[i];
+        },
+        threads );
+}
+
+
+//! The incomplete LU preconditioner with no fill in: M = L U where L and U have the same
+//! sparsity pattern as the lower and upper parts of A.
+/*!
+ *  Applying this preconditioner requires two sparse triangular solves, which are inherently
+ *  sequential, so it is applied with a single thread. It usually reduces the number of
+ *  iterations enough to more than make up for that.
+ */
+template< typename FloatingType >
+class ILU0Preconditioner {
+public:
+    //! Computes the incomplete factorization of a.
+    explicit ILU0Preconditioner( const SparseMatrix<FloatingType> &a );
+
+    //! Returns false if a diagonal element was missing or became zero during the factorization.
+    bool is_valid( ) const { return valid; }
+
+    void apply( const FloatingType *r, FloatingType *z ) const;
+
+private:
+    std::size_t n;
+    std::vector< std::size_t >  starts;
+    std::vector< std::size_t >  columns;
+    std::vector< FloatingType > factors;    // L (strictly lower, unit diagonal) and U together.
+    std::vector< std::size_t >  diagonal;   // Position of the diagonal element of each row.
+    bool valid;
+};
+
+
+template< typename FloatingType >
+ILU0Preconditioner<FloatingType>::ILU0Preconditioner( const SparseMatrix<FloatingType> &a )
+    : n( a.row_count( ) ),
+      starts( a.row_start( ), a.row_start( ) + n + 1 ),
+      columns( a.column_index( ), a.column_index( ) + a.element_count( ) ),
+      factors( a.values( ), a.values( ) + a.element_count( ) ),
+      diagonal( n ),
+      valid( true )
+{
+    // Locate the diagonal elements.
+    for( std::size_t i = 0; i < n; ++i ) {
+        const std::size_t *row_first = &columns[0] + starts[i];
+        const std::size_t *row_last  = &columns[0] + starts[i + 1];
+        const std::size_t *position = std::lower_bound( row_first, row_last, i );
+        if( position == row_last || *position != i ) {
+            valid = false;
+            return;
+        }
+        diagonal[i] = position - &columns[0];
+    }
+
+    // Row by row (the IKJ variant of Gaussian elimination) keeping only existing elements.
+    std::vector< std::size_t > where( n, 0 );   // where[j] = position of (i, j) + 1, or zero.
+    for( std::size_t i = 0; i < n; ++i ) {
+        for( std::size_t k = starts[i]; k < starts[i + 1]; ++k ) where[columns[k]] = k + 1;
+
+        for( std::size_t k = starts[i]; k < diagonal[i]; ++k ) {
+            const std::size_t j = columns[k];
+            const FloatingType pivot = factors[diagonal[j]];
+            if( pivot == FloatingType( 0 ) ) {
+                valid = false;
+                return;
+            }
+            const FloatingType factor = ( factors[k] /= pivot );
+            for( std::size_t p = diagonal[j] + 1; p < starts[j + 1]; ++p ) {
+                if( where[columns[p]] != 0 ) factors[where[columns[p]] - 1] -= factor * factors[p];
+            }
+        }
+
+        for( std::size_t k = starts[i]; k < starts[i + 1]; ++k ) where[columns[k]] = 0;
+    }
+    for( std::size_t i = 0; i < n; ++i ) {
+        if( factors[diagonal[i]] == FloatingType( 0 ) ) valid = false;
+    }
+}
+
+
+template< typename FloatingType >
+void ILU0Preconditioner<FloatingType>::apply( const FloatingType *r, FloatingType *z ) const
+{
+    // Solve L y = r.
+    for( std::size_t i = 0; i < n; ++i ) {
+        FloatingType sum = r[i];
+        for( std::size_t k = starts[i]; k < diagonal[i]; ++k ) sum -= factors[k] * z[columns[k]];
+        z[i] = sum;
+    }
+
+    // Solve U z = y.
+    for( std::size_t i = n; i > 0; --i ) {
+        const std::size_t row = i - 1;
+        FloatingType sum = z[row];
+        for( std::size_t k = diagonal[row] + 1; k < starts[row + 1]; ++k ) sum -= factors[k] * z[columns[k]];
+        z[row] = sum / factors[diagonal[row]];
+    }
+}
+
+
+//! Returns an operator that multiplies by a sparse matrix.
+template< typename FloatingType >
+auto sparse_operator( const SparseMatrix<FloatingType> &a, unsigned thread_count = 0 )
+{
+    return [&a, thread_count]( const FloatingType *x, FloatingType *y ) { a.multiply( x, y, thread_count ); };
+}
+
+
+//! Solves A x = b using the preconditioned conjugate gradient method.
+/*!
+ *  A and the preconditioner must be symmetric positive definite.
+ *
+ *  \param x On entry the initial guess (zero is fine). On exit the approximate solution.
+ *  \return true if the solver converged.
+ */
+template< typename Operator, typename Preconditioner, typename FloatingType >
+bool conjugate_gradient(
+    Operator &op, const Preconditioner &preconditioner, std::size_t size, const FloatingType *b, FloatingType *x,
+    const IterativeOptions &options, IterativeResult &result )
+{
+    using iterative::PhaseTimer;
+    const unsigned threads = options.thread_count;
+    std::vector< FloatingType > r( size ), z( size ), p( size ), q( size );
+
+    const FloatingType b_norm = iterative::start( size, b, threads, result );
+    FloatingType r_norm = iterative::residual( op, size, b, x, r.data( ), threads, result );
+    if( r_norm <= options.tolerance * b_norm ) {
+        iterative::finish( op, size, b, x, b_norm, options.tolerance, threads, result );
+        return result.converged;
+    }
+
+    {
+        PhaseTimer timer( result.preconditioner_seconds );
+        preconditioner.apply( r.data( ), z.data( ) );
+    }
+    p = z;
+    FloatingType rz = iterative::dot( size, r.data( ), z.data( ), threads );
+
+    while( result.iteration_count < options.max_iterations ) {
+        ++result.iteration_count;
+        {
+            PhaseTimer timer( result.operator_seconds );
+            op( p.data( ), q.data( ) );
+        }
+        {
+            PhaseTimer timer( result.vector_seconds );
+            const FloatingType alpha = rz / iterative::dot( size, p.data( ), q.data( ), threads );
+            iterative::for_ranges( size,
+                [&]( std::size_t first, std::size_t last )
+                {
+                    for( std::size_t i = first; i < last; ++i ) {
+                        x[i] += alpha * p[i];
+                        r[i] -= alpha * q[i];
+                    }
+                },
+                threads );
+            r_norm = iterative::norm( size, r.data( ), threads );
+        }
+        if( r_norm <= options.tolerance * b_norm ) break;
+        {
+            PhaseTimer timer( result.preconditioner_seconds );
+            preconditioner.apply( r.data( ), z.data( ) );
+        }
+        {
+            PhaseTimer timer( result.vector_seconds );
+            const FloatingType rz_next = iterative::dot( size, r.data( ), z.data( ), threads );
+            const FloatingType beta = rz_next / rz;
+            rz = rz_next;
+            iterative::for_ranges( size,
+                [&]( std::size_t first, std::size_t last )
+                {
+                    for( std::size_t i = first; i < last; ++i ) p[i] = z[i] + beta * p[i];
+                },
+                threads );
+        }
+    }
+
+    iterative::finish( op, size, b, x, b_norm, options.tolerance, threads, result );
+    return result.converged;
+}
+
+
+//! Solves A x = b using the (right) preconditioned BiCGSTAB method.
+/*!
+ *  \param x On entry the initial guess (zero is fine). On exit the approximate solution.
+ *  \return true if the solver converged.
+ */
+template< typename Operator, typename Preconditioner, typename FloatingType >
+bool bicgstab(
+    Operator &op, const Preconditioner &preconditioner, std::size_t size, const FloatingType *b, FloatingType *x,
+    const IterativeOptions &options, IterativeResult &result )
+{
+    using iterative::PhaseTimer;
+    const unsigned threads = options.thread_count;
+    std::vector< FloatingType > r( size ), r_hat( size ), p( size, 0 ), v( size, 0 );
+    std::vector< FloatingType > p_hat( size ), s( size ), s_hat( size ), t( size );
+
+    const FloatingType b_norm = iterative::start( size, b, threads, result );
+    FloatingType r_norm = iterative::residual( op, size, b, x, r.data( ), threads, result );
+    r_hat = r;
+    FloatingType rho = 1, alpha = 1, omega = 1;
+
+    while( r_norm > options.tolerance * b_norm && result.iteration_count < options.max_iterations ) {
+        ++result.iteration_count;
+        {
+            PhaseTimer timer( result.vector_seconds );
+            const FloatingType rho_next = iterative::dot( size, r_hat.data( ), r.data( ), threads );
+            if( rho_next == FloatingType( 0 ) ) break;   // Breakdown.
+            const FloatingType beta = ( rho_next / rho ) * ( alpha / omega );
+            rho = rho_next;
+            iterative::for_ranges( size,
+                [&]( std::size_t first, std::size_t last )
+                {
+                    for( std::size_t i = first; i < last; ++i ) p[i] = r[i] + beta * ( p[i] - omega * v[i] );
+                },
+                threads );
+        }
+        {
+            PhaseTimer timer( result.preconditioner_seconds );
+            preconditioner.apply( p.data( ), p_hat.data( ) );
+        }
+        {
+            PhaseTimer timer( result.operator_seconds );
+            op( p_hat.data( ), v.data( ) );
+        }
+        FloatingType s_norm;
+        {
+            PhaseTimer timer( result.vector_seconds );
+            alpha = rho / iterative::dot( size, r_hat.data( ), v.data( ), threads );
+            iterative::for_ranges( size,
+                [&]( std::size_t first, std::size_t last )
+                {
+                    for( std::size_t i = first; i < last; ++i ) s[i] = r[i] - alpha * v[i];
+                },
+                threads );
+            s_norm = iterative::norm( size, s.data( ), threads );
+        }
+        if( s_norm <= options.tolerance * b_norm ) {
+            PhaseTimer timer( result.vector_seconds );
+            for( std::size_t i = 0; i < size; ++i ) x[i] += alpha * p_hat[i];
+            break;
+        }
+        {
+            PhaseTimer timer( result.preconditioner_seconds );
+            preconditioner.apply( s.data( ), s_hat.data( ) );
+        }
+        {
+            PhaseTimer timer( result.operator_seconds );
+            op( s_hat.data( ), t.data( ) );
+        }
+        {
+            PhaseTimer timer( result.vector_seconds );
+            const FloatingType tt = iterative::dot( size, t.data( ), t.data( ), threads );
+            omega = ( tt != FloatingType( 0 ) ) ? iterative::dot( size, t.data( ), s.data( ), threads ) / tt : 0;
+            iterative::for_ranges( size,
+                [&]( std::size_t first, std::size_t last )
+                {
+                    for( std::size_t i = first; i < last; ++i ) {
+                        x[i] += alpha * p_hat[i] + omega * s_hat[i];
+                        r[i] = s[i] - omega * t[i];
+                    }
+                },
+                threads );
+            r_norm = iterative::norm( size, r.data( ), threads );
+        }
+        if( omega == FloatingType( 0 ) ) break;   // Breakdown.
+    }
+
+    iterative::finish( op, size, b, x, b_norm, options.tolerance, threads, result );
+    return result.converged;
+}
+
+
+//! Solves A x = b using the (right) preconditioned, restarted GMRES method.
+/*!
+ *  The Arnoldi process uses modified Gram-Schmidt and the least squares problem is solved
+ *  with Givens rotations.
+ *
+ *  \param x On entry the initial guess (zero is fine). On exit the approximate solution.
+ *  \return true if the solver converged.
+ */
+template< typename Operator, typename Preconditioner, typename FloatingType >
+bool gmres(
+    Operator &op, const Preconditioner &preconditioner, std::size_t size, const FloatingType *b, FloatingType *x,
+    const IterativeOptions &options, IterativeResult &result )
+{
+    using iterative::PhaseTimer;
+    const unsigned    threads = options.thread_count;
+    const std::size_t m = std::max< std::size_t >( 1, options.restart );
+
+    std::vector< std::vector< FloatingType > > basis( m + 1, std::vector< FloatingType >( size ) );
+    std::vector< FloatingType > h( ( m + 1 ) * m );   // Hessenberg matrix, h[i * m + j].
+    std::vector< FloatingType > cosines( m ), sines( m ), g( m + 1 ), y( m );
+    std::vector< FloatingType > w( size ), z( size );
+
+    const FloatingType b_norm = iterative::start( size, b, threads, result );
+
+    // The vector operations are interleaved with the other phases in complicated ways, so their
+    // time is taken to be whatever isn't spent applying the operator or the preconditioner.
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now( );
+
+    while( result.iteration_count < options.max_iterations ) {
+        const FloatingType beta = iterative::residual( op, size, b, x, basis[0].data( ), threads, result );
+        if( beta <= options.tolerance * b_norm ) break;
+
+        for( std::size_t i = 0; i < size; ++i ) basis[0][i] /= beta;
+        std::fill( g.begin( ), g.end( ), FloatingType( 0 ) );
+        g[0] = beta;
+
+        std::size_t j = 0;
+        while( j < m && result.iteration_count < options.max_iterations ) {
+            ++result.iteration_count;
+            {
+                PhaseTimer timer( result.preconditioner_seconds );
+                preconditioner.apply( basis[j].data( ), z.data( ) );
+            }
+            {
+                PhaseTimer timer( result.operator_seconds );
+                op( z.data( ), w.data( ) );
+            }
+
+            // Orthogonalize against the basis vectors so far.
+            for( std::size_t i = 0; i <= j; ++i ) {
+                const FloatingType coefficient = iterative::dot( size, w.data( ), basis[i].data( ), threads );
+                h[i * m + j] = coefficient;
+                const FloatingType *v = basis[i].data( );
+                iterative::for_ranges( size,
+                    [&]( std::size_t first, std::size_t last )
+                    {
+                        for( std::size_t k = first; k < last; ++k ) w[k] -= coefficient * v[k];
+                    },
+                    threads );
+            }
+            const FloatingType w_norm = iterative::norm( size, w.data( ), threads );
+            h[( j + 1 ) * m + j] = w_norm;
+            if( w_norm != FloatingType( 0 ) ) {
+                for( std::size_t k = 0; k < size; ++k ) basis[j + 1][k] = w[k] / w_norm;
+            }
+
+            // Apply the previous rotations to the new column, then compute a new rotation.
+            for( std::size_t i = 0; i < j; ++i ) {
+                const FloatingType upper = h[i * m + j];
+                const FloatingType lower = h[( i + 1 ) * m + j];
+                h[i * m + j]         =  cosines[i] * upper + sines[i] * lower;
+                h[( i + 1 ) * m + j] = -sines[i] * upper + cosines[i] * lower;
+            }
+            const FloatingType radius = std::hypot( h[j * m + j], h[( j + 1 ) * m + j] );
+            cosines[j] = ( radius != 0 ) ? h[j * m + j] / radius : 1;
+            sines[j] = ( radius != 0 ) ? h[( j + 1 ) * m + j] / radius : 0;
+            h[j * m + j] = radius;
+            h[( j + 1 ) * m + j] = 0;
+            g[j + 1] = -sines[j] * g[j];
+            g[j] = cosines[j] * g[j];
+
+            ++j;
+            if( std::abs( g[j] ) <= options.tolerance * b_norm || w_norm == FloatingType( 0 ) ) break;
+        }
+
+        // Solve the triangular system H y = g and update x with inverse(M) * (V y).
+        for( std::size_t i = j; i > 0; --i ) {
+            const std::size_t row = i - 1;
+            FloatingType sum = g[row];
+            for( std::size_t k = row + 1; k < j; ++k ) sum -= h[row * m + k] * y[k];
+            y[row] = ( h[row * m + row] != 0 ) ? sum / h[row * m + row] : 0;
+        }
+        std::fill( w.begin( ), w.end( ), FloatingType( 0 ) );
+        for( std::size_t i = 0; i < j; ++i ) {
+            const FloatingType coefficient = y[i];
+            const FloatingType *v = basis[i].data( );
+            for( std::size_t k = 0; k < size; ++k ) w[k] += coefficient * v[k];
+        }
+        {
+            PhaseTimer timer( result.preconditioner_seconds );
+            preconditioner.apply( w.data( ), z.data( ) );
+        }
+        for( std::size_t k = 0; k < size; ++k ) x[k] += z[k];
+        if( std::abs( g[j] ) <= options.tolerance * b_norm ) break;
+    }
+
+    std::chrono::duration< double > elapsed = std::chrono::steady_clock::now( ) - start_time;
+    result.vector_seconds = elapsed.count( ) - result.operator_seconds - result.preconditioner_seconds;
+    iterative::finish( op, size, b, x, b_norm, options.tolerance, threads, result );
+    return result.converged;
+}
+
+#endif
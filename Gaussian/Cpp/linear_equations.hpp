@@ -11,6 +11,8 @@
 #include <cmath>
 #include <boost/scoped_array.hpp>
 #include "Matrix.hpp"
+#include "../C/pivot_threshold.h"
+#include "../C/triangular_solve.h"
 
 //
 // The following function does the major work of reducing the system.
@@ -26,6 +28,7 @@ bool elimination( Matrix<FloatingType> &a, FloatingType *b )
     FloatingType max;
     FloatingType factor;
     boost::scoped_array< FloatingType > temp_array( new FloatingType[size] );
+    const double threshold = pivot_threshold( size, size, a.get_row( 0 ), size );
 
     // For each row (except the last one)...
     for( std::size_t i = 0; i < size - 1; ++i ) {
@@ -41,7 +44,7 @@ bool elimination( Matrix<FloatingType> &a, FloatingType *b )
         }
 
         // Check for |a(k, i)| zero.
-        if( std::abs( a(k, i) ) <= 1.0E-6 ) {
+        if( std::abs( a(k, i) ) <= threshold ) {
             return false;
         }
 
@@ -77,22 +80,9 @@ bool back_substitution( Matrix<FloatingType> &a, FloatingType *b )
     // Make sure we are dealing with a square matrix.
     assert( a.row_count( ) == a.col_count( ) );
 
-    std::size_t  size = a.row_count( );
-    FloatingType sum;
-
-    for(std::size_t index = 0; index <= size - 1; ++index ) {
-        std::size_t i = ( size - 1 ) - index;
-        if( std::abs( a(i, i) ) <= 1.0E-6 ) {
-            return false;
-        }
-
-        sum = b[i];
-        for( std::size_t j = i + 1; j < size; ++j ) {
-            sum -= a(i, j) * b[j];
-        }
-        b[i] = sum / a(i, i);
-    }
-    return true;
+    // This is the serial version so only one thread is used for the triangular solve also.
+    std::size_t size = a.row_count( );
+    return upper_triangular_solve( size, 1, a.get_row( 0 ), size, b, 1, 1 ) == 0;
 }
 
 
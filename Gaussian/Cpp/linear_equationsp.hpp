@@ -11,6 +11,9 @@
 #include <cmath>
 #include <boost/scoped_array.hpp>
 #include "Matrix.hpp"
+#include "parallel_for.hpp"
+#include "../C/pivot_threshold.h"
+#include "../C/triangular_solve.h"
 #include "ThreadPool.hpp"
 
 // The following structure gathers together parameters needed by the row processor. The
@@ -25,6 +28,8 @@ struct RowProcessorParameters {
     std::size_t size;   // The size of the system (not the number of rows to process!).
     Matrix<FloatingType> *a;  // Points at the matrix of coefficients.
     FloatingType         *b;  // Points at the driving vector.
+    FloatingType pivot_value; // Set to the largest |a(j, i + 1)| among the processed rows...
+    std::size_t  pivot_row;   // ... and the row where it was found (size if there were none).
 };
 
 
@@ -41,12 +46,22 @@ void row_processor( RowProcessorParameters<FloatingType> *row_set )
 
     FloatingType factor;
 
+    // Look for the next pivot among the freshly updated rows (ties go to the first row).
+    FloatingType pivot_value = -1;
+    std::size_t  pivot_row = row_set->size;
+
     // Subtract multiples of row i from subsequent rows.
     for( std::size_t j = row_set->start; j < row_set->end; ++j ) {
         factor = a(j, i)/a(i, i);
         for( std::size_t k = 0; k < row_set->size; ++k ) a(j, k) -= factor * a(i, k);
         b[j] -= factor * b[i];
+        if( std::abs( a(j, i + 1) ) > pivot_value ) {
+            pivot_value = std::abs( a(j, i + 1) );
+            pivot_row = j;
+        }
     }
+    row_set->pivot_value = pivot_value;
+    row_set->pivot_row = pivot_row;
 }
 
 
@@ -64,31 +79,49 @@ bool elimination( Matrix<FloatingType> &a, FloatingType *b )
     // to keep the thread pool out of that function.
     //
     spica::ThreadPool threads;
+
+    // GAUSSIAN_THREADS (see parallel_for.hpp) can limit how many of the pool's threads are used.
+    const int worker_count = std::min( threads.count( ), static_cast<int>( default_thread_count( ) ) );
     boost::scoped_array< RowProcessorParameters<FloatingType> >
-        parameters_array( new RowProcessorParameters<FloatingType>[ threads.count( ) ] );
+        parameters_array( new RowProcessorParameters<FloatingType>[ worker_count ] );
     boost::scoped_array< spica::ThreadPool::threadid_t >
-        threadID_array( new spica::ThreadPool::threadid_t[ threads.count( ) ] );
+        threadID_array( new spica::ThreadPool::threadid_t[ worker_count ] );
 
     std::size_t  size = a.row_count( );
     FloatingType temp;
     FloatingType max;
     boost::scoped_array< FloatingType > temp_array( new FloatingType[size] );
+    const double threshold = pivot_threshold( size, size, a.get_row( 0 ), size );
 
     // For each row (except the last one)...
     for( std::size_t i = 0; i < size - 1; ++i ) {
 
-        // Find the row with the largest value of |a(j, i)|, j = i, ..., n - 1
+        // Find the row with the largest value of |a(j, i)|, j = i, ..., n - 1. After the first
+        // pass each thread has already found the largest value among its rows while updating
+        // them. The threads' rows are in order, so taking the first of equal candidates gives
+        // the same pivot as a full search.
         std::size_t k = i;
         max = std::abs( a(i, i) );
-        for( std::size_t j = i + 1; j < size; ++j ) {
-            if( std::abs( a(j, i) ) > max ) {
-                k = j;
-                max = std::abs( a(j, i) );
+        if( i == 0 ) {
+            for( std::size_t j = i + 1; j < size; ++j ) {
+                if( std::abs( a(j, i) ) > max ) {
+                    k = j;
+                    max = std::abs( a(j, i) );
+                }
+            }
+        }
+        else {
+            max = -1;
+            for( int thread_number = 0; thread_number < worker_count; ++thread_number ) {
+                if( parameters_array[thread_number].pivot_value > max ) {
+                    k = parameters_array[thread_number].pivot_row;
+                    max = parameters_array[thread_number].pivot_value;
+                }
             }
         }
 
         // Check for |a(k, i)| zero.
-        if( std::abs( a(k, i) ) <= 1.0E-6 ) {
+        if( std::abs( a(k, i) ) <= threshold ) {
             return false;
         }
 
@@ -105,12 +138,12 @@ bool elimination( Matrix<FloatingType> &a, FloatingType *b )
         }
 
         // Prepare threads to handle rows i + 1 .. size - 1. Each thread handles a subrange of rows.
-        for( int thread_number = 0; thread_number < threads.count( ); ++thread_number ) {
+        for( int thread_number = 0; thread_number < worker_count; ++thread_number ) {
 
-            std::size_t rows_per_thread = (size - i - 1) / threads.count( );
+            std::size_t rows_per_thread = (size - i - 1) / worker_count;
             parameters_array[thread_number].i = i;
             parameters_array[thread_number].start = i + 1 + ( thread_number * rows_per_thread );
-            if( thread_number == threads.count( ) - 1 )
+            if( thread_number == worker_count - 1 )
                 parameters_array[thread_number].end = size;
             else
                 parameters_array[thread_number].end = i + 1 + ( (thread_number + 1) * rows_per_thread );
@@ -120,13 +153,13 @@ bool elimination( Matrix<FloatingType> &a, FloatingType *b )
         }
 
         // Start the threads.
-        for( int thread_number = 0; thread_number < threads.count( ); ++thread_number ) {
+        for( int thread_number = 0; thread_number < worker_count; ++thread_number ) {
             threadID_array[thread_number] =
                 threads.start_work( row_processor<FloatingType>, &parameters_array[thread_number] );
         }
 
         // Wait for the threads to finish.
-        for( int thread_number = 0; thread_number < threads.count( ); ++thread_number ) {
+        for( int thread_number = 0; thread_number < worker_count; ++thread_number ) {
             threads.work_result( threadID_array[thread_number] );
         }
     }
@@ -143,22 +176,9 @@ bool back_substitution( Matrix<FloatingType> &a, FloatingType *b )
     // Make sure we are dealing with a square matrix.
     assert( a.row_count( ) == a.col_count( ) );
 
-    std::size_t  size = a.row_count( );
-    FloatingType sum;
-
-    for(std::size_t index = 0; index <= size - 1; ++index ) {
-        std::size_t i = ( size - 1 ) - index;
-        if( std::abs( a(i, i) ) <= 1.0E-6 ) {
-            return false;
-        }
-
-        sum = b[i];
-        for( std::size_t j = i + 1; j < size; ++j ) {
-            sum -= a(i, j) * b[j];
-        }
-        b[i] = sum / a(i, i);
-    }
-    return true;
+    // The blocked triangular solver divides the row updates among all processors.
+    std::size_t size = a.row_count( );
+    return upper_triangular_solve( size, 1, a.get_row( 0 ), size, b, 1, 0 ) == 0;
 }
 
 
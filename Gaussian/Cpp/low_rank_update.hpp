@@ -0,0 +1,289 @@
+/*!
+    \file   low_rank_update.hpp
+    \brief  An LU factorization that can be updated cheaply when the matrix changes slightly.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    When a matrix changes by a low rank update A' = A + U V^T (for example when a few rows or
+    columns are replaced) the factors of A can still be used to solve A' x = b. The Sherman-
+    Morrison-Woodbury formula gives
+
+        (A + U V^T)^-1 = A^-1 - Z (I + V^T Z)^-1 V^T A^-1     where Z = A^-1 U.
+
+    If U and V have k columns, computing Z takes k triangular solves (O(k n^2) operations) and
+    the "capacitance" matrix I + V^T Z is only k x k. Each solve then costs two extra
+    products with n x k matrices and a small k x k solve, compared to O(n^3) operations to
+    refactor.
+
+    Successive updates are accumulated, so the extra cost per solve grows with the total rank
+    of the updates. The object keeps a running total of the work spent on updates (including
+    the extra work in each solve) since the last factorization. When that total plus the cost
+    of the next update would exceed the cost of a fresh factorization, the matrix is refactored
+    instead. This never spends more than about twice what the best possible choice would have.
+
+    Several threads may call solve at the same time. The other member functions must not be
+    called while a solve is in progress.
+*/
+
+#ifndef LOW_RANK_UPDATE_HPP
+#define LOW_RANK_UPDATE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "lu_decomposition.hpp"
+#include "Matrix.hpp"
+#include "parallel_for.hpp"
+
+//! An LU factorization of a matrix that is modified by low rank updates.
+template< typename FloatingType >
+class UpdatableLU {
+public:
+    //! Factors a. Use is_valid( ) to check that the factorization succeeded.
+    /*!
+     *  \param thread_count The maximum number of threads to use (zero means "all").
+     */
+    explicit UpdatableLU( const Matrix<FloatingType> &a, unsigned thread_count = 0 );
+
+    //! Uses factors of a that were already computed by lu_factor rather than factoring it again.
+    /*!
+     *  \param a The matrix.
+     *  \param lu The factors of a from a successful call of lu_factor.
+     *  \param lu_pivots The pivots from the same call.
+     *  \param thread_count The maximum number of threads to use (zero means "all").
+     */
+    UpdatableLU(
+        const Matrix<FloatingType> &a, const Matrix<FloatingType> &lu, const std::size_t *lu_pivots, unsigned thread_count = 0 );
+
+    //! Returns true if the matrix is factored (that is, it is not singular).
+    bool is_valid( ) const { return valid; }
+
+    //! Replaces the matrix a with a + u v^T.
+    /*!
+     *  \param u The n x rank matrix U in row-major order.
+     *  \param v The n x rank matrix V in row-major order.
+     *  \param rank The number of columns in U and V.
+     *  \return false if the updated matrix is (nearly) singular. In that case is_valid( ) will
+     *  return false until a later update makes the matrix non-singular.
+     */
+    bool update( const FloatingType *u, const FloatingType *v, std::size_t rank );
+
+    //! Replaces row i of the matrix. This is a rank one update.
+    bool replace_row( std::size_t i, const FloatingType *row );
+
+    //! Replaces column j of the matrix. This is a rank one update.
+    bool replace_column( std::size_t j, const FloatingType *column );
+
+    //! Solves a x = b for the current matrix. On entry b is the driving vector; on exit the solution.
+    void solve( FloatingType *b ) const;
+
+    //! Returns the current matrix.
+    const Matrix<FloatingType> &matrix( ) const { return current; }
+
+    //! Returns the total rank of the updates applied since the last factorization.
+    std::size_t accumulated_rank( ) const { return rank_total; }
+
+    //! Returns the number of factorizations done, including the initial one (even if it was supplied).
+    std::size_t factorization_count( ) const { return factorizations; }
+
+private:
+    std::size_t size;
+    unsigned    thread_count;
+    bool        valid;
+
+    Matrix<FloatingType> current;                 // The matrix with all updates applied.
+    Matrix<FloatingType> factors;                 // LU factors of the matrix as of the last factorization.
+    std::vector< std::size_t > pivots;
+    std::size_t factorizations;
+
+    // The accumulated updates. Column j of Z (and V) is stored at z[j * size] (and v[j * size]).
+    std::size_t rank_total;
+    std::vector< FloatingType > z;
+    std::vector< FloatingType > v;
+    std::vector< FloatingType > v_t_z;                        // V^T Z (rank_total x rank_total).
+    std::unique_ptr< Matrix<FloatingType> > capacitance;      // LU factors of I + V^T Z.
+    std::vector< std::size_t > capacitance_pivots;
+
+    // Multiply-add operations spent on the updates since the last factorization.
+    double update_work;
+
+    // Solves done since the last update. Their extra work is added to update_work by the next
+    // update; only the count is kept here so that solve doesn't modify anything else.
+    mutable std::atomic< std::size_t > solve_count;
+
+    bool refactor( );
+};
+
+
+template< typename FloatingType >
+UpdatableLU<FloatingType>::UpdatableLU( const Matrix<FloatingType> &a, unsigned threads )
+    : size( a.row_count( ) ), thread_count( threads ), valid( false ), current( a ), factors( a ),
+      pivots( a.row_count( ) ), factorizations( 0 ), rank_total( 0 ), update_work( 0.0 ), solve_count( 0 )
+{
+    refactor( );
+}
+
+
+template< typename FloatingType >
+UpdatableLU<FloatingType>::UpdatableLU(
+    const Matrix<FloatingType> &a, const Matrix<FloatingType> &lu, const std::size_t *lu_pivots, unsigned threads )
+    : size( a.row_count( ) ), thread_count( threads ), valid( true ), current( a ), factors( lu ),
+      pivots( lu_pivots, lu_pivots + a.row_count( ) ), factorizations( 1 ), rank_total( 0 ), update_work( 0.0 ),
+      solve_count( 0 )
+{ }
+
+
+//
+// Factors the current matrix and discards the accumulated updates.
+//
+template< typename FloatingType >
+bool UpdatableLU<FloatingType>::refactor( )
+{
+    factors = current;
+    valid = lu_factor( factors, pivots.data( ), thread_count );
+    ++factorizations;
+
+    rank_total = 0;
+    z.clear( );
+    v.clear( );
+    v_t_z.clear( );
+    capacitance.reset( );
+    update_work = 0.0;
+    solve_count = 0;
+    return valid;
+}
+
+
+template< typename FloatingType >
+bool UpdatableLU<FloatingType>::update( const FloatingType *u, const FloatingType *v_update, std::size_t rank )
+{
+    const double n = static_cast<double>( size );
+    const double k = static_cast<double>( rank );
+    const double r = static_cast<double>( rank_total );
+
+    // Each solve since the last update did 2 n r + r^2 extra work with the updates so far.
+    update_work += static_cast<double>( solve_count.exchange( 0 ) ) * ( 2.0 * n * r + r * r );
+
+    // Apply the update to the matrix itself. This is needed for any later factorization.
+    parallel_for_ranges( 0, size,
+        [&]( std::size_t first, std::size_t last, unsigned )
+        {
+            for( std::size_t i = first; i < last; ++i ) {
+                FloatingType *row = current.get_row( i );
+                for( std::size_t p = 0; p < rank; ++p ) {
+                    const FloatingType factor = u[i * rank + p];
+                    if( factor == FloatingType( 0 ) ) continue;
+                    for( std::size_t j = 0; j < size; ++j ) row[j] += factor * v_update[j * rank + p];
+                }
+            }
+        },
+        thread_count );
+
+    // Decide whether to use the Woodbury formula or start over. The update costs k solves with
+    // the factors, the new parts of V^T Z, and the factorization of the capacitance matrix.
+    const double factor_work = n * n * n / 3.0;
+    const double woodbury_work = k * n * n + n * k * ( 2.0 * r + k ) + ( r + k ) * ( r + k ) * ( r + k ) / 3.0;
+    if( !valid || update_work + woodbury_work > factor_work ) return refactor( );
+
+    // Z_new = A^-1 U. The solver works on row-major right hand sides.
+    std::vector< FloatingType > solutions( u, u + size * rank );
+    lu_solve( factors, pivots.data( ), solutions.data( ), rank, thread_count );
+    z.resize( size * ( rank_total + rank ) );
+    v.resize( size * ( rank_total + rank ) );
+    for( std::size_t p = 0; p < rank; ++p ) {
+        FloatingType *z_column = &z[( rank_total + p ) * size];
+        FloatingType *v_column = &v[( rank_total + p ) * size];
+        for( std::size_t i = 0; i < size; ++i ) {
+            z_column[i] = solutions[i * rank + p];
+            v_column[i] = v_update[i * rank + p];
+        }
+    }
+
+    // Extend V^T Z with the new rows and columns.
+    const std::size_t new_rank = rank_total + rank;
+    std::vector< FloatingType > extended( new_rank * new_rank );
+    parallel_for( 0, new_rank,
+        [&]( std::size_t i )
+        {
+            for( std::size_t j = 0; j < new_rank; ++j ) {
+                if( i < rank_total && j < rank_total ) {
+                    extended[i * new_rank + j] = v_t_z[i * rank_total + j];
+                    continue;
+                }
+                const FloatingType *v_column = &v[i * size];
+                const FloatingType *z_column = &z[j * size];
+                FloatingType sum = 0;
+                for( std::size_t e = 0; e < size; ++e ) sum += v_column[e] * z_column[e];
+                extended[i * new_rank + j] = sum;
+            }
+        },
+        thread_count );
+    v_t_z.swap( extended );
+    rank_total = new_rank;
+
+    // Factor the capacitance matrix I + V^T Z. If it is singular the update can't be
+    // expressed this way (or the updated matrix is singular) so try a full factorization.
+    capacitance.reset( new Matrix<FloatingType>( rank_total, rank_total ) );
+    for( std::size_t i = 0; i < rank_total; ++i ) {
+        for( std::size_t j = 0; j < rank_total; ++j ) {
+            ( *capacitance )( i, j ) = v_t_z[i * rank_total + j] + ( i == j ? FloatingType( 1 ) : FloatingType( 0 ) );
+        }
+    }
+    capacitance_pivots.resize( rank_total );
+    if( !lu_factor( *capacitance, capacitance_pivots.data( ), 1 ) ) return refactor( );
+
+    update_work += woodbury_work;
+    return true;
+}
+
+
+template< typename FloatingType >
+bool UpdatableLU<FloatingType>::replace_row( std::size_t i, const FloatingType *row )
+{
+    std::vector< FloatingType > u( size, FloatingType( 0 ) );
+    std::vector< FloatingType > difference( size );
+    u[i] = 1;
+    const FloatingType *old_row = current.get_row( i );
+    for( std::size_t j = 0; j < size; ++j ) difference[j] = row[j] - old_row[j];
+    return update( u.data( ), difference.data( ), 1 );
+}
+
+
+template< typename FloatingType >
+bool UpdatableLU<FloatingType>::replace_column( std::size_t j, const FloatingType *column )
+{
+    std::vector< FloatingType > difference( size );
+    std::vector< FloatingType > v_column( size, FloatingType( 0 ) );
+    v_column[j] = 1;
+    for( std::size_t i = 0; i < size; ++i ) difference[i] = column[i] - current( i, j );
+    return update( difference.data( ), v_column.data( ), 1 );
+}
+
+
+template< typename FloatingType >
+void UpdatableLU<FloatingType>::solve( FloatingType *b ) const
+{
+    // y = A^-1 b using the factors of the original matrix.
+    lu_solve( factors, pivots.data( ), b, 1, thread_count );
+    if( rank_total == 0 ) return;
+
+    // x = y - Z (I + V^T Z)^-1 V^T y.
+    std::vector< FloatingType > t( rank_total );
+    for( std::size_t p = 0; p < rank_total; ++p ) {
+        const FloatingType *v_column = &v[p * size];
+        FloatingType sum = 0;
+        for( std::size_t i = 0; i < size; ++i ) sum += v_column[i] * b[i];
+        t[p] = sum;
+    }
+    lu_solve( *capacitance, capacitance_pivots.data( ), t.data( ), 1, 1 );
+    for( std::size_t p = 0; p < rank_total; ++p ) {
+        const FloatingType *z_column = &z[p * size];
+        const FloatingType  factor = t[p];
+        for( std::size_t i = 0; i < size; ++i ) b[i] -= factor * z_column[i];
+    }
+
+    // The extra work counts against the updates when deciding whether to refactor.
+    solve_count.fetch_add( 1, std::memory_order_relaxed );
+}
+
+#endif
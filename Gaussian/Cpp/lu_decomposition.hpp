@@ -0,0 +1,218 @@
+/*!
+    \file   lu_decomposition.hpp
+    \brief  A blocked, parallel LU decomposition with partial pivoting.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    Unlike gaussian_solve, which consumes the driving vector as it eliminates, the functions
+    here keep the factors so that the same system can be solved for many driving vectors. This
+    is needed, for example, when doing iterative refinement.
+
+    The decomposition is "right looking." A panel of columns is factored using ordinary partial
+    pivoting, and then the trailing part of the matrix is updated using the panel. The trailing
+    update is a matrix-matrix multiplication and is where almost all the time goes; it is done
+    in parallel with each thread updating a different set of columns.
+*/
+
+#ifndef LU_DECOMPOSITION_HPP
+#define LU_DECOMPOSITION_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include "Matrix.hpp"
+#include "../C/pivot_threshold.h"
+#include "../C/triangular_solve.h"
+#include "parallel_for.hpp"
+
+namespace lu {
+
+    // Number of columns in each panel.
+    const std::size_t panel_width = 64;
+
+    // Width of the column strips used in the trailing update. The strip of U used in the update
+    // is panel_width x strip_width and should fit comfortably into the L2 cache.
+    const std::size_t strip_width = 256;
+
+    //! Exchanges two rows of the matrix.
+    template< typename FloatingType >
+    void swap_rows( Matrix<FloatingType> &a, std::size_t row_1, std::size_t row_2 )
+    {
+        FloatingType *first = a.get_row( row_1 );
+        std::swap_ranges( first, first + a.col_count( ), a.get_row( row_2 ) );
+    }
+
+
+    //! Factors the panel of columns [first_column, last_column) using partial pivoting.
+    /*!
+     *  Entire rows are exchanged so that columns to the left and right of the panel see the
+     *  same row ordering. Only rows first_column .. n - 1 are considered.
+     *
+     *  \param threshold The pivot_threshold of the original matrix.
+     *  \return false if a pivot is too small.
+     */
+    template< typename FloatingType >
+    bool factor_panel(
+        Matrix<FloatingType> &a,
+        std::size_t *pivots,
+        std::size_t first_column,
+        std::size_t last_column,
+        double threshold )
+    {
+        const std::size_t size = a.row_count( );
+
+        for( std::size_t i = first_column; i < last_column; ++i ) {
+
+            // Find the row with the largest value of |a(j, i)|, j = i, ..., n - 1
+            std::size_t k = i;
+            FloatingType max = std::abs( a(i, i) );
+            for( std::size_t j = i + 1; j < size; ++j ) {
+                if( std::abs( a(j, i) ) > max ) {
+                    k = j;
+                    max = std::abs( a(j, i) );
+                }
+            }
+            if( max <= threshold ) return false;
+
+            pivots[i] = k;
+            if( k != i ) swap_rows( a, i, k );
+
+            // Compute the multipliers and update the rest of the panel.
+            const FloatingType *pivot_row = a.get_row( i );
+            const FloatingType  inverse = FloatingType( 1 ) / pivot_row[i];
+            for( std::size_t j = i + 1; j < size; ++j ) {
+                FloatingType *row = a.get_row( j );
+                const FloatingType factor = ( row[i] *= inverse );
+                for( std::size_t c = i + 1; c < last_column; ++c ) {
+                    row[c] -= factor * pivot_row[c];
+                }
+            }
+        }
+        return true;
+    }
+
+
+    //! Updates the columns [first, last) to the right of a factored panel.
+    /*!
+     *  The rows of the panel are first transformed into rows of U by applying the inverse of
+     *  the (unit) lower triangular diagonal block. The rows beneath the panel are then updated
+     *  with a(j, c) -= L(j, p) * U(p, c). Only columns in [first, last) are touched so distinct
+     *  column ranges can be updated concurrently.
+     */
+    template< typename FloatingType >
+    void update_columns(
+        Matrix<FloatingType> &a,
+        std::size_t panel_first,
+        std::size_t panel_last,
+        std::size_t first,
+        std::size_t last )
+    {
+        const std::size_t size = a.row_count( );
+
+        for( std::size_t strip_first = first; strip_first < last; strip_first += strip_width ) {
+            const std::size_t strip_last = std::min( strip_first + strip_width, last );
+
+            // U12 = inverse(L11) * A12.
+            for( std::size_t i = panel_first; i < panel_last; ++i ) {
+                const FloatingType *source = a.get_row( i );
+                for( std::size_t j = i + 1; j < panel_last; ++j ) {
+                    FloatingType *row = a.get_row( j );
+                    const FloatingType factor = row[i];
+                    for( std::size_t c = strip_first; c < strip_last; ++c ) {
+                        row[c] -= factor * source[c];
+                    }
+                }
+            }
+
+            // A22 -= L21 * U12.
+            for( std::size_t j = panel_last; j < size; ++j ) {
+                FloatingType *row = a.get_row( j );
+                for( std::size_t p = panel_first; p < panel_last; ++p ) {
+                    const FloatingType  factor = row[p];
+                    const FloatingType *source = a.get_row( p );
+                    for( std::size_t c = strip_first; c < strip_last; ++c ) {
+                        row[c] -= factor * source[c];
+                    }
+                }
+            }
+        }
+    }
+
+}
+
+
+//! Factors a in place so that P*a = L*U.
+/*!
+ *  On return the strictly lower part of a holds L (which has an implicit unit diagonal) and the
+ *  upper part holds U. At step i row i was exchanged with row pivots[i] (where pivots[i] >= i).
+ *  If this function fails a is left in a partially factored state.
+ *
+ *  \param pivots Points at an array with space for a.row_count( ) elements.
+ *  \param thread_count The maximum number of threads to use (zero means "all").
+ *  \return true if the factorization succeeded; false if the matrix is (nearly) singular.
+ */
+template< typename FloatingType >
+bool lu_factor( Matrix<FloatingType> &a, std::size_t *pivots, unsigned thread_count = 0 )
+{
+    // Make sure we are dealing with a square matrix.
+    assert( a.row_count( ) == a.col_count( ) );
+
+    const std::size_t size = a.row_count( );
+    if( thread_count == 0 ) thread_count = default_thread_count( );
+    const double threshold = pivot_threshold( size, size, a.get_row( 0 ), size );
+
+    for( std::size_t panel_first = 0; panel_first < size; panel_first += lu::panel_width ) {
+        const std::size_t panel_last = std::min( panel_first + lu::panel_width, size );
+
+        if( !lu::factor_panel( a, pivots, panel_first, panel_last, threshold ) ) return false;
+
+        // Give each thread at least one strip of the trailing columns.
+        const std::size_t trailing_columns = size - panel_last;
+        const std::size_t strip_count = ( trailing_columns + lu::strip_width - 1 ) / lu::strip_width;
+        const unsigned    threads = static_cast<unsigned>( std::min< std::size_t >( thread_count, strip_count ) );
+
+        parallel_for_ranges( panel_last, size,
+            [&]( std::size_t first, std::size_t last, unsigned )
+            {
+                lu::update_columns( a, panel_first, panel_last, first, last );
+            },
+            threads );
+    }
+    return true;
+}
+
+
+//! Solves a X = B using the factors computed by lu_factor.
+/*!
+ *  The right hand sides are the columns of B, which is stored in row-major order. The blocked
+ *  triangular solvers are used so that many right hand sides can be solved together.
+ *
+ *  \param lu The factors returned by lu_factor.
+ *  \param pivots The pivots returned by lu_factor.
+ *  \param x On entry the right hand sides B (size x rhs_count). On exit the solutions X.
+ *  \param rhs_count The number of right hand sides.
+ *  \param thread_count The maximum number of threads to use (zero means "all").
+ */
+template< typename FloatingType >
+void lu_solve(
+    const Matrix<FloatingType> &lu,
+    const std::size_t          *pivots,
+    FloatingType               *x,
+    std::size_t                 rhs_count = 1,
+    unsigned                    thread_count = 0 )
+{
+    const std::size_t size = lu.row_count( );
+
+    // Apply the row exchanges in the order they were made during the factorization.
+    for( std::size_t i = 0; i < size; ++i ) {
+        if( pivots[i] != i ) {
+            std::swap_ranges( &x[i * rhs_count], &x[( i + 1 ) * rhs_count], &x[pivots[i] * rhs_count] );
+        }
+    }
+
+    // The diagonal of U was checked by lu_factor so the upper solve can't fail.
+    unit_lower_triangular_solve( size, rhs_count, lu.get_row( 0 ), size, x, rhs_count, thread_count );
+    upper_triangular_solve( size, rhs_count, lu.get_row( 0 ), size, x, rhs_count, thread_count );
+}
+
+#endif
@@ -0,0 +1,486 @@
+/*!
+    \file   out_of_core.hpp
+    \brief  An LU decomposition for systems too large to fit in memory.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    The other solvers in this folder hold the entire matrix of coefficients in memory. That
+    limits the size of the systems they can handle: a 100,000 x 100,000 system of doubles needs
+    80 GB. The solver here keeps the matrix in a scratch file, divided into panels of adjacent
+    columns, and holds only three panels in memory at any time. The panel width is chosen so that
+    those three panels fit within a given memory budget.
+
+    The factorization is "left looking." To factor panel k, panel k is read and then updated
+    with each of the previously factored panels 0 .. k - 1 in turn. Only then is panel k itself
+    factored (with partial pivoting) and written back to the scratch file. Each panel is written
+    once, but read many times. To hide the cost of those reads, the next panel needed is read in
+    the background while the current one is being used.
+
+    The row exchanges made while factoring a panel are not applied to the panels on its left.
+    Instead the forward substitution applies the exchanges panel by panel, as they were made
+    (the way LINPACK did it). Thus the panels never need to be rewritten.
+
+    This file requires POSIX (for pread and pwrite).
+*/
+
+#ifndef OUT_OF_CORE_HPP
+#define OUT_OF_CORE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstddef>
+#include <future>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "Matrix.hpp"
+#include "lu_decomposition.hpp"
+#include "parallel_for.hpp"
+#include "system_loader.hpp"
+
+//! A temporary file accessed by explicit offsets.
+/*!
+ *  The file is removed from the file system as soon as it is created so that it disappears when
+ *  the object is destroyed (or the program terminates), even abnormally. Reads and writes at
+ *  different offsets may be done concurrently.
+ */
+class ScratchFile {
+public:
+    //! Creates an empty scratch file in the given directory.
+    explicit ScratchFile( const char *directory );
+   ~ScratchFile( );
+
+    // Scratch files can't be copied.
+    ScratchFile( const ScratchFile & ) = delete;
+    ScratchFile &operator=( const ScratchFile & ) = delete;
+
+    //! Returns true if the file was created successfully.
+    bool is_open( ) const { return descriptor != -1; }
+
+    //! Reads count bytes at the given offset. Returns false if an error occurs.
+    bool read( std::size_t offset, void *buffer, std::size_t count ) const;
+
+    //! Writes count bytes at the given offset. Returns false if an error occurs.
+    bool write( std::size_t offset, const void *buffer, std::size_t count );
+
+private:
+    int descriptor;
+};
+
+
+inline ScratchFile::ScratchFile( const char *directory )
+    : descriptor( -1 )
+{
+    std::string name( directory );
+    name += "/gaussian-XXXXXX";
+    std::vector< char > name_buffer( name.begin( ), name.end( ) );
+    name_buffer.push_back( '\0' );
+
+    descriptor = mkstemp( name_buffer.data( ) );
+    if( descriptor != -1 ) unlink( name_buffer.data( ) );
+}
+
+
+inline ScratchFile::~ScratchFile( )
+{
+    if( descriptor != -1 ) close( descriptor );
+}
+
+
+inline bool ScratchFile::read( std::size_t offset, void *buffer, std::size_t count ) const
+{
+    char *current = static_cast<char *>( buffer );
+    while( count > 0 ) {
+        ssize_t result = pread( descriptor, current, count, static_cast<off_t>( offset ) );
+        if( result <= 0 ) return false;
+        current += result;
+        offset  += result;
+        count   -= result;
+    }
+    return true;
+}
+
+
+inline bool ScratchFile::write( std::size_t offset, const void *buffer, std::size_t count )
+{
+    const char *current = static_cast<const char *>( buffer );
+    while( count > 0 ) {
+        ssize_t result = pwrite( descriptor, current, count, static_cast<off_t>( offset ) );
+        if( result <= 0 ) return false;
+        current += result;
+        offset  += result;
+        count   -= result;
+    }
+    return true;
+}
+
+
+//! Solves a system of equations that is stored on disk rather than in memory.
+/*!
+ *  Typical use is to construct the solver with the system size and a memory budget, load( )
+ *  the system, factor( ) it, and then solve( ) for the driving vector. Panel k holds columns
+ *  [k * w, min( (k + 1) * w, n )) of every row and is stored in row-major order.
+ */
+template< typename FloatingType >
+class OutOfCoreLU {
+public:
+    //! Prepares to solve a size x size system.
+    /*!
+     *  \param system_size The number of equations.
+     *  \param memory_budget The approximate number of bytes of memory to use for the matrix.
+     *  \param scratch_directory Where to put the (large) scratch file.
+     */
+    OutOfCoreLU( std::size_t system_size, std::size_t memory_budget, const char *scratch_directory );
+
+    //! Returns true if the scratch file was created successfully.
+    bool is_open( ) const { return store.is_open( ); }
+
+    //! Reads the system from the input file, storing the driving vector in b.
+    bool load( SystemReader &input_file, FloatingType *b, unsigned thread_count = 0 );
+
+    //! Factors the system. Returns false if the matrix is (nearly) singular or if an I/O error occurs.
+    bool factor( unsigned thread_count = 0 );
+
+    //! Overwrites b with the solution of the system. Returns false if an I/O error occurs.
+    bool solve( FloatingType *b, unsigned thread_count = 0 );
+
+    //! Returns the number of columns in each panel.
+    std::size_t panel_width( ) const { return width; }
+
+    //! Returns the number of bytes read from the scratch file so far.
+    std::size_t bytes_read( ) const { return read_count; }
+
+    //! Returns the number of bytes written to the scratch file so far.
+    std::size_t bytes_written( ) const { return write_count; }
+
+    //! Returns the time, in seconds, spent waiting for reads that were not overlapped with computation.
+    double read_wait_time( ) const { return wait_seconds; }
+
+private:
+    std::size_t size;
+    std::size_t width;
+    std::size_t panel_count;
+    ScratchFile store;
+    std::vector< std::size_t > pivots;
+    double      threshold;   // The pivot_threshold of the matrix, found by load( ).
+
+    // The panel being factored and the two buffers used to stream the other panels.
+    std::vector< FloatingType > target;
+    std::vector< FloatingType > buffers[2];
+
+    std::size_t read_count;
+    std::size_t write_count;
+    double      wait_seconds;
+
+    struct Step {
+        std::size_t panel;
+        bool        is_target;   // True if this is the panel being factored.
+        bool        is_last;     // True if this is the last panel used for the current target.
+    };
+
+    std::size_t first_column( std::size_t panel ) const { return panel * width; }
+    std::size_t columns( std::size_t panel ) const { return std::min( width, size - panel * width ); }
+    std::size_t offset( std::size_t panel ) const { return first_column( panel ) * size * sizeof( FloatingType ); }
+
+    void allocate_buffers( );
+
+    template< typename Function >
+    bool stream_panels( const std::vector< Step > &steps, Function process );
+
+    void apply_panel( std::size_t panel, const FloatingType *source, std::size_t target_panel, unsigned thread_count );
+    bool factor_target( std::size_t panel );
+};
+
+
+template< typename FloatingType >
+OutOfCoreLU<FloatingType>::OutOfCoreLU( std::size_t system_size, std::size_t memory_budget, const char *scratch_directory )
+    : size( system_size ), store( scratch_directory ), pivots( system_size ), threshold( 0.0 ),
+      read_count( 0 ), write_count( 0 ), wait_seconds( 0.0 )
+{
+    width = memory_budget / ( 3 * size * sizeof( FloatingType ) );
+    width = std::max< std::size_t >( 1, std::min( width, size ) );
+    panel_count = ( size + width - 1 ) / width;
+}
+
+
+//
+// The panel buffers are allocated only when needed so that load( ) can use the memory instead.
+//
+template< typename FloatingType >
+void OutOfCoreLU<FloatingType>::allocate_buffers( )
+{
+    target.resize( size * width );
+    buffers[0].resize( size * width );
+    buffers[1].resize( size * width );
+}
+
+
+template< typename FloatingType >
+bool OutOfCoreLU<FloatingType>::load( SystemReader &input_file, FloatingType *b, unsigned thread_count )
+{
+    // Read blocks of whole rows and scatter each block over the panels. The rows and the
+    // staging area for one panel must together fit in the space used by three panels.
+    std::size_t block_rows = ( 3 * size * width ) / ( size + width );
+    block_rows = std::max< std::size_t >( 1, std::min( block_rows, size ) );
+    std::vector< FloatingType > staging( block_rows * width );
+
+    for( std::size_t row_first = 0; row_first < size; row_first += block_rows ) {
+        const std::size_t row_count = std::min( block_rows, size - row_first );
+        Matrix<FloatingType> rows( row_count, size );
+        if( !input_file.read_rows( rows, &b[row_first], thread_count ) ) return false;
+        threshold = std::max( threshold, pivot_threshold( row_count, size, rows.get_row( 0 ), size ) );
+
+        for( std::size_t panel = 0; panel < panel_count; ++panel ) {
+            const std::size_t panel_columns = columns( panel );
+            for( std::size_t r = 0; r < row_count; ++r ) {
+                std::copy( &rows( r, first_column( panel ) ), &rows( r, first_column( panel ) ) + panel_columns,
+                           &staging[r * panel_columns] );
+            }
+            const std::size_t byte_count = row_count * panel_columns * sizeof( FloatingType );
+            if( !store.write( offset( panel ) + row_first * panel_columns * sizeof( FloatingType ),
+                              staging.data( ), byte_count ) ) return false;
+            write_count += byte_count;
+        }
+    }
+    return true;
+}
+
+
+//
+// Reads the panels listed in steps, in order, and calls process( step, buffer ) for each. While
+// one panel is being processed the next is read in the background. The process function may
+// swap the contents of the buffer with another buffer of the same size.
+//
+template< typename FloatingType >
+template< typename Function >
+bool OutOfCoreLU<FloatingType>::stream_panels( const std::vector< Step > &steps, Function process )
+{
+    auto start_read = [this]( std::size_t panel, std::vector< FloatingType > &buffer )
+    {
+        const std::size_t byte_count = size * columns( panel ) * sizeof( FloatingType );
+        read_count += byte_count;
+        return std::async( std::launch::async,
+            [this, panel, byte_count, &buffer]( ) { return store.read( offset( panel ), buffer.data( ), byte_count ); } );
+    };
+
+    if( steps.empty( ) ) return true;
+    std::future< bool > pending = start_read( steps[0].panel, buffers[0] );
+
+    for( std::size_t i = 0; i < steps.size( ); ++i ) {
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now( );
+        bool success = pending.get( );
+        std::chrono::duration< double > elapsed = std::chrono::steady_clock::now( ) - start_time;
+        wait_seconds += elapsed.count( );
+
+        // The buffers alternate, so the next read never overwrites the panel being processed.
+        if( success && i + 1 < steps.size( ) ) pending = start_read( steps[i + 1].panel, buffers[( i + 1 ) % 2] );
+        if( !success || !process( steps[i], buffers[i % 2] ) ) {
+            if( pending.valid( ) ) pending.wait( );
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//
+// Updates the target panel using the factored panel in source. This is the left looking
+// equivalent of one step of a right looking factorization restricted to the target's columns.
+//
+template< typename FloatingType >
+void OutOfCoreLU<FloatingType>::apply_panel(
+    std::size_t panel, const FloatingType *source, std::size_t target_panel, unsigned thread_count )
+{
+    const std::size_t source_first = first_column( panel );
+    const std::size_t source_columns = columns( panel );
+    const std::size_t source_last = source_first + source_columns;
+    const std::size_t target_columns = columns( target_panel );
+    FloatingType *t = target.data( );
+
+    // Apply the row exchanges made while factoring the source panel.
+    for( std::size_t i = source_first; i < source_last; ++i ) {
+        if( pivots[i] != i ) {
+            std::swap_ranges( &t[i * target_columns], &t[( i + 1 ) * target_columns], &t[pivots[i] * target_columns] );
+        }
+    }
+
+    // U = inverse(L11) * A for the rows of the source panel's diagonal block.
+    for( std::size_t i = source_first; i < source_last; ++i ) {
+        const FloatingType *u_row = &t[i * target_columns];
+        for( std::size_t r = i + 1; r < source_last; ++r ) {
+            const FloatingType factor = source[r * source_columns + ( i - source_first )];
+            FloatingType *row = &t[r * target_columns];
+            for( std::size_t c = 0; c < target_columns; ++c ) row[c] -= factor * u_row[c];
+        }
+    }
+
+    // A -= L21 * U for the rows below the diagonal block.
+    parallel_for_ranges( source_last, size,
+        [&]( std::size_t first, std::size_t last, unsigned )
+        {
+            for( std::size_t r = first; r < last; ++r ) {
+                const FloatingType *l_row = &source[r * source_columns];
+                FloatingType *row = &t[r * target_columns];
+                for( std::size_t p = 0; p < source_columns; ++p ) {
+                    const FloatingType  factor = l_row[p];
+                    const FloatingType *u_row = &t[( source_first + p ) * target_columns];
+                    for( std::size_t c = 0; c < target_columns; ++c ) row[c] -= factor * u_row[c];
+                }
+            }
+        },
+        thread_count );
+}
+
+
+//
+// Factors the (fully updated) target panel with partial pivoting and writes it to the store.
+//
+template< typename FloatingType >
+bool OutOfCoreLU<FloatingType>::factor_target( std::size_t panel )
+{
+    const std::size_t panel_first = first_column( panel );
+    const std::size_t panel_columns = columns( panel );
+    FloatingType *t = target.data( );
+
+    for( std::size_t c = 0; c < panel_columns; ++c ) {
+        const std::size_t i = panel_first + c;
+
+        // Find the row with the largest value of |a(j, i)|, j = i, ..., n - 1
+        std::size_t k = i;
+        FloatingType max = std::abs( t[i * panel_columns + c] );
+        for( std::size_t j = i + 1; j < size; ++j ) {
+            if( std::abs( t[j * panel_columns + c] ) > max ) {
+                k = j;
+                max = std::abs( t[j * panel_columns + c] );
+            }
+        }
+        if( max <= threshold ) return false;
+
+        pivots[i] = k;
+        if( k != i ) {
+            std::swap_ranges( &t[i * panel_columns], &t[( i + 1 ) * panel_columns], &t[k * panel_columns] );
+        }
+
+        const FloatingType *pivot_row = &t[i * panel_columns];
+        const FloatingType  inverse = FloatingType( 1 ) / pivot_row[c];
+        for( std::size_t j = i + 1; j < size; ++j ) {
+            FloatingType *row = &t[j * panel_columns];
+            const FloatingType factor = ( row[c] *= inverse );
+            for( std::size_t d = c + 1; d < panel_columns; ++d ) {
+                row[d] -= factor * pivot_row[d];
+            }
+        }
+    }
+
+    const std::size_t byte_count = size * panel_columns * sizeof( FloatingType );
+    write_count += byte_count;
+    return store.write( offset( panel ), t, byte_count );
+}
+
+
+template< typename FloatingType >
+bool OutOfCoreLU<FloatingType>::factor( unsigned thread_count )
+{
+    if( thread_count == 0 ) thread_count = default_thread_count( );
+    allocate_buffers( );
+
+    // Panel k is read, then updated with panels 0 .. k - 1, then factored.
+    std::vector< Step > steps;
+    for( std::size_t k = 0; k < panel_count; ++k ) {
+        steps.push_back( Step{ k, true, k == 0 } );
+        for( std::size_t j = 0; j < k; ++j ) {
+            steps.push_back( Step{ j, false, j + 1 == k } );
+        }
+    }
+
+    std::size_t current = 0;
+    return stream_panels( steps,
+        [&]( const Step &step, std::vector< FloatingType > &buffer )
+        {
+            if( step.is_target ) {
+                current = step.panel;
+                target.swap( buffer );
+            }
+            else {
+                apply_panel( step.panel, buffer.data( ), current, thread_count );
+            }
+            return step.is_last ? factor_target( current ) : true;
+        } );
+}
+
+
+template< typename FloatingType >
+bool OutOfCoreLU<FloatingType>::solve( FloatingType *b, unsigned thread_count )
+{
+    if( thread_count == 0 ) thread_count = default_thread_count( );
+    allocate_buffers( );
+
+    std::vector< Step > forward;
+    std::vector< Step > backward;
+    for( std::size_t k = 0; k < panel_count; ++k ) {
+        forward.push_back( Step{ k, false, false } );
+        backward.push_back( Step{ panel_count - 1 - k, false, false } );
+    }
+
+    // Forward substitution (L y = P b), applying the row exchanges as they were made.
+    bool success = stream_panels( forward,
+        [&]( const Step &step, std::vector< FloatingType > &buffer )
+        {
+            const std::size_t panel_first = first_column( step.panel );
+            const std::size_t panel_columns = columns( step.panel );
+            const std::size_t panel_last = panel_first + panel_columns;
+            const FloatingType *l = buffer.data( );
+
+            for( std::size_t i = panel_first; i < panel_last; ++i ) {
+                if( pivots[i] != i ) std::swap( b[i], b[pivots[i]] );
+            }
+            for( std::size_t i = panel_first; i < panel_last; ++i ) {
+                for( std::size_t r = i + 1; r < panel_last; ++r ) {
+                    b[r] -= l[r * panel_columns + ( i - panel_first )] * b[i];
+                }
+            }
+            parallel_for_ranges( panel_last, size,
+                [&]( std::size_t first, std::size_t last, unsigned )
+                {
+                    for( std::size_t r = first; r < last; ++r ) {
+                        FloatingType sum = 0;
+                        for( std::size_t p = 0; p < panel_columns; ++p ) sum += l[r * panel_columns + p] * b[panel_first + p];
+                        b[r] -= sum;
+                    }
+                },
+                thread_count );
+            return true;
+        } );
+    if( !success ) return false;
+
+    // Back substitution (U x = y), one panel (column block) at a time from the right.
+    return stream_panels( backward,
+        [&]( const Step &step, std::vector< FloatingType > &buffer )
+        {
+            const std::size_t panel_first = first_column( step.panel );
+            const std::size_t panel_columns = columns( step.panel );
+            const FloatingType *u = buffer.data( );
+
+            for( std::size_t c = panel_columns; c > 0; --c ) {
+                const std::size_t i = panel_first + c - 1;
+                b[i] /= u[i * panel_columns + c - 1];
+                for( std::size_t r = panel_first; r < i; ++r ) {
+                    b[r] -= u[r * panel_columns + c - 1] * b[i];
+                }
+            }
+            parallel_for_ranges( 0, panel_first,
+                [&]( std::size_t first, std::size_t last, unsigned )
+                {
+                    for( std::size_t r = first; r < last; ++r ) {
+                        FloatingType sum = 0;
+                        for( std::size_t p = 0; p < panel_columns; ++p ) sum += u[r * panel_columns + p] * b[panel_first + p];
+                        b[r] -= sum;
+                    }
+                },
+                thread_count );
+            return true;
+        } );
+}
+
+#endif
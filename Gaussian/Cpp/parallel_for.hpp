@@ -0,0 +1,93 @@
+/*!
+    \file   parallel_for.hpp
+    \brief  A simple fork/join helper for data parallel loops.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    The solvers in this folder often need to split a range of rows (or chunks of a file) across
+    all the processors and then wait for every piece to finish before going on. The function
+    templates here do exactly that using std::thread. No attempt is made to keep threads alive
+    between calls; callers that invoke these functions in an inner loop should arrange for the
+    amount of work per call to swamp the thread creation overhead.
+*/
+
+#ifndef PARALLEL_FOR_HPP
+#define PARALLEL_FOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+//! Returns the number of threads to use when the caller doesn't specify a count.
+/*!
+ *  The environment variable GAUSSIAN_THREADS overrides the hardware concurrency, as it does for
+ *  the C solvers (see ../C/thread_count.h). If the level of hardware concurrency can't be
+ *  determined, a "reasonable" value of two is used instead.
+ */
+inline unsigned default_thread_count( )
+{
+    if( const char *setting = std::getenv( "GAUSSIAN_THREADS" ) ) {
+        int count = std::atoi( setting );
+        if( count > 0 ) return static_cast<unsigned>( count );
+    }
+    unsigned count = std::thread::hardware_concurrency( );
+    return ( count == 0 ) ? 2 : count;
+}
+
+
+//! Applies body( range_first, range_last, thread_number ) to contiguous subranges of [first, last).
+/*!
+ *  The range is split into at most thread_count subranges of nearly equal size (the sizes
+ *  differ by at most one). The calling thread processes the last subrange itself so only
+ *  thread_count - 1 additional threads are created. This function returns after all subranges
+ *  have been processed. The body must not throw.
+ *
+ *  \param thread_count The maximum number of threads to use. Zero means use
+ *  default_thread_count( ).
+ */
+template< typename Function >
+void parallel_for_ranges( std::size_t first, std::size_t last, Function body, unsigned thread_count = 0 )
+{
+    if( last <= first ) return;
+    if( thread_count == 0 ) thread_count = default_thread_count( );
+
+    const std::size_t length = last - first;
+    const std::size_t range_count = std::min< std::size_t >( thread_count, length );
+    const std::size_t base_size = length / range_count;
+    const std::size_t remainder = length % range_count;
+
+    std::vector< std::thread > threads;
+    threads.reserve( range_count - 1 );
+
+    std::size_t range_first = first;
+    for( std::size_t range_number = 0; range_number < range_count; ++range_number ) {
+        std::size_t range_last = range_first + base_size + ( range_number < remainder ? 1 : 0 );
+        if( range_number == range_count - 1 ) {
+            body( range_first, range_last, static_cast<unsigned>( range_number ) );
+        }
+        else {
+            threads.emplace_back( body, range_first, range_last, static_cast<unsigned>( range_number ) );
+        }
+        range_first = range_last;
+    }
+
+    for( std::thread &worker : threads ) {
+        worker.join( );
+    }
+}
+
+
+//! Applies body( index ) to every index in [first, last) using up to thread_count threads.
+template< typename Function >
+void parallel_for( std::size_t first, std::size_t last, Function body, unsigned thread_count = 0 )
+{
+    parallel_for_ranges( first, last,
+        [&body]( std::size_t range_first, std::size_t range_last, unsigned )
+        {
+            for( std::size_t index = range_first; index < range_last; ++index ) body( index );
+        },
+        thread_count );
+}
+
+#endif
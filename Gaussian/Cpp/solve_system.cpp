@@ -5,65 +5,567 @@
 */
 
 #include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
-#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
 #include <Timer.hpp>
+#include "system_loader.hpp"
 
 // Select the serial or parallel version as desired...
 // #include "linear_equations.hpp"
 #include "linear_equationsp.hpp"
+#include "banded.hpp"
+#include "calu.hpp"
+#include "cholesky.hpp"
+#include "iterative_solvers.hpp"
+#include "low_rank_update.hpp"
+#include "mixed_precision.hpp"
+#include "out_of_core.hpp"
+#include "sparse_lu.hpp"
+#include "sparse_matrix.hpp"
+#include "system_structure.hpp"
+#include "tiled_lu.hpp"
 
 using namespace std;
 
-int main( int argc, char *argv[] )
+//
+// The following function reads the system and reports the conversion rate.
+//
+template< typename MatrixType, typename FloatingType >
+bool read_system( SystemReader &input_file, MatrixType &a, FloatingType *b )
 {
-    size_t size;
+    if( !input_file.read( a, b ) ) {
+        cout << "Error: Invalid or incomplete system definition file.\n";
+        return false;
+    }
+    cout << "Read " << input_file.byte_count( ) << " bytes in "
+         << std::fixed << std::setprecision(1) << input_file.read_time( ) * 1000.0 << " milliseconds using "
+         << input_file.threads_used( ) << " thread(s) (" << input_file.throughput( ) << " MB/s)\n";
+    return true;
+}
 
-    if( argc != 2 ) {
-        cout << "Error: Expected the name of a system definition file.\n";
-        return EXIT_FAILURE;
+
+template< typename FloatingType >
+void print_solution( size_t size, const FloatingType *x )
+{
+    cout << "\nSolution is\n";
+    for( size_t i = 0; i < size; ++i ) {
+        cout << " x(" << setw(4) << i << ") = "
+             << setw(9) << std::fixed << std::setprecision(5) << x[i] << "\n";
     }
+}
 
-    ifstream input_file( argv[1] );
-    if( !input_file ) {
-        printf("Error: Can not open the system definition file.\n");
-        return EXIT_FAILURE;
+
+//
+// Solve the system in single precision with gaussian_solve.
+//
+int solve_gaussian( SystemReader &input_file )
+{
+    size_t size = input_file.size( );
+
+    // Allocate the arrays.
+    Matrix<float> a( size, size );
+    boost::scoped_array<float> b( new float[size] );
+
+    // Get coefficients.
+    if( !read_system( input_file, a, b.get( ) ) ) return EXIT_FAILURE;
+
+    spica::Timer stopwatch;
+    stopwatch.start( );
+    bool success = gaussian_solve( a, b.get( ) );
+    stopwatch.stop( );
+
+    if( !success ) {
+        cout << "System is degenerate\n";
     }
+    else {
+        print_solution( size, b.get( ) );
+        cout << "\nExecution time = " << stopwatch.time( ) << " milliseconds\n";
+    }
+    return EXIT_SUCCESS;
+}
+
+
+//
+// Solve the system with a single precision factorization and double precision refinement.
+//
+int solve_refined( SystemReader &input_file )
+{
+    size_t size = input_file.size( );
+
+    // Allocate the arrays.
+    Matrix<double> a( size, size );
+    boost::scoped_array<double> b( new double[size] );
+    boost::scoped_array<double> x( new double[size] );
+
+    // Get coefficients.
+    if( !read_system( input_file, a, b.get( ) ) ) return EXIT_FAILURE;
+
+    RefinementResult result;
+    spica::Timer stopwatch;
+    stopwatch.start( );
+    bool success = mixed_precision_solve( a, b.get( ), x.get( ), result );
+    stopwatch.stop( );
+
+    if( !success ) {
+        cout << "System is degenerate\n";
+    }
+    else {
+        print_solution( size, x.get( ) );
+        cout << "\nRefinement steps = " << result.step_count
+             << ( result.converged ? "" : " (did not converge)" ) << "\n";
+        cout << "Final residual   = " << std::scientific << std::setprecision(3)
+             << result.residual_norm << " (||b - Ax|| / ||A|| ||x||)\n";
+        cout << "\nExecution time = " << stopwatch.time( ) << " milliseconds\n";
+    }
+    return EXIT_SUCCESS;
+}
+
 
-    // Get the size.
-    input_file >> size;
+//
+// Solve the system in single precision with the task scheduled tiled LU decomposition.
+//
+int solve_tiled( SystemReader &input_file )
+{
+    size_t size = input_file.size( );
 
     // Allocate the arrays.
     Matrix<float> a( size, size );
     boost::scoped_array<float> b( new float[size] );
+    boost::scoped_array<size_t> pivots( new size_t[size] );
 
     // Get coefficients.
-    for( size_t i = 0; i < size; ++i ) {
-        for( size_t j = 0; j < size; ++j ) {
-            input_file >> a(i, j);
-        }
-        input_file >> b[i];
+    if( !read_system( input_file, a, b.get( ) ) ) return EXIT_FAILURE;
+
+    spica::Timer stopwatch;
+    stopwatch.start( );
+    bool success = tiled_lu_factor( a, pivots.get( ) );
+    if( success ) lu_solve( a, pivots.get( ), b.get( ) );
+    stopwatch.stop( );
+
+    if( !success ) {
+        cout << "System is degenerate\n";
     }
-    input_file.close( );
+    else {
+        print_solution( size, b.get( ) );
+        cout << "\nExecution time = " << stopwatch.time( ) << " milliseconds\n";
+    }
+    return EXIT_SUCCESS;
+}
+
+
+//
+// Solve the system in single precision using LU decomposition with tournament pivoting.
+//
+int solve_calu( SystemReader &input_file )
+{
+    size_t size = input_file.size( );
+
+    // Allocate the arrays.
+    Matrix<float> a( size, size );
+    boost::scoped_array<float> b( new float[size] );
+    boost::scoped_array<size_t> pivots( new size_t[size] );
+
+    // Get coefficients.
+    if( !read_system( input_file, a, b.get( ) ) ) return EXIT_FAILURE;
 
     spica::Timer stopwatch;
     stopwatch.start( );
-    bool success = gaussian_solve( a, b.get( ) );
+    bool success = calu_factor( a, pivots.get( ) );
+    if( success ) lu_solve( a, pivots.get( ), b.get( ) );
     stopwatch.stop( );
 
     if( !success ) {
         cout << "System is degenerate\n";
     }
     else {
-        cout << "\nSolution is\n";
-        for( size_t i = 0; i < size; ++i ) {
-            cout << " x(" << setw(4) << i << ") = "
-                 << setw(9) << std::fixed << std::setprecision(5) << b[i] << "\n";
-        }
+        print_solution( size, b.get( ) );
+        cout << "\nExecution time = " << stopwatch.time( ) << " milliseconds\n";
+    }
+    return EXIT_SUCCESS;
+}
+
+
+//
+// Solve the system in double precision without holding the whole matrix in memory.
+//
+int solve_out_of_core( SystemReader &input_file, std::size_t memory_budget )
+{
+    size_t size = input_file.size( );
+
+    // The system is streamed through in panels of dense rows.
+    if( input_file.is_sparse( ) ) {
+        cout << "Error: The out-of-core solver needs a dense system; use -m sparse for this one.\n";
+        return EXIT_FAILURE;
+    }
+
+    OutOfCoreLU<double> solver( size, memory_budget, "." );
+    boost::scoped_array<double> b( new double[size] );
+    if( !solver.is_open( ) ) {
+        cout << "Error: Can not create the scratch file.\n";
+        return EXIT_FAILURE;
+    }
+
+    spica::Timer load_stopwatch;
+    load_stopwatch.start( );
+    bool loaded = solver.load( input_file, b.get( ) );
+    load_stopwatch.stop( );
+    if( !loaded ) {
+        cout << "Error: Invalid or incomplete system definition file.\n";
+        return EXIT_FAILURE;
+    }
+    cout << "Loaded " << size << " equations in " << load_stopwatch.time( ) << " milliseconds using panels of "
+         << solver.panel_width( ) << " column(s)\n";
 
+    spica::Timer stopwatch;
+    stopwatch.start( );
+    bool success = solver.factor( ) && solver.solve( b.get( ) );
+    stopwatch.stop( );
+
+    if( !success ) {
+        cout << "System is degenerate (or an I/O error occurred)\n";
+    }
+    else {
+        print_solution( size, b.get( ) );
+        cout << "\nScratch file traffic = " << solver.bytes_read( ) / 1000000 << " MB read, "
+             << solver.bytes_written( ) / 1000000 << " MB written\n";
+        cout << "Time waiting for reads = " << std::fixed << std::setprecision(1)
+             << solver.read_wait_time( ) * 1000.0 << " milliseconds\n";
         cout << "\nExecution time = " << stopwatch.time( ) << " milliseconds\n";
     }
+    return EXIT_SUCCESS;
+}
+
+//
+// Solve the system in double precision, then change it one row at a time and solve again using
+// the low rank update of the factors. Each change adds half of the next row to a row, which
+// keeps the matrix non-singular.
+//
+int solve_updated( SystemReader &input_file, std::size_t update_count )
+{
+    size_t size = input_file.size( );
+
+    // Allocate the arrays.
+    Matrix<double> a( size, size );
+    boost::scoped_array<double> b( new double[size] );
+    boost::scoped_array<double> x( new double[size] );
+    boost::scoped_array<double> r( new double[size] );
+    boost::scoped_array<double> row( new double[size] );
+    boost::scoped_array<size_t> pivots( new size_t[size] );
+
+    // Get coefficients.
+    if( !read_system( input_file, a, b.get( ) ) ) return EXIT_FAILURE;
+
+    spica::Timer stopwatch;
+    stopwatch.start( );
+    Matrix<double> factors( a );
+    bool success = lu_factor( factors, pivots.get( ) );
+    stopwatch.stop( );
+    if( !success ) {
+        cout << "System is degenerate\n";
+        return EXIT_SUCCESS;
+    }
+    UpdatableLU<double> lu( a, factors, pivots.get( ) );
+    for( size_t i = 0; i < size; ++i ) x[i] = b[i];
+    lu.solve( x.get( ) );
+    print_solution( size, x.get( ) );
+    cout << "\nFactor time = " << stopwatch.time( ) << " milliseconds\n";
+
+    spica::Timer update_stopwatch;
+    size_t updates_done = 0;
+    update_stopwatch.start( );
+    for( ; updates_done < update_count && size > 1; ++updates_done ) {
+        const size_t i = ( updates_done * 7919 ) % size;
+        const double *current_row = lu.matrix( ).get_row( i );
+        const double *next_row = lu.matrix( ).get_row( ( i + 1 ) % size );
+        for( size_t j = 0; j < size; ++j ) row[j] = current_row[j] + 0.5 * next_row[j];
+
+        success = lu.replace_row( i, row.get( ) );
+        if( !success ) break;
+        for( size_t k = 0; k < size; ++k ) x[k] = b[k];
+        lu.solve( x.get( ) );
+    }
+    update_stopwatch.stop( );
+
+    cout << "\nRow updates      = " << updates_done << ( success ? "" : " (the updated system is degenerate)" ) << "\n";
+    cout << "Refactorizations = " << lu.factorization_count( ) - 1 << "\n";
+    if( updates_done != 0 && success ) {
+        const double r_norm = mixed_precision::residual( lu.matrix( ), b.get( ), x.get( ), r.get( ), 0 );
+        const double scale = mixed_precision::matrix_norm( lu.matrix( ) ) * mixed_precision::vector_norm( x.get( ), size );
+        cout << "Final residual   = " << std::scientific << std::setprecision(3)
+             << ( scale > 0.0 ? r_norm / scale : r_norm ) << " (||b - Ax|| / ||A|| ||x||)\n";
+        cout << "\nUpdate time = " << update_stopwatch.time( ) << " milliseconds for " << updates_done
+             << " updates and solves\n";
+    }
+    return EXIT_SUCCESS;
+}
+
+
+//
+// Solve the system in single precision using the solver best suited to its structure. The mode
+// can also force the Cholesky or banded solvers. The structure scan is included in the time.
+//
+int solve_structured( SystemReader &input_file, const char *mode )
+{
+    size_t size = input_file.size( );
+    bool   automatic = std::strcmp( mode, "auto" ) == 0;
+
+    // Allocate the arrays.
+    Matrix<float> a( size, size );
+    boost::scoped_array<float> b( new float[size] );
+
+    // Get coefficients.
+    if( !read_system( input_file, a, b.get( ) ) ) return EXIT_FAILURE;
+
+    spica::Timer stopwatch;
+    stopwatch.start( );
+    SystemStructure structure = analyze_structure( a );
+    std::string path;
+    bool success = false;
+    bool solved = false;
+
+    if( std::strcmp( mode, "banded" ) == 0 || ( automatic && structure.is_banded( size ) ) ) {
+        std::ostringstream formatter;
+        formatter << "banded LU, bandwidths " << structure.lower_bandwidth << "/" << structure.upper_bandwidth;
+        path = formatter.str( );
+        BandMatrix<float> band( a, structure.lower_bandwidth, structure.upper_bandwidth );
+        success = banded_solve( band, b.get( ) );
+        solved = true;
+    }
+    else if( std::strcmp( mode, "cholesky" ) == 0 || ( automatic && structure.maybe_positive_definite( ) ) ) {
+        // Cholesky only modifies the upper triangle so the matrix can be restored from the lower
+        // triangle (and the saved diagonal) if it turns out not to be positive definite.
+        boost::scoped_array<float> diagonal( new float[size] );
+        for( size_t i = 0; i < size; ++i ) diagonal[i] = a(i, i);
+
+        if( structure.symmetric && cholesky_factor( a ) ) {
+            cholesky_solve( a, b.get( ) );
+            path = "Cholesky";
+            success = solved = true;
+        }
+        else if( automatic ) {
+            for( size_t i = 0; i < size; ++i ) {
+                a(i, i) = diagonal[i];
+                for( size_t j = i + 1; j < size; ++j ) a(i, j) = a(j, i);
+            }
+        }
+        else {
+            path = "Cholesky";
+            solved = true;
+        }
+    }
+    if( !solved ) {
+        path = "Gaussian elimination";
+        success = gaussian_solve( a, b.get( ) );
+    }
+    stopwatch.stop( );
+
+    if( !success ) {
+        if( path == "Cholesky" )
+            cout << "System is not symmetric positive definite\n";
+        else
+            cout << "System is degenerate\n";
+    }
+    else {
+        print_solution( size, b.get( ) );
+        cout << "\nExecution time = " << stopwatch.time( ) << " milliseconds (" << path << ")\n";
+    }
+    return EXIT_SUCCESS;
+}
+
+
+//
+// Run one of the iterative solvers with the given preconditioner.
+//
+template< typename Preconditioner >
+bool run_iterative(
+    const char *mode, const SparseMatrix<double> &a, const Preconditioner &preconditioner,
+    const double *b, double *x, const IterativeOptions &options, IterativeResult &result )
+{
+    auto op = sparse_operator( a, options.thread_count );
+    if( std::strcmp( mode, "cg" ) == 0 ) return conjugate_gradient( op, preconditioner, a.row_count( ), b, x, options, result );
+    if( std::strcmp( mode, "bicgstab" ) == 0 ) return bicgstab( op, preconditioner, a.row_count( ), b, x, options, result );
+    return gmres( op, preconditioner, a.row_count( ), b, x, options, result );
+}
+
+
+//
+// Solve the system in double precision with an iterative method (cg, bicgstab, or gmres).
+//
+int solve_iterative( SystemReader &input_file, const char *mode, const char *preconditioner, const IterativeOptions &options )
+{
+    size_t size = input_file.size( );
+
+    // Allocate the arrays.
+    boost::scoped_array<double> b( new double[size] );
+    boost::scoped_array<double> x( new double[size] );
+
+    // Get coefficients.
+    SparseMatrix<double> a;
+    if( !read_system( input_file, a, b.get( ) ) ) return EXIT_FAILURE;
+    for( size_t i = 0; i < size; ++i ) x[i] = 0.0;
+
+    spica::Timer stopwatch;
+    spica::Timer setup_stopwatch;
+    stopwatch.start( );
+    setup_stopwatch.start( );
+    std::unique_ptr< JacobiPreconditioner<double> > jacobi;
+    std::unique_ptr< ILU0Preconditioner<double> > ilu;
+    if( std::strcmp( preconditioner, "jacobi" ) == 0 ) {
+        jacobi.reset( new JacobiPreconditioner<double>( a, options.thread_count ) );
+    }
+    else if( std::strcmp( preconditioner, "ilu0" ) == 0 ) {
+        ilu.reset( new ILU0Preconditioner<double>( a ) );
+        if( !ilu->is_valid( ) ) {
+            cout << "Error: ILU(0) preconditioner can't be computed for this system.\n";
+            return EXIT_FAILURE;
+        }
+    }
+    else if( std::strcmp( preconditioner, "none" ) != 0 ) {
+        cout << "Error: Unknown preconditioner '" << preconditioner << "'\n";
+        return EXIT_FAILURE;
+    }
+    setup_stopwatch.stop( );
+
+    IterativeResult result;
+    if( jacobi )
+        run_iterative( mode, a, *jacobi, b.get( ), x.get( ), options, result );
+    else if( ilu )
+        run_iterative( mode, a, *ilu, b.get( ), x.get( ), options, result );
+    else
+        run_iterative( mode, a, IdentityPreconditioner<double>( size ), b.get( ), x.get( ), options, result );
+    stopwatch.stop( );
 
+    print_solution( size, x.get( ) );
+    cout << "\nIterations        = " << result.iteration_count
+         << ( result.converged ? "" : " (did not converge)" ) << "\n";
+    cout << "Relative residual = " << std::scientific << std::setprecision(3) << result.residual_norm << "\n";
+    cout << "Nonzero elements  = " << a.element_count( ) << "\n";
+    cout << std::fixed << std::setprecision(1);
+    cout << "\nSetup time          = " << setup_stopwatch.time( ) << " milliseconds\n";
+    cout << "Operator time       = " << result.operator_seconds * 1000.0 << " milliseconds\n";
+    cout << "Preconditioner time = " << result.preconditioner_seconds * 1000.0 << " milliseconds\n";
+    cout << "Vector time         = " << result.vector_seconds * 1000.0 << " milliseconds\n";
+    cout << "\nExecution time = " << stopwatch.time( ) << " milliseconds (" << mode << ", " << preconditioner << ")\n";
     return EXIT_SUCCESS;
 }
+
+
+//
+// Solve a sparse system in double precision with a sparse LU decomposition.
+//
+int solve_sparse( SystemReader &input_file )
+{
+    size_t size = input_file.size( );
+
+    // Allocate the arrays.
+    SparseMatrix<double> a;
+    boost::scoped_array<double> b( new double[size] );
+    boost::scoped_array<double> x( new double[size] );
+
+    // Get coefficients.
+    if( !read_system( input_file, a, b.get( ) ) ) return EXIT_FAILURE;
+
+    spica::Timer stopwatch;
+    spica::Timer analyze_stopwatch;
+    spica::Timer factor_stopwatch;
+    stopwatch.start( );
+    SparseLU<double> lu;
+    analyze_stopwatch.start( );
+    lu.analyze( a );
+    analyze_stopwatch.stop( );
+    factor_stopwatch.start( );
+    lu.factor( a );
+    factor_stopwatch.stop( );
+    for( size_t i = 0; i < size; ++i ) x[i] = b[i];
+    lu.solve( x.get( ) );
+    double residual = lu.refine( a, b.get( ), x.get( ) );
+    stopwatch.stop( );
+
+    print_solution( size, x.get( ) );
+    cout << "\nNonzero elements  = " << a.element_count( ) << "\n";
+    cout << "Factor elements   = " << lu.factor_element_count( ) << " in " << lu.supernode_count( ) << " supernodes\n";
+    cout << "Perturbed pivots  = " << lu.perturbed_pivot_count( ) << "\n";
+    cout << "Relative residual = " << std::scientific << std::setprecision(3) << residual << "\n";
+    cout << std::fixed << std::setprecision(1);
+    cout << "\nAnalysis time = " << analyze_stopwatch.time( ) << " milliseconds\n";
+    cout << "Factor time   = " << factor_stopwatch.time( ) << " milliseconds\n";
+    cout << "\nExecution time = " << stopwatch.time( ) << " milliseconds (sparse LU)\n";
+    return EXIT_SUCCESS;
+}
+
+
+int main( int argc, char *argv[] )
+{
+    const char *mode = "auto";
+    const char *file_name = 0;
+    std::size_t memory_budget = 1024;   // In megabytes; only used by the out-of-core solver.
+    const char *preconditioner = "jacobi";
+    std::size_t update_count = 16;      // Only used by the low rank update solver.
+    IterativeOptions options;
+
+    for( int i = 1; i < argc; ++i ) {
+        if( std::strcmp( argv[i], "-m" ) == 0 && i + 1 < argc ) {
+            mode = argv[++i];
+        }
+        else if( std::strcmp( argv[i], "-b" ) == 0 && i + 1 < argc ) {
+            memory_budget = std::strtoul( argv[++i], 0, 10 );
+        }
+        else if( std::strcmp( argv[i], "-p" ) == 0 && i + 1 < argc ) {
+            preconditioner = argv[++i];
+        }
+        else if( std::strcmp( argv[i], "-e" ) == 0 && i + 1 < argc ) {
+            options.tolerance = std::strtod( argv[++i], 0 );
+        }
+        else if( std::strcmp( argv[i], "-i" ) == 0 && i + 1 < argc ) {
+            options.max_iterations = std::strtoul( argv[++i], 0, 10 );
+        }
+        else if( std::strcmp( argv[i], "-u" ) == 0 && i + 1 < argc ) {
+            update_count = std::strtoul( argv[++i], 0, 10 );
+        }
+        else if( file_name == 0 ) {
+            file_name = argv[i];
+        }
+        else {
+            file_name = 0;
+            break;
+        }
+    }
+
+    if( file_name == 0 ) {
+        cout << "Error: Expected the name of a system definition file.\n";
+        cout << "Usage: " << argv[0] << " [-m mode] [-b megabytes] [-p preconditioner] [-e tolerance] [-i iterations] [-u updates] system-file\n";
+        cout << "  mode: auto, gaussian, cholesky, banded, refine, tiled, calu, out-of-core, sparse, cg, bicgstab, gmres, update\n";
+        cout << "  preconditioner (cg, bicgstab, gmres only): none, jacobi, ilu0\n";
+        return EXIT_FAILURE;
+    }
+
+    SystemReader input_file( file_name );
+    if( !input_file.is_open( ) ) {
+        printf("Error: Can not open the system definition file.\n");
+        return EXIT_FAILURE;
+    }
+
+    // A sparse system might be far too large to store as a dense matrix.
+    if( std::strcmp( mode, "sparse" ) == 0 ||
+        ( std::strcmp( mode, "auto" ) == 0 && input_file.is_sparse( ) ) ) return solve_sparse( input_file );
+    if( std::strcmp( mode, "auto" ) == 0 ||
+        std::strcmp( mode, "cholesky" ) == 0 ||
+        std::strcmp( mode, "banded" ) == 0 ) return solve_structured( input_file, mode );
+    if( std::strcmp( mode, "gaussian" ) == 0 ) return solve_gaussian( input_file );
+    if( std::strcmp( mode, "refine" ) == 0 ) return solve_refined( input_file );
+    if( std::strcmp( mode, "tiled" ) == 0 ) return solve_tiled( input_file );
+    if( std::strcmp( mode, "calu" ) == 0 ) return solve_calu( input_file );
+    if( std::strcmp( mode, "cg" ) == 0 ||
+        std::strcmp( mode, "bicgstab" ) == 0 ||
+        std::strcmp( mode, "gmres" ) == 0 ) return solve_iterative( input_file, mode, preconditioner, options );
+    if( std::strcmp( mode, "out-of-core" ) == 0 ) return solve_out_of_core( input_file, memory_budget * 1024 * 1024 );
+    if( std::strcmp( mode, "update" ) == 0 ) return solve_updated( input_file, update_count );
+
+    cout << "Error: Unknown solver mode '" << mode << "'\n";
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,842 @@
+/*!
+    \file   sparse_lu.hpp
+    \brief  A multithreaded, multifrontal LU decomposition for large sparse systems.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    Systems with hundreds of thousands of unknowns can't be stored as dense matrices, but if
+    they are sparse enough their LU factors can be. The amount of fill in (elements of the
+    factors that are zero in the matrix) depends enormously on the order of the unknowns, so the
+    solution proceeds in three steps.
+
+    1. Ordering. The unknowns are reordered by nested dissection of the graph of A + A^T: a
+       small set of vertices (a separator) whose removal splits the graph into two pieces is
+       numbered last, and the pieces are dissected recursively. Separators are found from the
+       middle level of a breadth first search started at a pseudo-peripheral vertex.
+
+    2. Symbolic factorization. The elimination tree of the reordered matrix is computed and
+       postordered, the structure of each column of L is found from the structures of its
+       children in the tree, and columns with nested structures are grouped into supernodes.
+       The same ordering is used for the rows and columns so the structure of U is the transpose
+       of the structure of L.
+
+    3. Numeric factorization. Each supernode is factored as a dense frontal matrix assembled
+       from the original elements and the update matrices of its children. Supernodes in
+       different subtrees are independent, so the tree is executed as a task graph. Small
+       subtrees are grouped into a single task, and the large fronts near the root (where there
+       is little tree parallelism left) update their Schur complements in parallel.
+
+    The structure is fixed before the numeric factorization starts so pivoting is limited to the
+    rows of each supernode's diagonal block. A pivot that is still too small is replaced by a
+    small value of the same sign (static pivoting) and the solution is then improved with
+    iterative refinement against the original matrix.
+*/
+
+#ifndef SPARSE_LU_HPP
+#define SPARSE_LU_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "parallel_for.hpp"
+#include "sparse_matrix.hpp"
+#include "task_graph.hpp"
+#include "../C/pivot_threshold.h"
+
+namespace sparse_lu {
+
+    const std::size_t none = static_cast<std::size_t>( -1 );
+
+    // Subgraphs with no more vertices than this are not dissected further.
+    const std::size_t leaf_size = 64;
+
+    // Subtrees of the elimination tree with less work than this (in multiply-add operations)
+    // are factored by a single task. Smaller subtrees are also grouped into tasks of this size.
+    const double task_work = 1.0E+6;
+
+    // Fronts with Schur complement updates larger than this are updated in parallel.
+    const double parallel_update_work = 4.0E+6;
+
+    //! The pattern of A + A^T (without the diagonal) as an adjacency structure.
+    struct Graph {
+        std::vector< std::size_t > start;      // Neighbors of v are adjacent[start[v] .. start[v + 1]).
+        std::vector< std::size_t > adjacent;
+
+        std::size_t vertex_count( ) const { return start.size( ) - 1; }
+    };
+
+
+    //! Builds the graph of A + A^T.
+    template< typename FloatingType >
+    Graph symmetric_pattern( const SparseMatrix<FloatingType> &a )
+    {
+        const std::size_t  n = a.row_count( );
+        const std::size_t *row_start = a.row_start( );
+        const std::size_t *column_index = a.column_index( );
+
+        // Count each off diagonal element twice: once for (i, j) and once for (j, i).
+        Graph graph;
+        graph.start.assign( n + 1, 0 );
+        for( std::size_t i = 0; i < n; ++i ) {
+            for( std::size_t k = row_start[i]; k < row_start[i + 1]; ++k ) {
+                const std::size_t j = column_index[k];
+                if( j == i ) continue;
+                ++graph.start[i + 1];
+                ++graph.start[j + 1];
+            }
+        }
+        for( std::size_t i = 0; i < n; ++i ) graph.start[i + 1] += graph.start[i];
+
+        std::vector< std::size_t > next( graph.start.begin( ), graph.start.end( ) - 1 );
+        graph.adjacent.resize( graph.start[n] );
+        for( std::size_t i = 0; i < n; ++i ) {
+            for( std::size_t k = row_start[i]; k < row_start[i + 1]; ++k ) {
+                const std::size_t j = column_index[k];
+                if( j == i ) continue;
+                graph.adjacent[next[i]++] = j;
+                graph.adjacent[next[j]++] = i;
+            }
+        }
+
+        // Remove the duplicates that arise when both (i, j) and (j, i) are present.
+        std::size_t position = 0;
+        std::size_t first = 0;
+        for( std::size_t v = 0; v < n; ++v ) {
+            const std::size_t last = graph.start[v + 1];
+            std::sort( graph.adjacent.begin( ) + first, graph.adjacent.begin( ) + last );
+            graph.start[v] = position;
+            for( std::size_t k = first; k < last; ++k ) {
+                if( k == first || graph.adjacent[k] != graph.adjacent[k - 1] ) {
+                    graph.adjacent[position++] = graph.adjacent[k];
+                }
+            }
+            first = last;
+        }
+        graph.start[n] = position;
+        graph.adjacent.resize( position );
+        return graph;
+    }
+
+
+    //! Computes a nested dissection ordering of a graph.
+    class Dissection {
+    public:
+        explicit Dissection( const Graph &g );
+
+        //! Returns the ordering. Vertex order[k] is to be numbered k.
+        const std::vector< std::size_t > &ordering( ) const { return order; }
+
+    private:
+        const Graph &graph;
+        std::vector< std::size_t > label;   // The set containing each vertex.
+        std::vector< std::size_t > mark;    // Visited stamp for the breadth first searches.
+        std::vector< std::size_t > level;   // Level of each vertex in the last search.
+        std::vector< std::size_t > order;
+        std::size_t next_label;
+        std::size_t stamp;
+
+        std::size_t search(
+            std::size_t root, std::size_t set, std::vector< std::size_t > &queue, std::vector< std::size_t > &level_start );
+        void dissect( std::vector< std::size_t > &vertices, std::size_t set );
+    };
+
+
+    inline Dissection::Dissection( const Graph &g )
+        : graph( g ), label( g.vertex_count( ), 0 ), mark( g.vertex_count( ), 0 ), level( g.vertex_count( ), 0 ),
+          next_label( 1 ), stamp( 0 )
+    {
+        order.reserve( g.vertex_count( ) );
+        std::vector< std::size_t > vertices( g.vertex_count( ) );
+        for( std::size_t v = 0; v < vertices.size( ); ++v ) vertices[v] = v;
+        dissect( vertices, 0 );
+    }
+
+
+    //
+    // Breadth first search from root, restricted to the vertices of the given set. On return
+    // queue holds the vertices reached, level by level, and level_start the position of the
+    // first vertex of each level (plus one extra entry). Returns the number of vertices reached.
+    //
+    inline std::size_t Dissection::search(
+        std::size_t root, std::size_t set, std::vector< std::size_t > &queue, std::vector< std::size_t > &level_start )
+    {
+        ++stamp;
+        queue.clear( );
+        level_start.clear( );
+        queue.push_back( root );
+        mark[root] = stamp;
+        level[root] = 0;
+
+        std::size_t head = 0;
+        while( head < queue.size( ) ) {
+            level_start.push_back( head );
+            const std::size_t level_end = queue.size( );
+            for( ; head < level_end; ++head ) {
+                const std::size_t v = queue[head];
+                for( std::size_t k = graph.start[v]; k < graph.start[v + 1]; ++k ) {
+                    const std::size_t w = graph.adjacent[k];
+                    if( label[w] != set || mark[w] == stamp ) continue;
+                    mark[w] = stamp;
+                    level[w] = level_start.size( );
+                    queue.push_back( w );
+                }
+            }
+        }
+        level_start.push_back( queue.size( ) );
+        return queue.size( );
+    }
+
+
+    inline void Dissection::dissect( std::vector< std::size_t > &vertices, std::size_t set )
+    {
+        if( vertices.size( ) <= leaf_size ) {
+            order.insert( order.end( ), vertices.begin( ), vertices.end( ) );
+            return;
+        }
+
+        std::vector< std::size_t > queue;
+        std::vector< std::size_t > level_start;
+
+        // If the set isn't connected, dissect each of its components separately.
+        if( search( vertices[0], set, queue, level_start ) < vertices.size( ) ) {
+            for( std::size_t v : vertices ) {
+                if( label[v] != set ) continue;
+                search( v, set, queue, level_start );
+                const std::size_t component = next_label++;
+                for( std::size_t w : queue ) label[w] = component;
+                dissect( queue, component );
+            }
+            return;
+        }
+
+        // Look for a pseudo-peripheral vertex: one whose level structure is as deep as possible.
+        // A few searches, each from a vertex of minimum degree in the last level of the
+        // previous search, are enough in practice.
+        std::size_t depth = level_start.size( ) - 1;
+        for( int attempt = 0; attempt < 4; ++attempt ) {
+            std::size_t candidate = queue[level_start[depth - 1]];
+            for( std::size_t k = level_start[depth - 1]; k < level_start[depth]; ++k ) {
+                const std::size_t v = queue[k];
+                if( graph.start[v + 1] - graph.start[v] < graph.start[candidate + 1] - graph.start[candidate] ) {
+                    candidate = v;
+                }
+            }
+            std::vector< std::size_t > candidate_queue;
+            std::vector< std::size_t > candidate_start;
+            search( candidate, set, candidate_queue, candidate_start );
+            if( candidate_start.size( ) - 1 <= depth ) {
+                // Restore the level numbers of the deepest structure found.
+                search( queue[0], set, queue, level_start );
+                break;
+            }
+            queue.swap( candidate_queue );
+            level_start.swap( candidate_start );
+            depth = level_start.size( ) - 1;
+        }
+
+        // A shallow level structure has no useful separator (the set is nearly complete).
+        if( depth < 3 ) {
+            order.insert( order.end( ), vertices.begin( ), vertices.end( ) );
+            return;
+        }
+
+        // The separator is taken from the level that splits the vertices most evenly, but it
+        // can't be the first or last level.
+        std::size_t middle = 1;
+        while( middle < depth - 2 && level_start[middle + 1] < vertices.size( ) / 2 ) ++middle;
+
+        // Vertices of the middle level with no neighbors in the next level need not be in the
+        // separator; they are placed in the first part instead.
+        std::vector< std::size_t > first_part( queue.begin( ), queue.begin( ) + level_start[middle] );
+        std::vector< std::size_t > second_part( queue.begin( ) + level_start[middle + 1], queue.end( ) );
+        std::vector< std::size_t > separator;
+        for( std::size_t k = level_start[middle]; k < level_start[middle + 1]; ++k ) {
+            const std::size_t v = queue[k];
+            bool touches_next = false;
+            for( std::size_t e = graph.start[v]; e < graph.start[v + 1] && !touches_next; ++e ) {
+                const std::size_t w = graph.adjacent[e];
+                touches_next = label[w] == set && level[w] == middle + 1;
+            }
+            ( touches_next ? separator : first_part ).push_back( v );
+        }
+
+        const std::size_t first_label = next_label++;
+        const std::size_t second_label = next_label++;
+        const std::size_t separator_label = next_label++;
+        for( std::size_t v : first_part ) label[v] = first_label;
+        for( std::size_t v : second_part ) label[v] = second_label;
+        for( std::size_t v : separator ) label[v] = separator_label;
+
+        vertices.clear( );
+        vertices.shrink_to_fit( );
+        dissect( first_part, first_label );
+        dissect( second_part, second_label );
+        order.insert( order.end( ), separator.begin( ), separator.end( ) );
+    }
+
+
+    //! A group of consecutive columns of L with identical structure below the group.
+    struct Supernode {
+        std::size_t first;                  // First column.
+        std::size_t count;                  // Number of columns.
+        std::vector< std::size_t > rows;    // Rows of L below the diagonal block, increasing.
+        std::size_t parent;                 // Parent supernode or none.
+        std::size_t first_descendant;       // Supernodes first_descendant .. this form the subtree.
+        std::vector< std::size_t > children;
+
+        std::size_t front_size( ) const { return count + rows.size( ); }
+    };
+
+}
+
+
+//! The LU decomposition of a sparse matrix.
+/*!
+ *  Typical use is to call analyze( ) once for a matrix structure, factor( ) for each matrix
+ *  with that structure, and then solve( ) for each right hand side.
+ */
+template< typename FloatingType >
+class SparseLU {
+public:
+    SparseLU( ) : size( 0 ), perturbed_count( 0 ) { }
+
+    //! Computes the ordering and the structure of the factors.
+    void analyze( const SparseMatrix<FloatingType> &a );
+
+    //! Computes the factors. The matrix must have the structure given to analyze( ).
+    /*!
+     *  \param thread_count The maximum number of threads to use (zero means "all").
+     */
+    void factor( const SparseMatrix<FloatingType> &a, unsigned thread_count = 0 );
+
+    //! Solves a x = b using the factors. On entry b is the driving vector; on exit the solution.
+    void solve( FloatingType *b ) const;
+
+    //! Improves a solution of a x = b with up to step_count steps of iterative refinement.
+    /*!
+     *  Refinement stops early when the residual stops decreasing.
+     *
+     *  \return The relative residual norm ||b - a x|| / ||b|| of the final solution.
+     */
+    double refine( const SparseMatrix<FloatingType> &a, const FloatingType *b, FloatingType *x, unsigned step_count = 3 ) const;
+
+    //! Returns the number of supernodes.
+    std::size_t supernode_count( ) const { return supernodes.size( ); }
+
+    //! Returns the number of elements stored in L and U (counting the diagonal once).
+    std::size_t factor_element_count( ) const;
+
+    //! Returns the number of pivots that were too small and had to be perturbed.
+    std::size_t perturbed_pivot_count( ) const { return perturbed_count; }
+
+private:
+    struct Factor {
+        std::vector< FloatingType > upper;         // count x front_size: U11 U12 (and L11 below the diagonal).
+        std::vector< FloatingType > lower;         // rows.size( ) x count: L21.
+        std::vector< FloatingType > update;        // rows.size( ) x rows.size( ): Schur complement for the parent.
+        std::vector< std::size_t >  pivots;        // Row interchanges within the diagonal block.
+    };
+
+    std::size_t size;
+    std::vector< std::size_t > order;              // Unknown order[k] is numbered k.
+    std::vector< std::size_t > position;           // Inverse of order.
+    std::vector< sparse_lu::Supernode > supernodes;
+    std::vector< Factor > factors;
+    std::size_t perturbed_count;
+
+    // The reordered matrix, row wise and column wise, used to assemble the fronts.
+    SparseMatrix<FloatingType> by_rows;
+    SparseMatrix<FloatingType> by_columns;
+
+    void factor_supernode( std::size_t s, FloatingType tiny, unsigned thread_count, std::atomic< std::size_t > &perturbed );
+};
+
+
+template< typename FloatingType >
+void SparseLU<FloatingType>::analyze( const SparseMatrix<FloatingType> &a )
+{
+    using sparse_lu::none;
+
+    size = a.row_count( );
+    const sparse_lu::Graph graph = sparse_lu::symmetric_pattern( a );
+    std::vector< std::size_t > dissection_order = sparse_lu::Dissection( graph ).ordering( );
+    std::vector< std::size_t > dissection_position( size );
+    for( std::size_t k = 0; k < size; ++k ) dissection_position[dissection_order[k]] = k;
+
+    // Compute the elimination tree using Liu's algorithm with path compression.
+    std::vector< std::size_t > parent( size, none );
+    std::vector< std::size_t > ancestor( size, none );
+    for( std::size_t j = 0; j < size; ++j ) {
+        const std::size_t v = dissection_order[j];
+        for( std::size_t e = graph.start[v]; e < graph.start[v + 1]; ++e ) {
+            std::size_t r = dissection_position[graph.adjacent[e]];
+            if( r >= j ) continue;
+            while( ancestor[r] != none && ancestor[r] != j ) {
+                const std::size_t next = ancestor[r];
+                ancestor[r] = j;
+                r = next;
+            }
+            if( ancestor[r] == none ) {
+                ancestor[r] = j;
+                parent[r] = j;
+            }
+        }
+    }
+
+    // Postorder the tree so that every subtree is numbered contiguously. This doesn't change
+    // the fill in, but it makes the supernodes consecutive columns.
+    std::vector< std::size_t > first_child( size, none );
+    std::vector< std::size_t > next_sibling( size, none );
+    for( std::size_t j = size; j > 0; --j ) {
+        const std::size_t p = parent[j - 1];
+        if( p != none ) {
+            next_sibling[j - 1] = first_child[p];
+            first_child[p] = j - 1;
+        }
+    }
+    std::vector< std::size_t > postorder;
+    postorder.reserve( size );
+    std::vector< std::size_t > stack;
+    for( std::size_t root = 0; root < size; ++root ) {
+        if( parent[root] != none ) continue;
+        stack.push_back( root );
+        while( !stack.empty( ) ) {
+            const std::size_t j = stack.back( );
+            if( first_child[j] != none ) {
+                // Descend into the next unvisited child, detaching it from the list.
+                const std::size_t child = first_child[j];
+                first_child[j] = next_sibling[child];
+                stack.push_back( child );
+            }
+            else {
+                postorder.push_back( j );
+                stack.pop_back( );
+            }
+        }
+    }
+
+    std::vector< std::size_t > renumber( size );
+    for( std::size_t k = 0; k < size; ++k ) renumber[postorder[k]] = k;
+    order.resize( size );
+    position.resize( size );
+    std::vector< std::size_t > tree_parent( size, none );
+    for( std::size_t k = 0; k < size; ++k ) {
+        order[k] = dissection_order[postorder[k]];
+        position[order[k]] = k;
+        if( parent[postorder[k]] != none ) tree_parent[k] = renumber[parent[postorder[k]]];
+    }
+
+    // Find the structure of each column of L. The structure of column j is its own elements
+    // below the diagonal together with the structures of its children (less j itself). Only
+    // the structures of the first columns of the supernodes are kept.
+    std::vector< std::vector< std::size_t > > structure( size );
+    std::vector< std::size_t > column_count( size );
+    std::vector< std::size_t > child_count( size, 0 );
+    std::vector< std::vector< std::size_t > > children( size );
+    for( std::size_t j = 0; j < size; ++j ) {
+        if( tree_parent[j] != none ) {
+            children[tree_parent[j]].push_back( j );
+            ++child_count[tree_parent[j]];
+        }
+    }
+
+    std::vector< std::size_t > mark( size, none );
+    std::vector< bool > starts_supernode( size, true );
+    std::vector< std::size_t > column_supernode( size );
+    supernodes.clear( );
+    for( std::size_t j = 0; j < size; ++j ) {
+        std::vector< std::size_t > &column = structure[j];
+        mark[j] = j;
+        const std::size_t v = order[j];
+        for( std::size_t e = graph.start[v]; e < graph.start[v + 1]; ++e ) {
+            const std::size_t i = position[graph.adjacent[e]];
+            if( i > j && mark[i] != j ) {
+                mark[i] = j;
+                column.push_back( i );
+            }
+        }
+        for( std::size_t c : children[j] ) {
+            for( std::size_t i : structure[c] ) {
+                if( mark[i] != j ) {
+                    mark[i] = j;
+                    column.push_back( i );
+                }
+            }
+            if( !starts_supernode[c] ) std::vector< std::size_t >( ).swap( structure[c] );
+        }
+        std::sort( column.begin( ), column.end( ) );
+        column_count[j] = column.size( );
+
+        // Column j continues the supernode of column j - 1 if it is that column's parent, its
+        // only child, and their structures are nested.
+        if( j > 0 && tree_parent[j - 1] == j && child_count[j] == 1 && column_count[j - 1] == column_count[j] + 1 ) {
+            starts_supernode[j] = false;
+            ++supernodes.back( ).count;
+        }
+        else {
+            sparse_lu::Supernode node;
+            node.first = j;
+            node.count = 1;
+            node.parent = none;
+            supernodes.push_back( node );
+        }
+        column_supernode[j] = supernodes.size( ) - 1;
+    }
+
+    for( std::size_t s = 0; s < supernodes.size( ); ++s ) {
+        sparse_lu::Supernode &node = supernodes[s];
+        const std::size_t last = node.first + node.count - 1;
+        std::vector< std::size_t > &column = structure[node.first];
+        node.rows.assign( std::upper_bound( column.begin( ), column.end( ), last ), column.end( ) );
+        std::vector< std::size_t >( ).swap( column );
+
+        if( tree_parent[last] != none ) {
+            node.parent = column_supernode[tree_parent[last]];
+            supernodes[node.parent].children.push_back( s );
+        }
+    }
+
+    // Supernodes are numbered in postorder, so each subtree is contiguous.
+    for( std::size_t s = 0; s < supernodes.size( ); ++s ) {
+        supernodes[s].first_descendant = s;
+        for( std::size_t c : supernodes[s].children ) {
+            supernodes[s].first_descendant = std::min( supernodes[s].first_descendant, supernodes[c].first_descendant );
+        }
+    }
+}
+
+
+template< typename FloatingType >
+std::size_t SparseLU<FloatingType>::factor_element_count( ) const
+{
+    std::size_t total = 0;
+    for( const sparse_lu::Supernode &node : supernodes ) {
+        total += node.count * node.count + 2 * node.count * node.rows.size( );
+    }
+    return total;
+}
+
+
+//
+// Assembles and partially factors the front of supernode s. The fronts of its children must
+// already have been factored.
+//
+template< typename FloatingType >
+void SparseLU<FloatingType>::factor_supernode(
+    std::size_t s, FloatingType tiny, unsigned thread_count, std::atomic< std::size_t > &perturbed )
+{
+    const sparse_lu::Supernode &node = supernodes[s];
+    Factor &result = factors[s];
+    const std::size_t k = node.count;
+    const std::size_t m = node.front_size( );
+    const std::size_t last = node.first + k;
+
+    // Returns the position of index i in the front.
+    auto front_position = [&]( std::size_t i ) -> std::size_t
+    {
+        if( i < last ) return i - node.first;
+        return k + ( std::lower_bound( node.rows.begin( ), node.rows.end( ), i ) - node.rows.begin( ) );
+    };
+
+    // Assemble the original elements: the rows of the supernode and the columns below it.
+    std::vector< FloatingType > front( m * m, FloatingType( 0 ) );
+    for( std::size_t c = node.first; c < last; ++c ) {
+        const std::size_t local = c - node.first;
+        for( std::size_t e = by_rows.row_start( )[c]; e < by_rows.row_start( )[c + 1]; ++e ) {
+            const std::size_t j = by_rows.column_index( )[e];
+            if( j >= node.first ) front[local * m + front_position( j )] += by_rows.values( )[e];
+        }
+        for( std::size_t e = by_columns.row_start( )[c]; e < by_columns.row_start( )[c + 1]; ++e ) {
+            const std::size_t i = by_columns.column_index( )[e];
+            if( i >= last ) front[front_position( i ) * m + local] += by_columns.values( )[e];
+        }
+    }
+
+    // Add in the update matrices of the children. The rows of each child are a subset of the
+    // indices of this front and both lists are sorted, so the positions are found by merging.
+    std::vector< std::size_t > map;
+    for( std::size_t c : node.children ) {
+        const std::vector< std::size_t > &child_rows = supernodes[c].rows;
+        const std::size_t child_size = child_rows.size( );
+        map.resize( child_size );
+        std::size_t p = 0;
+        for( std::size_t r = 0; r < child_size; ++r ) {
+            const std::size_t i = child_rows[r];
+            if( i < last ) {
+                map[r] = i - node.first;
+            }
+            else {
+                while( node.rows[p] < i ) ++p;
+                map[r] = k + p;
+            }
+        }
+        const std::vector< FloatingType > &update = factors[c].update;
+        for( std::size_t r = 0; r < child_size; ++r ) {
+            FloatingType *front_row = &front[map[r] * m];
+            const FloatingType *update_row = &update[r * child_size];
+            for( std::size_t q = 0; q < child_size; ++q ) front_row[map[q]] += update_row[q];
+        }
+        std::vector< FloatingType >( ).swap( factors[c].update );
+    }
+
+    // Factor the first k columns, choosing pivots from the rows of the diagonal block.
+    result.pivots.resize( k );
+    for( std::size_t p = 0; p < k; ++p ) {
+        std::size_t pivot_row = p;
+        FloatingType max = std::abs( front[p * m + p] );
+        for( std::size_t r = p + 1; r < k; ++r ) {
+            if( std::abs( front[r * m + p] ) > max ) {
+                pivot_row = r;
+                max = std::abs( front[r * m + p] );
+            }
+        }
+        result.pivots[p] = pivot_row;
+        if( pivot_row != p ) {
+            std::swap_ranges( front.begin( ) + p * m, front.begin( ) + ( p + 1 ) * m, front.begin( ) + pivot_row * m );
+        }
+        FloatingType &pivot = front[p * m + p];
+        if( !( std::abs( pivot ) >= tiny ) ) {
+            pivot = ( pivot < FloatingType( 0 ) ) ? -tiny : tiny;
+            ++perturbed;
+        }
+
+        const FloatingType inverse = FloatingType( 1 ) / pivot;
+        const FloatingType *pivot_row_data = &front[p * m];
+        for( std::size_t r = p + 1; r < m; ++r ) {
+            FloatingType *row = &front[r * m];
+            const FloatingType factor = ( row[p] *= inverse );
+            if( factor == FloatingType( 0 ) ) continue;
+
+            // Rows of the diagonal block are updated across the whole front (they become U);
+            // the rows below are only updated within the block's columns (they become L21).
+            const std::size_t column_last = ( r < k ) ? m : k;
+            for( std::size_t c = p + 1; c < column_last; ++c ) row[c] -= factor * pivot_row_data[c];
+        }
+    }
+
+    // Compute the update matrix for the parent: the Schur complement F22 - L21 U12.
+    const std::size_t below = m - k;
+    result.update.resize( below * below );
+    auto update_rows = [&]( std::size_t first, std::size_t last_row, unsigned )
+    {
+        for( std::size_t r = first; r < last_row; ++r ) {
+            const FloatingType *front_row = &front[( k + r ) * m];
+            FloatingType *update_row = &result.update[r * below];
+            for( std::size_t c = 0; c < below; ++c ) update_row[c] = front_row[k + c];
+            for( std::size_t p = 0; p < k; ++p ) {
+                const FloatingType factor = front_row[p];
+                if( factor == FloatingType( 0 ) ) continue;
+                const FloatingType *u_row = &front[p * m + k];
+                for( std::size_t c = 0; c < below; ++c ) update_row[c] -= factor * u_row[c];
+            }
+        }
+    };
+    const double work = static_cast<double>( below ) * below * k;
+    parallel_for_ranges( 0, below, update_rows, ( work >= sparse_lu::parallel_update_work ) ? thread_count : 1 );
+
+    // Keep the factors.
+    result.upper.assign( front.begin( ), front.begin( ) + k * m );
+    result.lower.resize( below * k );
+    for( std::size_t r = 0; r < below; ++r ) {
+        std::copy( front.begin( ) + ( k + r ) * m, front.begin( ) + ( k + r ) * m + k, result.lower.begin( ) + r * k );
+    }
+}
+
+
+template< typename FloatingType >
+void SparseLU<FloatingType>::factor( const SparseMatrix<FloatingType> &a, unsigned thread_count )
+{
+    using sparse_lu::none;
+    if( thread_count == 0 ) thread_count = default_thread_count( );
+
+    // Build the reordered matrix and its transpose.
+    std::vector< std::size_t > row_start( size + 1, 0 );
+    std::vector< std::size_t > column_start( size + 1, 0 );
+    for( std::size_t i = 0; i < size; ++i ) {
+        row_start[position[i] + 1] = a.row_start( )[i + 1] - a.row_start( )[i];
+        for( std::size_t e = a.row_start( )[i]; e < a.row_start( )[i + 1]; ++e ) {
+            ++column_start[position[a.column_index( )[e]] + 1];
+        }
+    }
+    for( std::size_t i = 0; i < size; ++i ) {
+        row_start[i + 1] += row_start[i];
+        column_start[i + 1] += column_start[i];
+    }
+    const std::size_t element_count = a.element_count( );
+    std::vector< std::size_t > row_columns( element_count ), column_rows( element_count );
+    std::vector< FloatingType > row_values( element_count ), column_values( element_count );
+    std::vector< std::size_t > column_next( column_start.begin( ), column_start.end( ) - 1 );
+
+    // Visiting the new rows in order fills each column in increasing row order.
+    std::vector< std::pair< std::size_t, FloatingType > > entries;
+    for( std::size_t i = 0; i < size; ++i ) {
+        const std::size_t old_row = order[i];
+        entries.clear( );
+        for( std::size_t e = a.row_start( )[old_row]; e < a.row_start( )[old_row + 1]; ++e ) {
+            entries.push_back( std::make_pair( position[a.column_index( )[e]], a.values( )[e] ) );
+        }
+        std::sort( entries.begin( ), entries.end( ),
+            []( const std::pair< std::size_t, FloatingType > &x, const std::pair< std::size_t, FloatingType > &y )
+            { return x.first < y.first; } );
+        std::size_t e = row_start[i];
+        for( const std::pair< std::size_t, FloatingType > &entry : entries ) {
+            row_columns[e] = entry.first;
+            row_values[e] = entry.second;
+            ++e;
+            const std::size_t slot = column_next[entry.first]++;
+            column_rows[slot] = i;
+            column_values[slot] = entry.second;
+        }
+    }
+    by_rows = SparseMatrix<FloatingType>( size, size, row_start, std::move( row_columns ), std::move( row_values ) );
+    by_columns = SparseMatrix<FloatingType>( size, size, std::move( column_start ), std::move( column_rows ), std::move( column_values ) );
+
+    factors.clear( );
+    factors.resize( supernodes.size( ) );
+    // Pivots smaller than the pivot_threshold are perturbed. The stored values form one row.
+    const FloatingType tiny = static_cast<FloatingType>( pivot_threshold( 1, a.element_count( ), a.values( ), 0 ) );
+    std::atomic< std::size_t > perturbed( 0 );
+
+    // Estimate the work in each subtree.
+    const std::size_t count = supernodes.size( );
+    std::vector< double > subtree_work( count );
+    for( std::size_t s = 0; s < count; ++s ) {
+        const double m = static_cast<double>( supernodes[s].front_size( ) );
+        subtree_work[s] = m * m * supernodes[s].count;
+        for( std::size_t c : supernodes[s].children ) subtree_work[s] += subtree_work[c];
+    }
+
+    // Large supernodes get a task of their own. Small subtrees hanging from them (or forming
+    // whole trees) are collected into tasks of about task_work.
+    TaskGraph graph;
+    std::vector< TaskGraph::task_id > task_of( count );
+    std::vector< std::size_t > batch;
+    double batch_work = 0.0;
+    auto flush_batch = [&]( )
+    {
+        if( batch.empty( ) ) return;
+        TaskGraph::task_id id = graph.add_task(
+            [this, roots = batch, tiny, &perturbed]( )
+            {
+                for( std::size_t root : roots ) {
+                    for( std::size_t s = supernodes[root].first_descendant; s <= root; ++s ) {
+                        factor_supernode( s, tiny, 1, perturbed );
+                    }
+                }
+            } );
+        for( std::size_t root : batch ) task_of[root] = id;
+        batch.clear( );
+        batch_work = 0.0;
+    };
+
+    for( std::size_t s = 0; s < count; ++s ) {
+        const std::size_t p = supernodes[s].parent;
+        const bool small = subtree_work[s] < sparse_lu::task_work;
+        if( small && ( p == none || subtree_work[p] >= sparse_lu::task_work ) ) {
+            batch.push_back( s );
+            batch_work += subtree_work[s];
+            if( batch_work >= sparse_lu::task_work ) flush_batch( );
+        }
+        else if( !small ) {
+            task_of[s] = graph.add_task(
+                [this, s, tiny, thread_count, &perturbed]( ) { factor_supernode( s, tiny, thread_count, perturbed ); } );
+        }
+    }
+    flush_batch( );
+
+    for( std::size_t s = 0; s < count; ++s ) {
+        if( subtree_work[s] < sparse_lu::task_work ) continue;
+        for( std::size_t c : supernodes[s].children ) graph.add_dependency( task_of[c], task_of[s] );
+    }
+    graph.run( thread_count );
+    perturbed_count = perturbed;
+}
+
+
+template< typename FloatingType >
+void SparseLU<FloatingType>::solve( FloatingType *b ) const
+{
+    std::vector< FloatingType > y( size );
+    for( std::size_t i = 0; i < size; ++i ) y[i] = b[order[i]];
+
+    // Solve L y = P b, one supernode at a time in the order of factorization.
+    for( std::size_t s = 0; s < supernodes.size( ); ++s ) {
+        const sparse_lu::Supernode &node = supernodes[s];
+        const Factor &f = factors[s];
+        const std::size_t k = node.count;
+        const std::size_t m = node.front_size( );
+        FloatingType *block = &y[node.first];
+
+        for( std::size_t p = 0; p < k; ++p ) std::swap( block[p], block[f.pivots[p]] );
+        for( std::size_t p = 0; p < k; ++p ) {
+            for( std::size_t r = p + 1; r < k; ++r ) block[r] -= f.upper[r * m + p] * block[p];
+        }
+        for( std::size_t r = 0; r < node.rows.size( ); ++r ) {
+            FloatingType sum = 0;
+            for( std::size_t p = 0; p < k; ++p ) sum += f.lower[r * k + p] * block[p];
+            y[node.rows[r]] -= sum;
+        }
+    }
+
+    // Solve U x = y in the reverse order.
+    for( std::size_t s = supernodes.size( ); s > 0; --s ) {
+        const sparse_lu::Supernode &node = supernodes[s - 1];
+        const Factor &f = factors[s - 1];
+        const std::size_t k = node.count;
+        const std::size_t m = node.front_size( );
+        FloatingType *block = &y[node.first];
+
+        for( std::size_t p = k; p > 0; --p ) {
+            const FloatingType *u_row = &f.upper[( p - 1 ) * m];
+            FloatingType sum = block[p - 1];
+            for( std::size_t c = p; c < k; ++c ) sum -= u_row[c] * block[c];
+            for( std::size_t r = 0; r < node.rows.size( ); ++r ) sum -= u_row[k + r] * y[node.rows[r]];
+            block[p - 1] = sum / u_row[p - 1];
+        }
+    }
+
+    for( std::size_t i = 0; i < size; ++i ) b[order[i]] = y[i];
+}
+
+
+template< typename FloatingType >
+double SparseLU<FloatingType>::refine(
+    const SparseMatrix<FloatingType> &a, const FloatingType *b, FloatingType *x, unsigned step_count ) const
+{
+    std::vector< FloatingType > residual( size );
+    std::vector< FloatingType > best( x, x + size );
+
+    double b_norm = 0.0;
+    for( std::size_t i = 0; i < size; ++i ) b_norm += static_cast<double>( b[i] ) * b[i];
+    b_norm = std::sqrt( b_norm );
+    if( b_norm == 0.0 ) b_norm = 1.0;
+
+    // Returns ||b - a x|| / ||b|| and leaves b - a x in residual.
+    auto compute_residual = [&]( ) -> double
+    {
+        a.multiply( x, residual.data( ) );
+        double sum = 0.0;
+        for( std::size_t i = 0; i < size; ++i ) {
+            residual[i] = b[i] - residual[i];
+            sum += static_cast<double>( residual[i] ) * residual[i];
+        }
+        return std::sqrt( sum ) / b_norm;
+    };
+
+    double best_norm = compute_residual( );
+    for( unsigned step = 0; step < step_count; ++step ) {
+        solve( residual.data( ) );
+        for( std::size_t i = 0; i < size; ++i ) x[i] += residual[i];
+        const double norm = compute_residual( );
+        if( !( norm < best_norm ) ) {
+            std::copy( best.begin( ), best.end( ), x );
+            break;
+        }
+        best_norm = norm;
+        std::copy( x, x + size, best.begin( ) );
+    }
+    return best_norm;
+}
+
+#endif
@@ -0,0 +1,130 @@
+/*!
+    \file   sparse_matrix.hpp
+    \brief  A matrix in compressed sparse row (CSR) form.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    Only the non-zero elements are stored. The elements of each row are stored together, in
+    order of increasing column number. The array row_start gives the position of the first
+    element of each row, and has one extra entry at the end holding the total number of
+    elements.
+*/
+
+#ifndef SPARSE_MATRIX_HPP
+#define SPARSE_MATRIX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "Matrix.hpp"
+#include "parallel_for.hpp"
+
+template< typename FloatingType >
+class SparseMatrix {
+public:
+    //! Creates an empty 0 x 0 matrix.
+    SparseMatrix( ) : n( 0 ), m( 0 ), starts( 1, 0 ) { }
+
+    //! Creates a matrix from its CSR arrays.
+    /*!
+     *  \param row_count The number of rows.
+     *  \param col_count The number of columns.
+     *  \param row_start Has row_count + 1 entries.
+     *  \param column_index The column of each element. Must be increasing within each row.
+     *  \param values The value of each element.
+     */
+    SparseMatrix(
+        std::size_t row_count,
+        std::size_t col_count,
+        std::vector< std::size_t >  row_start,
+        std::vector< std::size_t >  column_index,
+        std::vector< FloatingType > values )
+        : n( row_count ), m( col_count ),
+          starts( std::move( row_start ) ), columns( std::move( column_index ) ), elements( std::move( values ) )
+    { }
+
+    //! Creates a matrix holding the non-zero elements of a dense matrix.
+    explicit SparseMatrix( const Matrix<FloatingType> &dense );
+
+    std::size_t row_count( ) const { return n; }
+    std::size_t col_count( ) const { return m; }
+
+    //! Returns the number of stored elements.
+    std::size_t element_count( ) const { return elements.size( ); }
+
+    const std::size_t  *row_start( ) const { return starts.data( ); }
+    const std::size_t  *column_index( ) const { return columns.data( ); }
+    const FloatingType *values( ) const { return elements.data( ); }
+
+    //! Computes y = A x, using up to thread_count threads (zero means "all").
+    /*!
+     *  The rows are divided among the threads so that each thread gets about the same number
+     *  of elements (rather than rows).
+     */
+    void multiply( const FloatingType *x, FloatingType *y, unsigned thread_count = 0 ) const;
+
+private:
+    // Matrices smaller than this are multiplied with a single thread.
+    static const std::size_t minimum_parallel_elements = 64 * 1024;
+
+    std::size_t n;
+    std::size_t m;
+    std::vector< std::size_t >  starts;
+    std::vector< std::size_t >  columns;
+    std::vector< FloatingType > elements;
+};
+
+
+template< typename FloatingType >
+SparseMatrix<FloatingType>::SparseMatrix( const Matrix<FloatingType> &dense )
+    : n( dense.row_count( ) ), m( dense.col_count( ) ), starts( n + 1 )
+{
+    starts[0] = 0;
+    for( std::size_t i = 0; i < n; ++i ) {
+        const FloatingType *row = dense.get_row( i );
+        for( std::size_t j = 0; j < m; ++j ) {
+            if( row[j] != FloatingType( 0 ) ) {
+                columns.push_back( j );
+                elements.push_back( row[j] );
+            }
+        }
+        starts[i + 1] = elements.size( );
+    }
+}
+
+
+template< typename FloatingType >
+void SparseMatrix<FloatingType>::multiply( const FloatingType *x, FloatingType *y, unsigned thread_count ) const
+{
+    if( thread_count == 0 ) thread_count = default_thread_count( );
+    if( elements.size( ) < minimum_parallel_elements ) thread_count = 1;
+
+    auto multiply_rows = [this, x, y]( std::size_t first, std::size_t last )
+    {
+        for( std::size_t i = first; i < last; ++i ) {
+            FloatingType sum = 0;
+            for( std::size_t k = starts[i]; k < starts[i + 1]; ++k ) sum += elements[k] * x[columns[k]];
+            y[i] = sum;
+        }
+    };
+
+    // Balance by elements: thread t starts at the first row beginning at or after element
+    // t * total / thread_count. Every row, including empty ones, belongs to exactly one thread.
+    auto boundary = [this, thread_count]( std::size_t t ) -> std::size_t
+    {
+        const std::size_t element = ( elements.size( ) * t ) / thread_count;
+        return std::lower_bound( starts.begin( ), starts.end( ), element ) - starts.begin( );
+    };
+
+    parallel_for_ranges( 0, thread_count,
+        [&]( std::size_t first_thread, std::size_t last_thread, unsigned )
+        {
+            for( std::size_t t = first_thread; t < last_thread; ++t ) {
+                const std::size_t last_row = ( t + 1 == thread_count ) ? n : boundary( t + 1 );
+                multiply_rows( boundary( t ), last_row );
+            }
+        },
+        thread_count );
+}
+
+#endif
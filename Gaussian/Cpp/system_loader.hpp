@@ -0,0 +1,632 @@
+/*!
+    \file   system_loader.hpp
+    \brief  A fast, multithreaded reader for the text system definition format.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    The text format produced by CreateSystem consists of the system size followed by, for each
+    equation, the coefficients of that equation and then the driving vector value. Reading such
+    a file with iostreams is painfully slow for large systems; in fact it often takes longer to
+    read a system than to solve it. The reader here maps the file into memory, splits it into
+    newline aligned chunks, and converts the values in all chunks in parallel using
+    std::from_chars. Each value is stored directly into its final position in the matrix of
+    coefficients or the driving vector.
+
+    The reader also accepts files in the binary format described in ../C/system_file.h. Such
+    files are recognized by their first bytes and need no conversion beyond a possible change
+    of precision. A binary file can hold a sparse system; it can be read either into a
+    SparseMatrix or (if there is room) into a dense Matrix.
+
+    This file requires C++ 2017 (for std::from_chars).
+*/
+
+#ifndef SYSTEM_LOADER_HPP
+#define SYSTEM_LOADER_HPP
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#if defined(_WIN32)
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Matrix.hpp"
+#include "../C/system_file.h"
+#include "parallel_for.hpp"
+#include "sparse_matrix.hpp"
+
+//! A read-only view of an entire file.
+/*!
+ *  On POSIX systems the file is memory mapped. On other systems the file is simply read into a
+ *  buffer. Either way the contents are available as a contiguous array of characters.
+ */
+class MappedFile {
+public:
+    explicit MappedFile( const char *file_name );
+   ~MappedFile( );
+
+    // Mapped files can't be copied.
+    MappedFile( const MappedFile & ) = delete;
+    MappedFile &operator=( const MappedFile & ) = delete;
+
+    //! Returns true if the file was opened (and mapped) successfully.
+    bool is_open( ) const { return open; }
+
+    //! Returns a pointer to the first character of the file.
+    const char *data( ) const { return contents; }
+
+    //! Returns the number of characters in the file.
+    std::size_t size( ) const { return length; }
+
+private:
+    bool        open;
+    const char *contents;
+    std::size_t length;
+    #if defined(_WIN32)
+    std::vector< char > buffer;
+    #endif
+};
+
+
+#if defined(_WIN32)
+
+inline MappedFile::MappedFile( const char *file_name )
+    : open( false ), contents( 0 ), length( 0 )
+{
+    std::ifstream input( file_name, std::ios::binary );
+    if( !input ) return;
+    buffer.assign( std::istreambuf_iterator< char >( input ), std::istreambuf_iterator< char >( ) );
+    contents = buffer.data( );
+    length = buffer.size( );
+    open = true;
+}
+
+inline MappedFile::~MappedFile( )
+{ }
+
+#else
+
+inline MappedFile::MappedFile( const char *file_name )
+    : open( false ), contents( 0 ), length( 0 )
+{
+    int descriptor = ::open( file_name, O_RDONLY );
+    if( descriptor == -1 ) return;
+
+    struct stat file_information;
+    if( fstat( descriptor, &file_information ) == -1 || file_information.st_size == 0 ) {
+        close( descriptor );
+        return;
+    }
+    length = static_cast<std::size_t>( file_information.st_size );
+
+    void *mapping = mmap( 0, length, PROT_READ, MAP_PRIVATE, descriptor, 0 );
+
+    // The mapping remains valid after the file descriptor is closed.
+    close( descriptor );
+    if( mapping == MAP_FAILED ) {
+        length = 0;
+        return;
+    }
+
+    // Every chunk is read start to finish, but the chunks are read concurrently.
+    madvise( mapping, length, MADV_WILLNEED );
+    contents = static_cast<const char *>( mapping );
+    open = true;
+}
+
+inline MappedFile::~MappedFile( )
+{
+    if( open ) munmap( const_cast<char *>( contents ), length );
+}
+
+#endif
+
+
+//! Reader for system definition files in the text or binary format.
+/*!
+ *  Typical use is to construct a reader, allocate a matrix and driving vector using the size
+ *  returned by size( ), and then call read( ) to fill them in. After a successful read, the
+ *  statistics methods describe how long the conversion took.
+ */
+class SystemReader {
+public:
+    //! Opens the named file and reads the system size from its first line.
+    explicit SystemReader( const char *file_name );
+
+    //! Returns true if the file was opened and has a valid (non-zero) size.
+    bool is_open( ) const { return file.is_open( ) && system_size != 0; }
+
+    //! Returns the number of equations (and unknowns) in the system.
+    std::size_t size( ) const { return system_size; }
+
+    //! Returns true if the file is in the binary format.
+    bool is_binary( ) const { return binary; }
+
+    //! Returns true if the file holds a sparse system (only possible in the binary format).
+    bool is_sparse( ) const { return binary && ( header.flags & SYSTEM_FILE_SPARSE ) != 0; }
+
+    //! Converts the coefficients and driving vector values into a and b.
+    /*!
+     *  \param a The matrix of coefficients. Must be size( ) x size( ).
+     *  \param b The driving vector. Must have space for size( ) values.
+     *  \param thread_count The maximum number of threads to use (zero means "all").
+     *  \return true if every value was converted successfully and false otherwise. If false is
+     *  returned, the contents of a and b are unspecified.
+     */
+    template< typename FloatingType >
+    bool read( Matrix<FloatingType> &a, FloatingType *b, unsigned thread_count = 0 );
+
+    //! Converts the coefficients into a sparse matrix and the driving vector values into b.
+    /*!
+     *  Any system can be read this way. A dense system is read in blocks of rows with the zero
+     *  coefficients dropped, so the dense matrix never needs to be in memory all at once.
+     *
+     *  \param a Receives the matrix of coefficients. Its previous contents are replaced.
+     *  \param b The driving vector. Must have space for size( ) values.
+     *  \param thread_count The maximum number of threads to use (zero means "all").
+     *  \return true if every value was converted successfully and false otherwise.
+     */
+    template< typename FloatingType >
+    bool read( SparseMatrix<FloatingType> &a, FloatingType *b, unsigned thread_count = 0 );
+
+    //! Converts the next rows.row_count( ) equations of the system.
+    /*!
+     *  This allows a system that is too large for memory to be read in pieces. The first call
+     *  reads the first equations in the file, the next call continues where the first left
+     *  off, and so forth. Calls to read( ) do not affect the position used by this method. Only
+     *  dense systems can be read this way.
+     *
+     *  \param rows Receives the coefficients. Must have size( ) columns.
+     *  \param b Receives the driving vector values. Must have space for rows.row_count( ) values.
+     *  \param thread_count The maximum number of threads to use (zero means "all").
+     *  \return true if every value was converted successfully and false otherwise.
+     */
+    template< typename FloatingType >
+    bool read_rows( Matrix<FloatingType> &rows, FloatingType *b, unsigned thread_count = 0 );
+
+    //! Returns the number of bytes converted by the last read.
+    std::size_t byte_count( ) const { return converted_bytes; }
+
+    //! Returns the number of threads used by the last read.
+    unsigned threads_used( ) const { return used_thread_count; }
+
+    //! Returns the wall clock time of the last read in seconds.
+    double read_time( ) const { return elapsed_seconds; }
+
+    //! Returns the conversion rate of the last read in megabytes (10^6 bytes) per second.
+    double throughput( ) const
+    {
+        return ( elapsed_seconds > 0.0 ) ? ( byte_count( ) / 1.0E+06 ) / elapsed_seconds : 0.0;
+    }
+
+private:
+    // Chunks smaller than this aren't worth a thread of their own.
+    static const std::size_t minimum_chunk_size = 1024 * 1024;
+
+    MappedFile  file;
+    std::size_t system_size;
+    bool        binary;
+    system_file_header header;  // Only meaningful for binary files.
+    const char *body;           // First character after the size.
+    unsigned    used_thread_count;
+    double      elapsed_seconds;
+
+    static bool is_space( char ch )
+    {
+        return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t' || ch == '\f' || ch == '\v';
+    }
+
+    const char *cursor;         // First character of the next row for read_rows.
+    std::size_t converted_bytes;
+
+    static std::size_t count_values( const char *first, const char *last );
+    static const char *chunk_boundary( const char *start, const char *last );
+
+    template< typename FloatingType, typename Store >
+    bool convert( const char *first, const char *last, std::size_t needed_count, Store store, unsigned thread_count );
+
+    template< typename FloatingType >
+    void copy_values( const char *source, std::size_t count, FloatingType *destination ) const;
+
+    template< typename FloatingType >
+    bool read_binary_rows( const char *first, std::size_t row_count, Matrix<FloatingType> &rows, FloatingType *b, unsigned thread_count );
+};
+
+
+inline SystemReader::SystemReader( const char *file_name )
+    : file( file_name ), system_size( 0 ), binary( false ), body( 0 ), used_thread_count( 0 ),
+      elapsed_seconds( 0.0 ), cursor( 0 ), converted_bytes( 0 )
+{
+    if( !file.is_open( ) ) return;
+
+    if( system_file_is_binary( file.data( ), file.size( ) ) ) {
+        if( file.size( ) < sizeof( header ) ) return;
+        std::memcpy( &header, file.data( ), sizeof( header ) );
+        if( !system_file_header_valid( &header ) || system_file_length( &header ) != file.size( ) ) return;
+
+        binary = true;
+        system_size = header.size;
+        body = file.data( ) + sizeof( header );
+        cursor = body;
+        return;
+    }
+
+    const char *current = file.data( );
+    const char *end = current + file.size( );
+    while( current != end && is_space( *current ) ) ++current;
+
+    std::size_t size = 0;
+    std::from_chars_result result = std::from_chars( current, end, size );
+    if( result.ec != std::errc( ) ) return;
+
+    system_size = size;
+    body = result.ptr;
+    cursor = body;
+}
+
+
+//
+// Counts the number of whitespace delimited values in [first, last).
+//
+inline std::size_t SystemReader::count_values( const char *first, const char *last )
+{
+    std::size_t count = 0;
+    bool in_value = false;
+
+    for( const char *current = first; current != last; ++current ) {
+        if( is_space( *current ) ) {
+            in_value = false;
+        }
+        else if( !in_value ) {
+            in_value = true;
+            ++count;
+        }
+    }
+    return count;
+}
+
+
+//
+// Returns a pointer just past the first newline at or after start (or last). Since values never
+// span lines, no value straddles the returned boundary.
+//
+inline const char *SystemReader::chunk_boundary( const char *start, const char *last )
+{
+    const char *current = start;
+    while( current < last && *current != '\n' ) ++current;
+    return ( current < last ) ? current + 1 : last;
+}
+
+
+//
+// Converts the values in [first, last) in parallel. The value with index i (counting from
+// first) is passed to store( i, value ). Only the first needed_count values are converted.
+//
+template< typename FloatingType, typename Store >
+bool SystemReader::convert(
+    const char *first, const char *last, std::size_t needed_count, Store store, unsigned thread_count )
+{
+    const std::size_t range_size = last - first;
+
+    if( thread_count == 0 ) thread_count = default_thread_count( );
+    std::size_t chunk_count = range_size / minimum_chunk_size + 1;
+    if( chunk_count > thread_count ) chunk_count = thread_count;
+    used_thread_count = static_cast<unsigned>( chunk_count );
+
+    // Locate newline aligned chunk boundaries. Boundaries might coincide for tiny ranges.
+    std::vector< const char * > boundaries( chunk_count + 1 );
+    boundaries[0] = first;
+    for( std::size_t chunk = 1; chunk < chunk_count; ++chunk ) {
+        boundaries[chunk] = chunk_boundary( first + ( range_size * chunk ) / chunk_count, last );
+    }
+    boundaries[chunk_count] = last;
+
+    // First pass: count the values in each chunk so every chunk knows where its values go.
+    std::vector< std::size_t > first_index( chunk_count + 1, 0 );
+    parallel_for( 0, chunk_count,
+        [&]( std::size_t chunk )
+        {
+            first_index[chunk + 1] = count_values( boundaries[chunk], boundaries[chunk + 1] );
+        },
+        used_thread_count );
+    for( std::size_t chunk = 0; chunk < chunk_count; ++chunk ) {
+        first_index[chunk + 1] += first_index[chunk];
+    }
+    if( first_index[chunk_count] < needed_count ) return false;
+
+    // Second pass: convert the values in each chunk and store them into their final positions.
+    // Values beyond the end of the system (if any) are ignored, as with the iostream version.
+    std::atomic< bool > conversion_failed( false );
+    parallel_for( 0, chunk_count,
+        [&]( std::size_t chunk )
+        {
+            const char *current = boundaries[chunk];
+            const char *chunk_last = boundaries[chunk + 1];
+            std::size_t index = first_index[chunk];
+
+            while( index < needed_count ) {
+                while( current != chunk_last && is_space( *current ) ) ++current;
+                if( current == chunk_last ) break;
+                if( *current == '+' ) ++current;
+
+                FloatingType value;
+                std::from_chars_result result = std::from_chars( current, chunk_last, value );
+                if( result.ec != std::errc( ) ) {
+                    conversion_failed = true;
+                    return;
+                }
+                current = result.ptr;
+                store( index, value );
+                ++index;
+            }
+        },
+        used_thread_count );
+
+    return !conversion_failed;
+}
+
+
+//
+// Copies count values of the file's element type starting at source, converting them to
+// FloatingType if necessary.
+//
+template< typename FloatingType >
+void SystemReader::copy_values( const char *source, std::size_t count, FloatingType *destination ) const
+{
+    if( header.element_size == sizeof( FloatingType ) ) {
+        std::memcpy( destination, source, count * sizeof( FloatingType ) );
+    }
+    else if( header.element_size == sizeof( double ) ) {
+        const double *values = reinterpret_cast<const double *>( source );
+        for( std::size_t i = 0; i < count; ++i ) destination[i] = static_cast<FloatingType>( values[i] );
+    }
+    else {
+        const float *values = reinterpret_cast<const float *>( source );
+        for( std::size_t i = 0; i < count; ++i ) destination[i] = static_cast<FloatingType>( values[i] );
+    }
+}
+
+
+//
+// Copies row_count rows of a dense binary system, starting at first, in parallel.
+//
+template< typename FloatingType >
+bool SystemReader::read_binary_rows(
+    const char *first, std::size_t row_count, Matrix<FloatingType> &rows, FloatingType *b, unsigned thread_count )
+{
+    const std::size_t row_bytes = ( system_size + 1 ) * header.element_size;
+    if( first + row_count * row_bytes > file.data( ) + file.size( ) ) return false;
+
+    if( thread_count == 0 ) thread_count = default_thread_count( );
+    std::size_t chunk_count = ( row_count * row_bytes ) / minimum_chunk_size + 1;
+    if( chunk_count > thread_count ) chunk_count = thread_count;
+    used_thread_count = static_cast<unsigned>( std::min( chunk_count, std::max< std::size_t >( row_count, 1 ) ) );
+
+    parallel_for_ranges( 0, row_count,
+        [&]( std::size_t first_row, std::size_t last_row, unsigned )
+        {
+            for( std::size_t i = first_row; i < last_row; ++i ) {
+                const char *row = first + i * row_bytes;
+                copy_values( row, system_size, rows.get_row( i ) );
+                copy_values( row + system_size * header.element_size, 1, &b[i] );
+            }
+        },
+        used_thread_count );
+    return true;
+}
+
+
+template< typename FloatingType >
+bool SystemReader::read( Matrix<FloatingType> &a, FloatingType *b, unsigned thread_count )
+{
+    if( !is_open( ) ) return false;
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now( );
+
+    if( binary ) {
+        bool result;
+        if( is_sparse( ) ) {
+            // Scatter the stored elements into an otherwise zero matrix.
+            SparseMatrix<FloatingType> sparse;
+            result = read( sparse, b, thread_count );
+            if( result ) {
+                parallel_for( 0, system_size,
+                    [&]( std::size_t i )
+                    {
+                        FloatingType *row = a.get_row( i );
+                        for( std::size_t j = 0; j < system_size; ++j ) row[j] = FloatingType( 0 );
+                        for( std::size_t k = sparse.row_start( )[i]; k < sparse.row_start( )[i + 1]; ++k ) {
+                            row[sparse.column_index( )[k]] = sparse.values( )[k];
+                        }
+                    },
+                    used_thread_count );
+            }
+        }
+        else {
+            result = read_binary_rows( body, system_size, a, b, thread_count );
+        }
+        std::chrono::duration< double > elapsed = std::chrono::steady_clock::now( ) - start_time;
+        elapsed_seconds = elapsed.count( );
+        converted_bytes = file.size( );
+        return result;
+    }
+
+    const std::size_t row_length = system_size + 1;
+    bool result = convert< FloatingType >( body, file.data( ) + file.size( ), system_size * row_length,
+        [&]( std::size_t index, FloatingType value )
+        {
+            std::size_t row = index / row_length;
+            std::size_t column = index % row_length;
+            if( column < system_size ) {
+                a( row, column ) = value;
+            }
+            else {
+                b[row] = value;
+            }
+        },
+        thread_count );
+
+    std::chrono::duration< double > elapsed = std::chrono::steady_clock::now( ) - start_time;
+    elapsed_seconds = elapsed.count( );
+    converted_bytes = file.size( );
+    return result;
+}
+
+
+template< typename FloatingType >
+bool SystemReader::read( SparseMatrix<FloatingType> &a, FloatingType *b, unsigned thread_count )
+{
+    if( !is_open( ) ) return false;
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now( );
+
+    if( is_sparse( ) ) {
+        const std::size_t element_count = header.element_count;
+        const std::uint64_t *file_starts = reinterpret_cast<const std::uint64_t *>( body );
+        const std::uint64_t *file_columns = file_starts + system_size + 1;
+        const char *file_values = reinterpret_cast<const char *>( file_columns + element_count );
+
+        // Check the structure so that a damaged file can't cause out of bounds accesses later.
+        if( file_starts[0] != 0 || file_starts[system_size] != element_count ) return false;
+        for( std::size_t i = 0; i < system_size; ++i ) {
+            if( file_starts[i] > file_starts[i + 1] ) return false;
+            for( std::size_t k = file_starts[i]; k < file_starts[i + 1]; ++k ) {
+                if( file_columns[k] >= system_size ) return false;
+                if( k > file_starts[i] && file_columns[k] <= file_columns[k - 1] ) return false;
+            }
+        }
+
+        std::vector< std::size_t >  starts( file_starts, file_starts + system_size + 1 );
+        std::vector< std::size_t >  columns( file_columns, file_columns + element_count );
+        std::vector< FloatingType > values( element_count );
+        if( thread_count == 0 ) thread_count = default_thread_count( );
+        used_thread_count = static_cast<unsigned>( std::min< std::size_t >(
+            thread_count, ( element_count * header.element_size ) / minimum_chunk_size + 1 ) );
+        parallel_for_ranges( 0, element_count,
+            [&]( std::size_t first, std::size_t last, unsigned )
+            {
+                copy_values( file_values + first * header.element_size, last - first, values.data( ) + first );
+            },
+            used_thread_count );
+        copy_values( file_values + element_count * header.element_size, system_size, b );
+        a = SparseMatrix<FloatingType>( system_size, system_size, std::move( starts ), std::move( columns ), std::move( values ) );
+    }
+    else {
+        // Read the dense system a block of rows at a time, keeping only the non-zero elements.
+        const std::size_t block_rows = std::max< std::size_t >( 1, ( 8 * 1024 * 1024 ) / ( system_size + 1 ) );
+        std::vector< std::size_t >  starts( 1, 0 );
+        std::vector< std::size_t >  columns;
+        std::vector< FloatingType > values;
+        std::size_t byte_total = 0;
+
+        auto append_rows = [&]( Matrix<FloatingType> &block, std::size_t first_row ) -> bool
+        {
+            if( !read_rows( block, b + first_row, thread_count ) ) return false;
+            byte_total += converted_bytes;
+            for( std::size_t i = 0; i < block.row_count( ); ++i ) {
+                const FloatingType *row = block.get_row( i );
+                for( std::size_t j = 0; j < system_size; ++j ) {
+                    if( row[j] != FloatingType( 0 ) ) {
+                        columns.push_back( j );
+                        values.push_back( row[j] );
+                    }
+                }
+                starts.push_back( values.size( ) );
+            }
+            return true;
+        };
+
+        const char *saved_cursor = cursor;
+        cursor = body;
+        bool result = true;
+        const std::size_t full_blocks = system_size / block_rows;
+        if( full_blocks > 0 ) {
+            Matrix<FloatingType> block( block_rows, system_size );
+            for( std::size_t k = 0; result && k < full_blocks; ++k ) result = append_rows( block, k * block_rows );
+        }
+        if( result && system_size % block_rows != 0 ) {
+            Matrix<FloatingType> block( system_size % block_rows, system_size );
+            result = append_rows( block, full_blocks * block_rows );
+        }
+        if( !result ) {
+            cursor = saved_cursor;
+            return false;
+        }
+        cursor = saved_cursor;
+        a = SparseMatrix<FloatingType>( system_size, system_size, std::move( starts ), std::move( columns ), std::move( values ) );
+        converted_bytes = byte_total;
+    }
+
+    std::chrono::duration< double > elapsed = std::chrono::steady_clock::now( ) - start_time;
+    elapsed_seconds = elapsed.count( );
+    if( is_sparse( ) ) converted_bytes = file.size( );
+    return true;
+}
+
+
+template< typename FloatingType >
+bool SystemReader::read_rows( Matrix<FloatingType> &rows, FloatingType *b, unsigned thread_count )
+{
+    if( !is_open( ) ) return false;
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now( );
+
+    if( binary ) {
+        if( is_sparse( ) ) return false;
+        const std::size_t row_bytes = ( system_size + 1 ) * header.element_size;
+        bool result = read_binary_rows( cursor, rows.row_count( ), rows, b, thread_count );
+        if( result ) cursor += rows.row_count( ) * row_bytes;
+
+        std::chrono::duration< double > elapsed = std::chrono::steady_clock::now( ) - start_time;
+        elapsed_seconds = elapsed.count( );
+        converted_bytes = rows.row_count( ) * row_bytes;
+        return result;
+    }
+
+    // Find the end of the requested rows. This is a quick scan compared to the conversion.
+    const char *end = file.data( ) + file.size( );
+    const std::size_t row_length = system_size + 1;
+    const std::size_t needed_count = rows.row_count( ) * row_length;
+    const char *first = cursor;
+    const char *last = cursor;
+    std::size_t count = 0;
+    while( last != end && count < needed_count ) {
+        while( last != end && is_space( *last ) ) ++last;
+        if( last == end ) break;
+        ++count;
+        while( last != end && !is_space( *last ) ) ++last;
+    }
+    if( count < needed_count ) return false;
+
+    bool result = convert< FloatingType >( first, last, needed_count,
+        [&]( std::size_t index, FloatingType value )
+        {
+            std::size_t row = index / row_length;
+            std::size_t column = index % row_length;
+            if( column < system_size ) {
+                rows( row, column ) = value;
+            }
+            else {
+                b[row] = value;
+            }
+        },
+        thread_count );
+    cursor = last;
+
+    std::chrono::duration< double > elapsed = std::chrono::steady_clock::now( ) - start_time;
+    elapsed_seconds = elapsed.count( );
+    converted_bytes = last - first;
+    return result;
+}
+
+#endif
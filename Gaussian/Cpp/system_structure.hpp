@@ -0,0 +1,96 @@
+/*!
+    \file   system_structure.hpp
+    \brief  A quick scan of a system to find structure that a specialized solver can exploit.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    The scan looks at every element once (in parallel) and so costs O(n^2) operations, which is
+    negligible compared to the O(n^3) cost of a dense solve. It finds the bandwidths of the matrix
+    and whether the matrix is symmetric with a positive diagonal. The latter is necessary, but
+    not sufficient, for the matrix to be positive definite; the only practical way to find out
+    for sure is to attempt a Cholesky decomposition.
+*/
+
+#ifndef SYSTEM_STRUCTURE_HPP
+#define SYSTEM_STRUCTURE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "Matrix.hpp"
+#include "parallel_for.hpp"
+
+//! Describes the structure of a matrix.
+struct SystemStructure {
+    std::size_t lower_bandwidth;   //!< Largest i - j with a(i, j) != 0.
+    std::size_t upper_bandwidth;   //!< Largest j - i with a(i, j) != 0.
+    bool        symmetric;         //!< True if a(i, j) == a(j, i) for all i, j.
+    bool        positive_diagonal; //!< True if a(i, i) > 0 for all i.
+
+    //! Returns true if a banded solver is worthwhile.
+    /*!
+     *  The banded solver does roughly n * p * (p + q) operations compared to n^3 / 3 for a
+     *  dense solver, but it is less efficient per operation. Require a substantial gain.
+     */
+    bool is_banded( std::size_t size ) const
+    {
+        return 8 * ( 2 * lower_bandwidth + upper_bandwidth + 1 ) <= size;
+    }
+
+    //! Returns true if the matrix might be symmetric positive definite.
+    bool maybe_positive_definite( ) const { return symmetric && positive_diagonal; }
+};
+
+
+//! Scans a matrix to determine its structure.
+/*!
+ *  \param thread_count The maximum number of threads to use (zero means "all").
+ */
+template< typename FloatingType >
+SystemStructure analyze_structure( const Matrix<FloatingType> &a, unsigned thread_count = 0 )
+{
+    const std::size_t size = a.row_count( );
+    if( thread_count == 0 ) thread_count = default_thread_count( );
+    const unsigned threads = static_cast<unsigned>( std::min< std::size_t >( thread_count, size ) );
+
+    std::vector< SystemStructure > partial( threads );
+    parallel_for_ranges( 0, size,
+        [&]( std::size_t first, std::size_t last, unsigned thread_number )
+        {
+            SystemStructure result = { 0, 0, true, true };
+            for( std::size_t i = first; i < last; ++i ) {
+                const FloatingType *row = a.get_row( i );
+
+                // Find the first and last non-zero elements of the row.
+                std::size_t low = 0;
+                while( low < i && row[low] == FloatingType( 0 ) ) ++low;
+                std::size_t high = size - 1;
+                while( high > i && row[high] == FloatingType( 0 ) ) --high;
+                result.lower_bandwidth = std::max( result.lower_bandwidth, i - low );
+                result.upper_bandwidth = std::max( result.upper_bandwidth, high - i );
+
+                if( !( row[i] > FloatingType( 0 ) ) ) result.positive_diagonal = false;
+
+                if( result.symmetric ) {
+                    for( std::size_t j = 0; j < i; ++j ) {
+                        if( row[j] != a(j, i) ) {
+                            result.symmetric = false;
+                            break;
+                        }
+                    }
+                }
+            }
+            partial[thread_number] = result;
+        },
+        threads );
+
+    SystemStructure result = { 0, 0, true, true };
+    for( const SystemStructure &part : partial ) {
+        result.lower_bandwidth = std::max( result.lower_bandwidth, part.lower_bandwidth );
+        result.upper_bandwidth = std::max( result.upper_bandwidth, part.upper_bandwidth );
+        result.symmetric = result.symmetric && part.symmetric;
+        result.positive_diagonal = result.positive_diagonal && part.positive_diagonal;
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,232 @@
+/*!
+    \file   task_graph.hpp
+    \brief  A small work-stealing runtime for executing graphs of dependent tasks.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    A TaskGraph holds a collection of tasks and the dependencies between them. Calling run( )
+    executes every task exactly once on a team of threads, never starting a task before all of
+    its predecessors have finished. Unlike the fork/join style used elsewhere in this folder,
+    there are no global barriers: a task becomes ready the moment its last predecessor
+    finishes, so independent parts of the computation naturally overlap.
+
+    Each worker thread has its own queue of ready tasks. A worker takes work from the back of its
+    own queue (the most recently readied task, which is likely to use data still in the cache)
+    and, when its queue is empty, steals from the front of another worker's queue. Tasks marked
+    as urgent are placed in a shared queue that every worker checks first. This is used to keep
+    tasks on the critical path (such as the next panel factorization in an LU decomposition)
+    from waiting behind less important work.
+*/
+
+#ifndef TASK_GRAPH_HPP
+#define TASK_GRAPH_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "parallel_for.hpp"
+
+class TaskGraph {
+public:
+    typedef std::size_t task_id;
+
+    //! Adds a task to the graph and returns its identifier.
+    /*!
+     *  \param work The function to execute. It must not throw.
+     *  \param urgent If true the task is run ahead of ordinary tasks once it is ready.
+     */
+    task_id add_task( std::function< void( ) > work, bool urgent = false );
+
+    //! Specifies that 'after' may not start until 'before' has finished.
+    /*!
+     *  Both tasks must already be in the graph. Dependencies can only be added before run( ).
+     *  Adding the same dependency twice is harmless, but wasteful.
+     */
+    void add_dependency( task_id before, task_id after );
+
+    //! Returns the number of tasks in the graph.
+    std::size_t task_count( ) const { return tasks.size( ); }
+
+    //! Executes all tasks using up to thread_count threads (zero means "all").
+    /*!
+     *  The calling thread participates as one of the workers. This function returns when every
+     *  task has finished. A graph can only be run once. The dependencies must not form a cycle.
+     */
+    void run( unsigned thread_count = 0 );
+
+private:
+    struct Task {
+        std::function< void( ) > work;
+        std::vector< task_id >   successors;
+        std::atomic< std::size_t > pending;   // Number of predecessors not yet finished.
+        bool urgent;
+
+        Task( std::function< void( ) > w, bool u ) : work( w ), pending( 0 ), urgent( u ) { }
+    };
+
+    struct WorkQueue {
+        std::mutex            lock;
+        std::deque< task_id > ready;
+    };
+
+    std::vector< std::unique_ptr< Task > >      tasks;
+    std::vector< std::unique_ptr< WorkQueue > > queues;
+    WorkQueue urgent_queue;
+
+    std::atomic< std::size_t > ready_count;     // Tasks in any queue.
+    std::atomic< std::size_t > finished_count;  // Tasks that have completed.
+    std::atomic< unsigned >    sleeping_count;  // Workers waiting for work.
+    std::mutex                 sleep_lock;
+    std::condition_variable    wake_up;
+
+    void make_ready( task_id id, unsigned worker );
+    bool take_work( unsigned worker, task_id &id );
+    void worker_loop( unsigned worker );
+};
+
+
+inline TaskGraph::task_id TaskGraph::add_task( std::function< void( ) > work, bool urgent )
+{
+    tasks.push_back( std::unique_ptr< Task >( new Task( work, urgent ) ) );
+    return tasks.size( ) - 1;
+}
+
+
+inline void TaskGraph::add_dependency( task_id before, task_id after )
+{
+    tasks[before]->successors.push_back( after );
+    ++tasks[after]->pending;
+}
+
+
+//
+// Puts a task that has no more pending predecessors into the appropriate queue.
+//
+inline void TaskGraph::make_ready( task_id id, unsigned worker )
+{
+    WorkQueue &queue = tasks[id]->urgent ? urgent_queue : *queues[worker];
+    {
+        std::lock_guard< std::mutex > guard( queue.lock );
+        queue.ready.push_back( id );
+    }
+    ++ready_count;
+
+    // The sleeping worker (if any) holds sleep_lock between checking ready_count and waiting.
+    // Notifying while holding the lock ensures the wake up can't be lost.
+    if( sleeping_count > 0 ) {
+        std::lock_guard< std::mutex > guard( sleep_lock );
+        wake_up.notify_one( );
+    }
+}
+
+
+//
+// Finds a ready task: urgent tasks first, then the worker's own queue, then other queues.
+//
+inline bool TaskGraph::take_work( unsigned worker, task_id &id )
+{
+    {
+        std::lock_guard< std::mutex > guard( urgent_queue.lock );
+        if( !urgent_queue.ready.empty( ) ) {
+            id = urgent_queue.ready.front( );
+            urgent_queue.ready.pop_front( );
+            --ready_count;
+            return true;
+        }
+    }
+
+    {
+        WorkQueue &own = *queues[worker];
+        std::lock_guard< std::mutex > guard( own.lock );
+        if( !own.ready.empty( ) ) {
+            id = own.ready.back( );
+            own.ready.pop_back( );
+            --ready_count;
+            return true;
+        }
+    }
+
+    // Steal, starting with the next worker so that victims are spread around.
+    const unsigned worker_count = static_cast<unsigned>( queues.size( ) );
+    for( unsigned offset = 1; offset < worker_count; ++offset ) {
+        WorkQueue &victim = *queues[( worker + offset ) % worker_count];
+        std::lock_guard< std::mutex > guard( victim.lock );
+        if( !victim.ready.empty( ) ) {
+            id = victim.ready.front( );
+            victim.ready.pop_front( );
+            --ready_count;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+inline void TaskGraph::worker_loop( unsigned worker )
+{
+    const std::size_t total = tasks.size( );
+    task_id id;
+
+    while( finished_count < total ) {
+        if( take_work( worker, id ) ) {
+            Task &task = *tasks[id];
+            task.work( );
+            for( task_id successor : task.successors ) {
+                if( --tasks[successor]->pending == 0 ) make_ready( successor, worker );
+            }
+            if( ++finished_count == total ) {
+                std::lock_guard< std::mutex > guard( sleep_lock );
+                wake_up.notify_all( );
+            }
+        }
+        else {
+            // Nothing to do right now. Sleep until a task becomes ready or everything is done.
+            std::unique_lock< std::mutex > guard( sleep_lock );
+            ++sleeping_count;
+            while( ready_count == 0 && finished_count < total ) {
+                wake_up.wait( guard );
+            }
+            --sleeping_count;
+        }
+    }
+}
+
+
+inline void TaskGraph::run( unsigned thread_count )
+{
+    if( tasks.empty( ) ) return;
+    if( thread_count == 0 ) thread_count = default_thread_count( );
+
+    queues.clear( );
+    for( unsigned worker = 0; worker < thread_count; ++worker ) {
+        queues.push_back( std::unique_ptr< WorkQueue >( new WorkQueue ) );
+    }
+    ready_count = 0;
+    finished_count = 0;
+    sleeping_count = 0;
+
+    // Distribute the initially ready tasks over the workers.
+    unsigned next_worker = 0;
+    for( task_id id = 0; id < tasks.size( ); ++id ) {
+        if( tasks[id]->pending == 0 ) {
+            make_ready( id, next_worker );
+            next_worker = ( next_worker + 1 ) % thread_count;
+        }
+    }
+
+    std::vector< std::thread > workers;
+    for( unsigned worker = 1; worker < thread_count; ++worker ) {
+        workers.emplace_back( &TaskGraph::worker_loop, this, worker );
+    }
+    worker_loop( 0 );
+    for( std::thread &worker : workers ) {
+        worker.join( );
+    }
+}
+
+#endif
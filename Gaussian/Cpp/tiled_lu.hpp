@@ -0,0 +1,259 @@
+/*!
+    \file   tiled_lu.hpp
+    \brief  A tiled LU decomposition scheduled as a graph of dependent tasks.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    The parallel elimination in linear_equationsp.hpp (and the C versions using barriers) waits
+    for every thread at the end of every step. While the pivot row is being found and exchanged
+    all threads but one are idle. Here the matrix is divided into square tiles and the
+    factorization is expressed as three kinds of tasks:
+
+    + P(k): Factor panel k (the tiles in block column k, on or below the diagonal) using
+      partial pivoting.
+
+    + U(k, j): Apply the row exchanges of step k to block column j and compute the tile U(k, j)
+      of the upper triangular factor (a triangular solve).
+
+    + G(k, i, j): Update tile (i, j) with the product of tiles L(i, k) and U(k, j) (a GEMM).
+
+    Each task waits only for the tasks that produce the data it needs. The tasks that lead to the
+    next panel factorization are marked urgent so that panel k + 1 is factored while the rest of
+    the trailing update from step k is still in progress ("lookahead"). The tasks are executed by
+    the work-stealing runtime in task_graph.hpp.
+
+    The result has exactly the same form as that of lu_factor so lu_solve can be used with it.
+*/
+
+#ifndef TILED_LU_HPP
+#define TILED_LU_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "Matrix.hpp"
+#include "lu_decomposition.hpp"
+#include "parallel_for.hpp"
+#include "task_graph.hpp"
+
+namespace tiled_lu {
+
+    // Number of rows and columns in each tile.
+    const std::size_t tile_size = 128;
+
+    //! Describes the tiling of an n x n matrix.
+    struct Tiling {
+        std::size_t size;        // The size of the matrix.
+        std::size_t tile_count;  // The number of tiles in each row (and column) of tiles.
+
+        explicit Tiling( std::size_t n )
+            : size( n ), tile_count( ( n + tile_size - 1 ) / tile_size ) { }
+
+        std::size_t first( std::size_t tile ) const { return tile * tile_size; }
+        std::size_t last( std::size_t tile ) const { return std::min( ( tile + 1 ) * tile_size, size ); }
+    };
+
+
+    //! P(k): Factors block column k, rows k * tile_size .. n - 1, with partial pivoting.
+    /*!
+     *  Only the columns in block column k are exchanged. The exchanges are applied to the other
+     *  block columns by the U(k, j) tasks and by apply_left_exchanges.
+     */
+    template< typename FloatingType >
+    bool factor_panel(
+        Matrix<FloatingType> &a, std::size_t *pivots, const Tiling &tiling, std::size_t k, double threshold )
+    {
+        const std::size_t size = tiling.size;
+        const std::size_t column_first = tiling.first( k );
+        const std::size_t column_last = tiling.last( k );
+
+        for( std::size_t i = column_first; i < column_last; ++i ) {
+
+            // Find the row with the largest value of |a(j, i)|, j = i, ..., n - 1
+            std::size_t pivot = i;
+            FloatingType max = std::abs( a(i, i) );
+            for( std::size_t j = i + 1; j < size; ++j ) {
+                if( std::abs( a(j, i) ) > max ) {
+                    pivot = j;
+                    max = std::abs( a(j, i) );
+                }
+            }
+            if( max <= threshold ) return false;
+
+            pivots[i] = pivot;
+            if( pivot != i ) {
+                std::swap_ranges( &a(i, column_first), &a(i, column_first) + ( column_last - column_first ),
+                                  &a(pivot, column_first) );
+            }
+
+            const FloatingType *pivot_row = a.get_row( i );
+            const FloatingType  inverse = FloatingType( 1 ) / pivot_row[i];
+            for( std::size_t j = i + 1; j < size; ++j ) {
+                FloatingType *row = a.get_row( j );
+                const FloatingType factor = ( row[i] *= inverse );
+                for( std::size_t c = i + 1; c < column_last; ++c ) {
+                    row[c] -= factor * pivot_row[c];
+                }
+            }
+        }
+        return true;
+    }
+
+
+    //! U(k, j): Applies the exchanges of step k to block column j and computes tile U(k, j).
+    template< typename FloatingType >
+    void compute_u_tile( Matrix<FloatingType> &a, const std::size_t *pivots, const Tiling &tiling, std::size_t k, std::size_t j )
+    {
+        const std::size_t row_first = tiling.first( k );
+        const std::size_t row_last = tiling.last( k );
+        const std::size_t column_first = tiling.first( j );
+        const std::size_t width = tiling.last( j ) - column_first;
+
+        for( std::size_t i = row_first; i < row_last; ++i ) {
+            if( pivots[i] != i ) {
+                std::swap_ranges( &a(i, column_first), &a(i, column_first) + width, &a(pivots[i], column_first) );
+            }
+        }
+
+        // U(k, j) = inverse(L(k, k)) * A(k, j).
+        for( std::size_t i = row_first; i < row_last; ++i ) {
+            const FloatingType *source = &a(i, column_first);
+            for( std::size_t r = i + 1; r < row_last; ++r ) {
+                FloatingType *destination = &a(r, column_first);
+                const FloatingType factor = a(r, i);
+                for( std::size_t c = 0; c < width; ++c ) {
+                    destination[c] -= factor * source[c];
+                }
+            }
+        }
+    }
+
+
+    //! G(k, i, j): A(i, j) -= L(i, k) * U(k, j).
+    template< typename FloatingType >
+    void update_tile( Matrix<FloatingType> &a, const Tiling &tiling, std::size_t k, std::size_t i, std::size_t j )
+    {
+        const std::size_t inner_first = tiling.first( k );
+        const std::size_t inner_last = tiling.last( k );
+        const std::size_t column_first = tiling.first( j );
+        const std::size_t width = tiling.last( j ) - column_first;
+
+        for( std::size_t r = tiling.first( i ); r < tiling.last( i ); ++r ) {
+            FloatingType *destination = &a(r, column_first);
+            for( std::size_t p = inner_first; p < inner_last; ++p ) {
+                const FloatingType  factor = a(r, p);
+                const FloatingType *source = &a(p, column_first);
+                for( std::size_t c = 0; c < width; ++c ) {
+                    destination[c] -= factor * source[c];
+                }
+            }
+        }
+    }
+
+
+    //! Applies the exchanges made after block column j was factored to block column j.
+    template< typename FloatingType >
+    void apply_left_exchanges( Matrix<FloatingType> &a, const std::size_t *pivots, const Tiling &tiling, std::size_t j )
+    {
+        const std::size_t column_first = tiling.first( j );
+        const std::size_t width = tiling.last( j ) - column_first;
+
+        for( std::size_t i = tiling.last( j ); i < tiling.size; ++i ) {
+            if( pivots[i] != i ) {
+                std::swap_ranges( &a(i, column_first), &a(i, column_first) + width, &a(pivots[i], column_first) );
+            }
+        }
+    }
+
+}
+
+
+//! Factors a in place so that P*a = L*U using a tiled algorithm with dynamic scheduling.
+/*!
+ *  The results (and the meaning of the parameters) are the same as for lu_factor.
+ *
+ *  \return true if the factorization succeeded; false if the matrix is (nearly) singular.
+ */
+template< typename FloatingType >
+bool tiled_lu_factor( Matrix<FloatingType> &a, std::size_t *pivots, unsigned thread_count = 0 )
+{
+    using tiled_lu::Tiling;
+
+    // Make sure we are dealing with a square matrix.
+    assert( a.row_count( ) == a.col_count( ) );
+
+    const Tiling tiling( a.row_count( ) );
+    const std::size_t tiles = tiling.tile_count;
+    const double threshold = pivot_threshold( tiling.size, tiling.size, a.get_row( 0 ), tiling.size );
+    std::atomic< bool > failed( false );
+    TaskGraph graph;
+
+    // The identifiers of the G(k - 1, i, j) tasks from the previous step, indexed by i * tiles + j.
+    std::vector< TaskGraph::task_id > previous_updates( tiles * tiles );
+    std::vector< TaskGraph::task_id > current_updates( tiles * tiles );
+
+    for( std::size_t k = 0; k < tiles; ++k ) {
+
+        // P(k) waits for the last updates of block column k. It is always on the critical path.
+        TaskGraph::task_id panel = graph.add_task(
+            [&a, pivots, &tiling, &failed, k, threshold]( )
+            {
+                if( failed ) return;
+                if( !tiled_lu::factor_panel( a, pivots, tiling, k, threshold ) ) failed = true;
+            },
+            true );
+        if( k > 0 ) {
+            for( std::size_t i = k; i < tiles; ++i ) graph.add_dependency( previous_updates[i * tiles + k], panel );
+        }
+
+        for( std::size_t j = k + 1; j < tiles; ++j ) {
+
+            // Block column k + 1 holds the next panel; work on it is urgent (the lookahead).
+            const bool urgent = ( j == k + 1 );
+
+            // U(k, j) exchanges rows in all of block column j below row k, so it must wait for
+            // every update of that part of the block column from the previous step.
+            TaskGraph::task_id u_tile = graph.add_task(
+                [&a, pivots, &tiling, &failed, k, j]( )
+                {
+                    if( failed ) return;
+                    tiled_lu::compute_u_tile( a, pivots, tiling, k, j );
+                },
+                urgent );
+            graph.add_dependency( panel, u_tile );
+            if( k > 0 ) {
+                for( std::size_t i = k; i < tiles; ++i ) graph.add_dependency( previous_updates[i * tiles + j], u_tile );
+            }
+
+            for( std::size_t i = k + 1; i < tiles; ++i ) {
+                TaskGraph::task_id update = graph.add_task(
+                    [&a, &tiling, &failed, k, i, j]( )
+                    {
+                        if( failed ) return;
+                        tiled_lu::update_tile( a, tiling, k, i, j );
+                    },
+                    urgent );
+                graph.add_dependency( u_tile, update );
+                current_updates[i * tiles + j] = update;
+            }
+        }
+        previous_updates.swap( current_updates );
+    }
+
+    graph.run( thread_count );
+    if( failed ) return false;
+
+    // The panel factorizations only exchanged rows within their own block column. Now that all
+    // the exchanges are known, apply the later ones to the factored block columns of L.
+    parallel_for( 0, tiles,
+        [&a, pivots, &tiling]( std::size_t j )
+        {
+            tiled_lu::apply_left_exchanges( a, pivots, tiling, j );
+        },
+        thread_count );
+    return true;
+}
+
+#endif
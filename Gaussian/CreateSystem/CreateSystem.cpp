@@ -8,58 +8,390 @@
  *
  * Build this program using the command:
  *
- *    $ g++ -std=c++17 -o CreateSystem -Wall CreateSystem.cpp
+ *    $ g++ -std=c++17 -O2 -pthread -o CreateSystem -Wall CreateSystem.cpp
  *
  * Run the program to create a system of a certain size (say 100x100) using the command:
  *
  *    $ ./CreateSystem 100 > 100x100.dat
  *
+ * Options select the structure of the matrix (-k), the random seed (-s), the number of threads
+ * (-t), and binary rather than text output (-b). Run the program with no arguments for a
+ * summary. The structures are:
+ *
+ *    dense     Every coefficient is random in the range (-1.0, +1.0). This is the default.
+ *    dominant  As dense, but each diagonal element is larger than the sum of the magnitudes of
+ *              the other elements in its row.
+ *    spd       Symmetric and diagonally dominant with a positive diagonal, hence positive
+ *              definite.
+ *    banded    Diagonally dominant with non-zero elements only within -w positions of the
+ *              diagonal.
+ *    sparse    Diagonally dominant with the pattern of a five point finite difference grid of
+ *              about sqrt(size) x sqrt(size) points, plus -e random couplings per row. Even
+ *              one random coupling per row destroys the locality that makes sparse direct
+ *              solvers effective; use -e 0 (the default) for those.
+ *
+ * Every value is computed from the seed and its position alone (using a counter based random
+ * number generator) so the output doesn't depend on the number of threads. Rows are generated
+ * in parallel, in batches, and each batch is written while the next is generated. In binary
+ * mode (see ../C/system_file.h) banded and sparse systems are written in sparse form.
  */
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
-#include <iomanip>
-#include <iostream>
+#include <cstring>
+#include <future>
+#include <string>
+#include <vector>
+#include "../C/splitmix64.h"
+#include "../C/system_file.h"
+#include "../Cpp/parallel_for.hpp"
+
+enum class Structure { dense, dominant, spd, banded, sparse };
+
+struct Options {
+    std::size_t   size;
+    std::uint64_t seed;
+    unsigned      thread_count;
+    Structure     structure;
+    std::size_t   bandwidth;    // For banded systems.
+    std::size_t   extra;        // Random couplings per row for sparse systems.
+    bool          binary;
+};
+
+
+//! Generates the rows of a system. Every method can be called concurrently.
+class Generator {
+public:
+    explicit Generator( const Options &options );
+
+    //! Returns true if the matrix is stored as a sparse matrix in binary files.
+    bool is_sparse( ) const
+    {
+        return settings.structure == Structure::banded || settings.structure == Structure::sparse;
+    }
+
+    //! Computes row i in full. Returns the driving vector value.
+    double dense_row( std::size_t i, double *row, std::vector< std::size_t > &columns, std::vector< double > &values ) const;
+
+    //! Computes the non-zero elements of row i in order of increasing column. Returns the
+    //! driving vector value.
+    double sparse_row( std::size_t i, std::vector< std::size_t > &columns, std::vector< double > &values ) const;
+
+private:
+    Options     settings;
+    std::size_t grid_width;     // For sparse systems.
+
+    //! Returns a value in the range (-1.0, +1.0) determined by the seed and the key.
+    double uniform( std::uint64_t key ) const
+    {
+        return splitmix64_uniform( settings.seed, key );
+    }
+
+    // Coefficient (i, j). For spd systems the value depends only on the pair {i, j}.
+    double coefficient( std::size_t i, std::size_t j ) const
+    {
+        if( settings.structure == Structure::spd && j < i ) std::swap( i, j );
+        return uniform( static_cast<std::uint64_t>( i ) * ( settings.size + 1 ) + j );
+    }
+
+    double driving_value( std::size_t i ) const
+    {
+        return uniform( static_cast<std::uint64_t>( i ) * ( settings.size + 1 ) + settings.size );
+    }
+};
+
+
+Generator::Generator( const Options &options )
+    : settings( options ), grid_width( 1 )
+{
+    while( grid_width * grid_width < settings.size ) ++grid_width;
+}
 
-//! Generate a random double in the range -1.0 < x < 1.0
-double generate_value( )
+
+double Generator::dense_row(
+    std::size_t i, double *row, std::vector< std::size_t > &columns, std::vector< double > &values ) const
 {
-    double value = static_cast<double>( std::rand( ) ) / RAND_MAX;
-    return (2.0 * value) - 1.0;
+    const std::size_t n = settings.size;
+    if( is_sparse( ) ) {
+        std::fill( row, row + n, 0.0 );
+        const double b = sparse_row( i, columns, values );
+        for( std::size_t k = 0; k < columns.size( ); ++k ) row[columns[k]] = values[k];
+        return b;
+    }
+
+    double sum = 0.0;
+    for( std::size_t j = 0; j < n; ++j ) {
+        row[j] = coefficient( i, j );
+        if( j != i ) sum += std::fabs( row[j] );
+    }
+    if( settings.structure != Structure::dense ) row[i] = sum + 1.0;
+    return driving_value( i );
+}
+
+
+double Generator::sparse_row( std::size_t i, std::vector< std::size_t > &columns, std::vector< double > &values ) const
+{
+    const std::size_t n = settings.size;
+    columns.clear( );
+    values.clear( );
+
+    if( settings.structure == Structure::banded ) {
+        const std::size_t first = ( i > settings.bandwidth ) ? i - settings.bandwidth : 0;
+        const std::size_t last = std::min( i + settings.bandwidth + 1, n );
+        for( std::size_t j = first; j < last; ++j ) columns.push_back( j );
+    }
+    else if( settings.structure == Structure::sparse ) {
+        // Neighbors on the grid.
+        const std::size_t x = i % grid_width;
+        if( i >= grid_width ) columns.push_back( i - grid_width );
+        if( x > 0 ) columns.push_back( i - 1 );
+        columns.push_back( i );
+        if( x + 1 < grid_width && i + 1 < n ) columns.push_back( i + 1 );
+        if( i + grid_width < n ) columns.push_back( i + grid_width );
+
+        // Random long range couplings. Their columns come from a different part of the key
+        // space than the coefficient values.
+        for( std::size_t e = 0; e < settings.extra; ++e ) {
+            const double position = uniform( ~( static_cast<std::uint64_t>( i ) * settings.extra + e ) );
+            columns.push_back( std::min( n - 1, static_cast<std::size_t>( ( position + 1.0 ) * 0.5 * n ) ) );
+        }
+        std::sort( columns.begin( ), columns.end( ) );
+        columns.erase( std::unique( columns.begin( ), columns.end( ) ), columns.end( ) );
+    }
+    else {
+        for( std::size_t j = 0; j < n; ++j ) columns.push_back( j );
+    }
+
+    double sum = 0.0;
+    std::size_t diagonal = 0;
+    for( std::size_t j : columns ) {
+        values.push_back( coefficient( i, j ) );
+        if( j == i )
+            diagonal = values.size( ) - 1;
+        else
+            sum += std::fabs( values.back( ) );
+    }
+    if( settings.structure != Structure::dense ) values[diagonal] = sum + 1.0;
+    return driving_value( i );
+}
+
+
+//
+// Calls emit( row, output, columns, values ) for every row, in parallel batches, and writes the
+// output of each batch in row order. The writing of a batch overlaps the generation of the
+// next one. Returns false if there was an error writing.
+//
+template< typename Emit >
+bool write_rows( std::size_t row_count, std::size_t row_bytes, unsigned thread_count, Emit emit )
+{
+    // Aim for batches of about 16 MB per thread.
+    const std::size_t batch_rows = std::max< std::size_t >( 1, ( thread_count * 16 * 1024 * 1024 ) / row_bytes );
+
+    std::vector< std::string > buffers[2] = {
+        std::vector< std::string >( thread_count ), std::vector< std::string >( thread_count ) };
+    std::future< bool > writing;
+    bool success = true;
+    int current = 0;
+
+    for( std::size_t batch_first = 0; batch_first < row_count; batch_first += batch_rows ) {
+        const std::size_t batch_last = std::min( batch_first + batch_rows, row_count );
+        std::vector< std::string > &batch = buffers[current];
+        for( std::string &buffer : batch ) buffer.clear( );
+
+        parallel_for_ranges( batch_first, batch_last,
+            [&]( std::size_t first, std::size_t last, unsigned thread_number )
+            {
+                std::vector< std::size_t > columns;
+                std::vector< double > values;
+                for( std::size_t i = first; i < last; ++i ) emit( i, batch[thread_number], columns, values );
+            },
+            thread_count );
+
+        // The ranges are assigned to threads in order so the buffers are in row order.
+        if( writing.valid( ) && !writing.get( ) ) success = false;
+        writing = std::async( std::launch::async,
+            [&batch]( )
+            {
+                for( const std::string &buffer : batch ) {
+                    if( std::fwrite( buffer.data( ), 1, buffer.size( ), stdout ) != buffer.size( ) ) return false;
+                }
+                return true;
+            } );
+        current = 1 - current;
+    }
+    if( writing.valid( ) && !writing.get( ) ) success = false;
+    return success;
+}
+
+
+//
+// Appends a value in the format "%18.15f\n", as the original version did with iostreams.
+//
+void append_value( std::string &output, double value )
+{
+    char buffer[64];
+    std::to_chars_result result = std::to_chars( buffer, buffer + sizeof( buffer ), value, std::chars_format::fixed, 15 );
+    const std::size_t length = result.ptr - buffer;
+    if( length < 18 ) output.append( 18 - length, ' ' );
+    output.append( buffer, length );
+    output.push_back( '\n' );
+}
+
+
+template< typename T >
+void append_binary( std::string &output, const T *data, std::size_t count )
+{
+    output.append( reinterpret_cast<const char *>( data ), count * sizeof( T ) );
+}
+
+
+bool write_text( const Options &options, const Generator &generator )
+{
+    const std::size_t n = options.size;
+    std::string first_line = std::to_string( n ) + "\n";
+    if( std::fwrite( first_line.data( ), 1, first_line.size( ), stdout ) != first_line.size( ) ) return false;
+
+    return write_rows( n, ( n + 1 ) * 19, options.thread_count,
+        [&]( std::size_t i, std::string &output, std::vector< std::size_t > &columns, std::vector< double > &values )
+        {
+            std::vector< double > row( n );
+            const double b = generator.dense_row( i, row.data( ), columns, values );
+            for( double value : row ) append_value( output, value );
+            append_value( output, b );
+        } );
+}
+
+
+bool write_binary( const Options &options, const Generator &generator )
+{
+    const std::size_t n = options.size;
+    system_file_header header;
+
+    if( !generator.is_sparse( ) ) {
+        system_file_init_header( &header, n, sizeof( double ), 0, 0 );
+        if( std::fwrite( &header, sizeof( header ), 1, stdout ) != 1 ) return false;
+        return write_rows( n, ( n + 1 ) * sizeof( double ), options.thread_count,
+            [&]( std::size_t i, std::string &output, std::vector< std::size_t > &columns, std::vector< double > &values )
+            {
+                std::vector< double > row( n + 1 );
+                row[n] = generator.dense_row( i, row.data( ), columns, values );
+                append_binary( output, row.data( ), n + 1 );
+            } );
+    }
+
+    // A sparse file is written in sections, so each row is generated once per section. The
+    // row lengths are needed first to compute the row start positions.
+    std::vector< std::uint64_t > row_start( n + 1, 0 );
+    parallel_for_ranges( 0, n,
+        [&]( std::size_t first, std::size_t last, unsigned )
+        {
+            std::vector< std::size_t > columns;
+            std::vector< double > values;
+            for( std::size_t i = first; i < last; ++i ) {
+                generator.sparse_row( i, columns, values );
+                row_start[i + 1] = columns.size( );
+            }
+        },
+        options.thread_count );
+    for( std::size_t i = 0; i < n; ++i ) row_start[i + 1] += row_start[i];
+
+    system_file_init_header( &header, n, sizeof( double ), 1, row_start[n] );
+    if( std::fwrite( &header, sizeof( header ), 1, stdout ) != 1 ) return false;
+    if( std::fwrite( row_start.data( ), sizeof( std::uint64_t ), n + 1, stdout ) != n + 1 ) return false;
+
+    const std::size_t row_bytes = ( row_start[n] / n + 1 ) * sizeof( double );
+    bool success = write_rows( n, row_bytes, options.thread_count,
+        [&]( std::size_t i, std::string &output, std::vector< std::size_t > &columns, std::vector< double > &values )
+        {
+            generator.sparse_row( i, columns, values );
+            for( std::size_t j : columns ) {
+                const std::uint64_t column = j;
+                append_binary( output, &column, 1 );
+            }
+        } );
+    success = success && write_rows( n, row_bytes, options.thread_count,
+        [&]( std::size_t i, std::string &output, std::vector< std::size_t > &columns, std::vector< double > &values )
+        {
+            generator.sparse_row( i, columns, values );
+            append_binary( output, values.data( ), values.size( ) );
+        } );
+    return success && write_rows( n, sizeof( double ), options.thread_count,
+        [&]( std::size_t i, std::string &output, std::vector< std::size_t > &columns, std::vector< double > &values )
+        {
+            const double b = generator.sparse_row( i, columns, values );
+            append_binary( output, &b, 1 );
+        } );
 }
 
 
 int main( int argc, char **argv )
 {
-    int size;
+    Options options = { 0, 1, 0, Structure::dense, 2, 0, false };
+    const char *size_argument = 0;
+    bool valid = true;
+
+    for( int i = 1; i < argc && valid; ++i ) {
+        if( std::strcmp( argv[i], "-k" ) == 0 && i + 1 < argc ) {
+            const char *kind = argv[++i];
+            if( std::strcmp( kind, "dense" ) == 0 ) options.structure = Structure::dense;
+            else if( std::strcmp( kind, "dominant" ) == 0 ) options.structure = Structure::dominant;
+            else if( std::strcmp( kind, "spd" ) == 0 ) options.structure = Structure::spd;
+            else if( std::strcmp( kind, "banded" ) == 0 ) options.structure = Structure::banded;
+            else if( std::strcmp( kind, "sparse" ) == 0 ) options.structure = Structure::sparse;
+            else valid = false;
+        }
+        else if( std::strcmp( argv[i], "-s" ) == 0 && i + 1 < argc ) {
+            options.seed = std::strtoull( argv[++i], 0, 10 );
+        }
+        else if( std::strcmp( argv[i], "-t" ) == 0 && i + 1 < argc ) {
+            options.thread_count = static_cast<unsigned>( std::strtoul( argv[++i], 0, 10 ) );
+        }
+        else if( std::strcmp( argv[i], "-w" ) == 0 && i + 1 < argc ) {
+            options.bandwidth = std::strtoul( argv[++i], 0, 10 );
+        }
+        else if( std::strcmp( argv[i], "-e" ) == 0 && i + 1 < argc ) {
+            options.extra = std::strtoul( argv[++i], 0, 10 );
+        }
+        else if( std::strcmp( argv[i], "-b" ) == 0 ) {
+            options.binary = true;
+        }
+        else if( size_argument == 0 ) {
+            size_argument = argv[i];
+        }
+        else {
+            valid = false;
+        }
+    }
 
     // Check command line validity.
-    if( argc != 2 ) {
-        std::cerr << "Usage: " << argv[0] << " size" << std::endl;
+    if( !valid || size_argument == 0 ) {
+        std::fprintf( stderr,
+            "Usage: %s [-k dense|dominant|spd|banded|sparse] [-s seed] [-t threads] [-w bandwidth] [-e extra] [-b] size\n",
+            argv[0] );
         return EXIT_FAILURE;
     }
 
     // Convert size argument to an integer.
-    size = std::atoi( argv[1] );
+    long long size = std::atoll( size_argument );
 
     // Check the sanity of the size argument.
     // TODO: Check against a reasonable upper bound also?
     if( size <= 0 ) {
-        std::cerr << "Invalid system size specified: " << size << std::endl;
+        std::fprintf( stderr, "Invalid system size specified: %lld\n", size );
         return EXIT_FAILURE;
     }
+    options.size = static_cast<std::size_t>( size );
+    if( options.thread_count == 0 ) options.thread_count = default_thread_count( );
 
-    std::cout << size << std::endl;
-
-    // For each equation...
-    for( int i = 1; i <= size; ++i ) {
-
-        // Output a coefficient for each unknown.
-        for( int j = 1; j <= size; ++j ) {
-            std::cout << std::setw( 18 ) << std::setprecision( 15 ) << std::fixed << generate_value( ) << std::endl;
-        }
-
-        // Output the driving vector value for this equation.
-        std::cout << std::setw( 18 ) << std::setprecision( 15 ) << std::fixed << generate_value( ) << std::endl;
+    Generator generator( options );
+    const bool success = options.binary ? write_binary( options, generator ) : write_text( options, generator );
+    if( !success || std::fflush( stdout ) != 0 ) {
+        std::fprintf( stderr, "Error writing the system.\n" );
+        return EXIT_FAILURE;
     }
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,82 @@
+/*!
+ * \file   backend.h
+ * \brief  The common interface to the solvers in libgaussian.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * Each version of the solver has its own interface (different parameter types, different
+ * result codes, and sometimes extra arguments such as a thread pool). The adapters declared
+ * here wrap each version in the same interface. Several versions use the same names for their
+ * internal functions, so each adapter is compiled as a separate translation unit that includes
+ * the source of the version it wraps with those names changed.
+ *
+ * The parallel versions decide how many threads to use by calling gaussian_thread_count (see
+ * ../C/thread_count.h). The benchmark driver sets GAUSSIAN_THREADS before each run rather than
+ * passing the thread count through this interface.
+ *
+ * This header is internal to the library and to the benchmark driver. Programs that only want
+ * to solve systems should use the stable interface in libgaussian.h.
+ */
+
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Flags.
+#define BACKEND_THREADED  0x0001u   // The backend uses GAUSSIAN_THREADS threads.
+#define BACKEND_MPI       0x0002u   // Every MPI process must call the backend.
+#define BACKEND_EXCLUSIVE 0x0004u   // The backend uses global state; only one solve at a time.
+
+//! A solver.
+/*!
+ * The solve function solves a x = b in place; a is size x size in row-major order. On success
+ * it returns zero and b holds the solution (on every process for an MPI backend, only rank
+ * zero's b is used). If prepare is not NULL it is called (outside the timed region) before
+ * the runs with a given thread count and release is called after them.
+ */
+struct Backend {
+    const char *name;
+    const char *description;
+    unsigned    flags;
+    int  ( *solve )( size_t size, double *a, double *b );
+    int  ( *prepare )( int thread_count );
+    void ( *release )( void );
+};
+
+//! Every backend in the library, in order from the simplest to the most elaborate.
+extern const struct Backend backend_table[];
+extern const size_t         backend_count;
+
+//! Returns the backend with the given name or NULL if there is no such backend.
+const struct Backend *backend_find( const char *name );
+
+int backend_serial( size_t size, double *a, double *b );
+int backend_vla( size_t size, double *a, double *b );
+int backend_pthreads( size_t size, double *a, double *b );
+int backend_openmp( size_t size, double *a, double *b );
+int backend_barriers( size_t size, double *a, double *b );
+int backend_bidirectional( size_t size, double *a, double *b );
+
+int  backend_pool_1( size_t size, double *a, double *b );
+int  backend_pool_2( size_t size, double *a, double *b );
+int  backend_pool_prepare( int thread_count );
+void backend_pool_release( void );
+
+int backend_cpp_serial( size_t size, double *a, double *b );
+int backend_cpp_parallel( size_t size, double *a, double *b );
+int backend_cpp_lu( size_t size, double *a, double *b );
+
+#ifdef GAUSSIAN_MPI
+int backend_mpi( size_t size, double *a, double *b );
+int backend_mpi_2d( size_t size, double *a, double *b );
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
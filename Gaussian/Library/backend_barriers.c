@@ -0,0 +1,17 @@
+/*!
+ * \file   backend_barriers.c
+ * \brief  Backend adapter for ../C/linear_equations-barriers.c.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ */
+
+#define row_processor barriers_row_processor
+#define work_ready    barriers_work_ready
+#define work_finished barriers_work_finished
+#include "../C/linear_equations-barriers.c"
+
+#include "backend.h"
+
+int backend_barriers( size_t size, double *a, double *b )
+{
+    return gaussian_solve_barriers( (int)size, a, b );
+}
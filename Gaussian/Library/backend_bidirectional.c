@@ -0,0 +1,16 @@
+/*!
+ * \file   backend_bidirectional.c
+ * \brief  Backend adapter for ../C/linear_equations-bidirectional.c.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ */
+
+#define work_ready    bidirectional_work_ready
+#define work_finished bidirectional_work_finished
+#include "../C/linear_equations-bidirectional.c"
+
+#include "backend.h"
+
+int backend_bidirectional( size_t size, double *a, double *b )
+{
+    return gaussian_solve_bidirectional( (int)size, a, b );
+}
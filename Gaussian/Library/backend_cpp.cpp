@@ -0,0 +1,28 @@
+/*!
+    \file   backend_cpp.cpp
+    \brief  Backend adapters for the serial C++ solver and the C++ LU decomposition.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+*/
+
+#include <vector>
+#include "../Cpp/linear_equations.hpp"
+#include "../Cpp/lu_decomposition.hpp"
+#include "../Cpp/parallel_for.hpp"
+#include "backend.h"
+
+int backend_cpp_serial( std::size_t size, double *a, double *b )
+{
+    // The solver works in place on a Matrix that views the caller's array.
+    Matrix<double> m( a, size, size );
+    return gaussian_solve( m, b ) ? 0 : -1;
+}
+
+
+int backend_cpp_lu( std::size_t size, double *a, double *b )
+{
+    Matrix<double> m( a, size, size );
+    std::vector< std::size_t > pivots( size );
+    if( !lu_factor( m, pivots.data( ), default_thread_count( ) ) ) return -1;
+    lu_solve( m, pivots.data( ), b, 1, default_thread_count( ) );
+    return 0;
+}
@@ -0,0 +1,32 @@
+/*!
+    \file   backend_cpp_parallel.cpp
+    \brief  Backend adapter for the parallel C++ solver.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    The parallel solver uses the same function template names (and the same include guard) as
+    the serial one in backend_cpp.cpp. Since the template instances would have identical names
+    the parallel version is placed in its own namespace. Its headers are included first so that
+    they are not themselves placed in that namespace.
+*/
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <boost/scoped_array.hpp>
+#include "../Cpp/Matrix.hpp"
+#include "../Cpp/parallel_for.hpp"
+#include "../C/pivot_threshold.h"
+#include "../C/triangular_solve.h"
+#include "ThreadPool.hpp"
+
+namespace parallel {
+    #include "../Cpp/linear_equationsp.hpp"
+}
+
+#include "backend.h"
+
+int backend_cpp_parallel( std::size_t size, double *a, double *b )
+{
+    Matrix<double> m( a, size, size );
+    return parallel::gaussian_solve( m, b ) ? 0 : -1;
+}
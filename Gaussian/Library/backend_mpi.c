@@ -0,0 +1,25 @@
+/*!
+ * \file   backend_mpi.c
+ * \brief  Backend adapter for the version in ../MPI.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * Every process must call backend_mpi with the same system. Each process updates its rows
+ * with GAUSSIAN_THREADS OpenMP threads (when OpenMP is enabled).
+ */
+
+#define gaussian_solve mpi_gaussian_solve
+#include "../MPI/linear_equations.c"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "../C/thread_count.h"
+#include "backend.h"
+
+int backend_mpi( size_t size, double *a, double *b )
+{
+    #ifdef _OPENMP
+    omp_set_num_threads( gaussian_thread_count( ) );
+    #endif
+    return mpi_gaussian_solve( (int)size, a, b );
+}
@@ -0,0 +1,24 @@
+/*!
+ * \file   backend_mpi_2d.c
+ * \brief  Backend adapter for the two dimensional grid version in ../MPI.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * Every process must call backend_mpi_2d with the same system. The shape of the process grid
+ * can be set with GAUSSIAN_GRID (see ../MPI/linear_equations.h).
+ */
+
+#include "../MPI/linear_equations-2d.c"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "../C/thread_count.h"
+#include "backend.h"
+
+int backend_mpi_2d( size_t size, double *a, double *b )
+{
+    #ifdef _OPENMP
+    omp_set_num_threads( gaussian_thread_count( ) );
+    #endif
+    return gaussian_solve_2d( (int)size, a, b );
+}
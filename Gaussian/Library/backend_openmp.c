@@ -0,0 +1,18 @@
+/*!
+ * \file   backend_openmp.c
+ * \brief  Backend adapter for the version in ../C/Parallel-OpenMP.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ */
+
+#define gaussian_solve    openmp_gaussian_solve
+#define elimination       openmp_elimination
+#define back_substitution openmp_back_substitution
+#define update_rows       openmp_update_rows
+#include "../C/Parallel-OpenMP/gaussian.c"
+
+#include "backend.h"
+
+int backend_openmp( size_t size, double *a, double *b )
+{
+    return openmp_gaussian_solve( size, (floating_type (*)[size])a, b ) == gaussian_success ? 0 : -1;
+}
@@ -0,0 +1,31 @@
+/*!
+ * \file   backend_pool_1.c
+ * \brief  Backend adapter for ../C/linear_equations-pool-1.c.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * This file also owns the thread pool used by both thread pool versions. The pool is created
+ * by the prepare function, outside any timed region, and kept while the backend is in use so
+ * that only the cost of handing work to it is measured.
+ */
+
+#include "../C/linear_equations-pool-1.c"
+
+#include "backend.h"
+
+ThreadPool backend_pool;
+
+int backend_pool_prepare( int thread_count )
+{
+    ThreadPool_initialize( &backend_pool, thread_count );
+    return 0;
+}
+
+void backend_pool_release( void )
+{
+    ThreadPool_destroy( &backend_pool );
+}
+
+int backend_pool_1( size_t size, double *a, double *b )
+{
+    return gaussian_solve_pool_1( &backend_pool, (int)size, a, b );
+}
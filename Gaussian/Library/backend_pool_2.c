@@ -0,0 +1,17 @@
+/*!
+ * \file   backend_pool_2.c
+ * \brief  Backend adapter for ../C/linear_equations-pool-2.c.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ */
+
+#include "../C/linear_equations-pool-2.c"
+
+#include "backend.h"
+
+// Defined in backend_pool_1.c.
+extern ThreadPool backend_pool;
+
+int backend_pool_2( size_t size, double *a, double *b )
+{
+    return gaussian_solve_pool_2( &backend_pool, (int)size, a, b );
+}
@@ -0,0 +1,18 @@
+/*!
+ * \file   backend_pthreads.c
+ * \brief  Backend adapter for the version in ../C/Parallel-pthreads.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ */
+
+#define gaussian_solve    pthreads_gaussian_solve
+#define elimination       pthreads_elimination
+#define back_substitution pthreads_back_substitution
+#define process_rows      pthreads_process_rows
+#include "../C/Parallel-pthreads/gaussian.c"
+
+#include "backend.h"
+
+int backend_pthreads( size_t size, double *a, double *b )
+{
+    return pthreads_gaussian_solve( size, (floating_type (*)[size])a, b ) == gaussian_success ? 0 : -1;
+}
@@ -0,0 +1,15 @@
+/*!
+ * \file   backend_serial.c
+ * \brief  Backend adapter for the version in ../C/Serial.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ */
+
+#define gaussian_solve serial_gaussian_solve
+#include "../C/Serial/gaussian.c"
+
+#include "backend.h"
+
+int backend_serial( size_t size, double *a, double *b )
+{
+    return serial_gaussian_solve( size, a, b ) == gaussian_success ? 0 : -1;
+}
@@ -0,0 +1,17 @@
+/*!
+ * \file   backend_vla.c
+ * \brief  Backend adapter for the version in ../C/Parallel-VLA.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ */
+
+#define gaussian_solve    vla_gaussian_solve
+#define elimination       vla_elimination
+#define back_substitution vla_back_substitution
+#include "../C/Parallel-VLA/gaussian.c"
+
+#include "backend.h"
+
+int backend_vla( size_t size, double *a, double *b )
+{
+    return vla_gaussian_solve( size, (floating_type (*)[size])a, b ) == gaussian_success ? 0 : -1;
+}
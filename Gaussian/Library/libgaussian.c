@@ -0,0 +1,436 @@
+/*!
+ * \file   libgaussian.c
+ * \brief  The backend table, backend selection, and calibration.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * Calibration times each backend (except the MPI backends, which need the cooperation of every
+ * process) on a random, diagonally dominant system with min(size, CALIBRATION_LIMIT) unknowns.
+ * The winner is remembered for every size with the same number of bits, so a program that
+ * solves many systems of about the same size pays for the calibration once. Sizes from
+ * CALIBRATION_LIMIT up share one calibration since they would all be timed on the same system.
+ * Systems smaller than CALIBRATION_MINIMUM are too small for threads to help and go to the
+ * serial backend.
+ */
+
+// Needed for clock_gettime.
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef GAUSSIAN_MPI
+#include <mpi.h>
+#endif
+
+#include "../C/splitmix64.h"
+#include "../C/thread_count.h"
+#include "backend.h"
+#include "libgaussian.h"
+
+// Systems with fewer unknowns than this aren't calibrated.
+#define CALIBRATION_MINIMUM 64
+
+// Calibration systems have at most this many unknowns.
+#define CALIBRATION_LIMIT 384
+
+// Each backend is run once untimed and then this many times; the fastest run counts.
+#define CALIBRATION_RUNS 2
+
+// Enough buckets for any size below CALIBRATION_LIMIT, and one for the rest.
+#define CALIBRATION_BUCKETS ( 8 * sizeof( size_t ) + 1 )
+
+#define DEFAULT_BACKEND "serial"
+
+const struct Backend backend_table[] = {
+    #ifdef GAUSSIAN_MPI
+    { "mpi",           "MPI, cyclic rows with lookahead (MPI)",                    BACKEND_THREADED | BACKEND_MPI | BACKEND_EXCLUSIVE, backend_mpi,    NULL, NULL },
+    { "mpi-2d",        "MPI, 2D block cyclic process grid (MPI)",                  BACKEND_THREADED | BACKEND_MPI | BACKEND_EXCLUSIVE, backend_mpi_2d, NULL, NULL },
+    #endif
+    { "serial",        "C, one thread (C/Serial)",                                 0,                                    backend_serial,        NULL, NULL },
+    { "vla",           "C with variable length arrays (C/Parallel-VLA)",           0,                                    backend_vla,           NULL, NULL },
+    { "pthreads",      "C, threads created on each pass (C/Parallel-pthreads)",    BACKEND_THREADED,                     backend_pthreads,      NULL, NULL },
+    { "openmp",        "C, OpenMP tasks (C/Parallel-OpenMP)",                      BACKEND_THREADED,                     backend_openmp,        NULL, NULL },
+    { "barriers",      "C, persistent threads and barriers",                       BACKEND_THREADED | BACKEND_EXCLUSIVE, backend_barriers,      NULL, NULL },
+    { "bidirectional", "C, barriers with alternating row order",                   BACKEND_THREADED | BACKEND_EXCLUSIVE, backend_bidirectional, NULL, NULL },
+    { "pool-1",        "C, Spica thread pool",                                     BACKEND_THREADED | BACKEND_EXCLUSIVE, backend_pool_1, backend_pool_prepare, backend_pool_release },
+    { "pool-2",        "C, Spica thread pool with alternating row order",          BACKEND_THREADED | BACKEND_EXCLUSIVE, backend_pool_2, backend_pool_prepare, backend_pool_release },
+    { "cpp-serial",    "C++, one thread (Cpp/linear_equations.hpp)",               0,                                    backend_cpp_serial,    NULL, NULL },
+    { "cpp-parallel",  "C++, Spica thread pool (Cpp/linear_equationsp.hpp)",       BACKEND_THREADED,                     backend_cpp_parallel,  NULL, NULL },
+    { "cpp-lu",        "C++, blocked LU decomposition (Cpp/lu_decomposition.hpp)", BACKEND_THREADED,                     backend_cpp_lu,        NULL, NULL },
+};
+
+const size_t backend_count = sizeof( backend_table ) / sizeof( backend_table[0] );
+
+// The state of the calibration of one bucket of sizes.
+enum CalibrationState { CALIBRATION_NONE, CALIBRATION_RUNNING, CALIBRATION_DONE };
+
+// Protects the selection and the calibration results. It is never held while a system is solved.
+static pthread_mutex_t state_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  calibration_finished = PTHREAD_COND_INITIALIZER;
+static int selection_made = 0;
+static const struct Backend *selected = NULL;   // NULL means automatic.
+static enum CalibrationState calibration_state[CALIBRATION_BUCKETS];
+static const struct Backend *calibrated[CALIBRATION_BUCKETS];
+
+// Held shared by every solve, and exclusively while an exclusive backend runs or while the
+// backends are calibrated (so that other solves don't disturb the timing). Waiting writers are
+// preferred so a steady stream of solves can't hold off calibration. Also protects the
+// prepared backend.
+static pthread_rwlock_t exclusive_lock;
+static pthread_once_t   exclusive_lock_once = PTHREAD_ONCE_INIT;
+static int  ( *prepared )( int ) = NULL;
+static void ( *prepared_release )( void ) = NULL;
+static int  prepared_thread_count = 0;
+
+
+const struct Backend *backend_find( const char *name )
+{
+    for( size_t i = 0; i < backend_count; ++i ) {
+        if( strcmp( backend_table[i].name, name ) == 0 ) return &backend_table[i];
+    }
+    return NULL;
+}
+
+
+//! Releases the resources of the prepared backend, if any. Called with exclusive_lock held.
+static void release_prepared( void )
+{
+    if( prepared_release != NULL ) prepared_release( );
+    prepared = NULL;
+    prepared_release = NULL;
+    prepared_thread_count = 0;
+}
+
+
+static void initialize_exclusive_lock( void )
+{
+    pthread_rwlockattr_t attributes;
+    pthread_rwlockattr_init( &attributes );
+    pthread_rwlockattr_setkind_np( &attributes, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP );
+    pthread_rwlock_init( &exclusive_lock, &attributes );
+    pthread_rwlockattr_destroy( &attributes );
+}
+
+
+static void release_at_exit( void )
+{
+    pthread_rwlock_wrlock( &exclusive_lock );
+    release_prepared( );
+    pthread_rwlock_unlock( &exclusive_lock );
+}
+
+
+//! Returns true if the backend must have exclusive_lock to itself.
+static int is_exclusive( const struct Backend *backend )
+{
+    return ( backend->flags & BACKEND_EXCLUSIVE ) != 0 || backend->prepare != NULL;
+}
+
+
+//! Returns true if the backend can be used by this process.
+static int is_available( const struct Backend *backend )
+{
+    #ifdef GAUSSIAN_MPI
+    // Outside of an MPI program the MPI backends would abort the whole process.
+    if( backend->flags & BACKEND_MPI ) {
+        int initialized = 0;
+        int finalized = 0;
+        MPI_Initialized( &initialized );
+        MPI_Finalized( &finalized );
+        return initialized && !finalized;
+    }
+    #else
+    (void)backend;
+    #endif
+    return 1;
+}
+
+
+//! Runs one backend. Prepares it first if it needs preparation that hasn't been done.
+/*!
+ * The caller holds exclusive_lock: exclusively if the backend is exclusive, otherwise shared.
+ */
+static int run_backend_locked( const struct Backend *backend, size_t size, double *a, double *b )
+{
+    int result = GAUSSIAN_SUCCESS;
+
+    // Backends that share a prepare function (the two pool versions) share what it prepares.
+    if( backend->prepare != NULL ) {
+        static int exit_handler_registered = 0;
+        const int thread_count = gaussian_thread_count( );
+
+        if( prepared != backend->prepare || prepared_thread_count != thread_count ) {
+            release_prepared( );
+            if( backend->prepare( thread_count ) != 0 ) {
+                result = GAUSSIAN_UNAVAILABLE;
+            }
+            else {
+                prepared = backend->prepare;
+                prepared_release = backend->release;
+                prepared_thread_count = thread_count;
+                if( !exit_handler_registered ) {
+                    atexit( release_at_exit );
+                    exit_handler_registered = 1;
+                }
+            }
+        }
+    }
+    if( result == GAUSSIAN_SUCCESS && backend->solve( size, a, b ) != 0 ) result = GAUSSIAN_FAILED;
+    return result;
+}
+
+
+//! Runs one backend, taking exclusive_lock as the backend requires.
+static int run_backend( const struct Backend *backend, size_t size, double *a, double *b )
+{
+    pthread_once( &exclusive_lock_once, initialize_exclusive_lock );
+    if( is_exclusive( backend ) )
+        pthread_rwlock_wrlock( &exclusive_lock );
+    else
+        pthread_rwlock_rdlock( &exclusive_lock );
+    const int result = run_backend_locked( backend, size, a, b );
+    pthread_rwlock_unlock( &exclusive_lock );
+    return result;
+}
+
+
+//! Fills a and b with a random, diagonally dominant system (the benchmark's system for seed 0).
+static void make_system( size_t size, double *a, double *b )
+{
+    for( size_t i = 0; i < size; ++i ) {
+        double *row = &a[i * size];
+        double off_diagonal = 0.0;
+        for( size_t j = 0; j < size; ++j ) {
+            row[j] = splitmix64_uniform( 0, i * ( size + 1 ) + j );
+            if( j != i ) off_diagonal += row[j] < 0.0 ? -row[j] : row[j];
+        }
+        row[i] = ( row[i] < 0.0 ? -1.0 : 1.0 ) * ( off_diagonal + 1.0 );
+        b[i] = splitmix64_uniform( 0, i * ( size + 1 ) + size );
+    }
+}
+
+
+static double now( void )
+{
+    struct timespec t;
+    clock_gettime( CLOCK_MONOTONIC, &t );
+    return t.tv_sec + t.tv_nsec / 1.0E9;
+}
+
+
+//! Returns the calibration bucket for a size.
+/*!
+ * Sizes are grouped by the number of bits needed to represent them. Sizes from
+ * CALIBRATION_LIMIT up would all be timed on the same system, so they share the last bucket.
+ */
+static size_t bucket_of( size_t size )
+{
+    if( size >= CALIBRATION_LIMIT ) return CALIBRATION_BUCKETS - 1;
+
+    size_t bits = 0;
+    while( size != 0 ) {
+        ++bits;
+        size >>= 1;
+    }
+    return bits;
+}
+
+
+//! Times the backends on a system with n unknowns and returns the fastest.
+/*!
+ * Called without state_lock. No other system is solved while the backends are timed.
+ */
+static const struct Backend *calibrate( size_t n )
+{
+    const struct Backend *fallback = backend_find( DEFAULT_BACKEND );
+    double *a_original = (double *)malloc( n * n * sizeof( double ) );
+    double *b_original = (double *)malloc( n * sizeof( double ) );
+    double *a = (double *)malloc( n * n * sizeof( double ) );
+    double *b = (double *)malloc( n * sizeof( double ) );
+    if( a_original == NULL || b_original == NULL || a == NULL || b == NULL ) {
+        free( a_original ); free( b_original ); free( a ); free( b );
+        return fallback;
+    }
+    make_system( n, a_original, b_original );
+
+    pthread_once( &exclusive_lock_once, initialize_exclusive_lock );
+    pthread_rwlock_wrlock( &exclusive_lock );
+    const struct Backend *best = fallback;
+    double best_time = 0.0;
+    for( size_t i = 0; i < backend_count; ++i ) {
+        const struct Backend *backend = &backend_table[i];
+        if( backend->flags & BACKEND_MPI ) continue;
+
+        double fastest = 0.0;
+        int usable = 1;
+        for( int run = 0; run <= CALIBRATION_RUNS && usable; ++run ) {
+            memcpy( a, a_original, n * n * sizeof( double ) );
+            memcpy( b, b_original, n * sizeof( double ) );
+            const double start = now( );
+            usable = ( run_backend_locked( backend, n, a, b ) == GAUSSIAN_SUCCESS );
+            const double elapsed = now( ) - start;
+            if( run == 1 || ( run > 1 && elapsed < fastest ) ) fastest = elapsed;
+        }
+        if( usable && ( best_time == 0.0 || fastest < best_time ) ) {
+            best = backend;
+            best_time = fastest;
+        }
+    }
+
+    pthread_rwlock_unlock( &exclusive_lock );
+
+    free( a_original ); free( b_original ); free( a ); free( b );
+    return best;
+}
+
+
+//! Returns the calibrated backend for the size, calibrating it if no other thread has.
+/*!
+ * Called with state_lock held. The lock is released while the backends are timed; threads
+ * that want the same bucket wait for the result, others carry on.
+ */
+static const struct Backend *calibrated_backend( size_t size )
+{
+    if( size < CALIBRATION_MINIMUM ) return backend_find( DEFAULT_BACKEND );
+
+    const size_t bucket = bucket_of( size );
+    while( calibration_state[bucket] == CALIBRATION_RUNNING ) {
+        pthread_cond_wait( &calibration_finished, &state_lock );
+    }
+    if( calibration_state[bucket] == CALIBRATION_NONE ) {
+        calibration_state[bucket] = CALIBRATION_RUNNING;
+        pthread_mutex_unlock( &state_lock );
+        const struct Backend *best = calibrate( ( size < CALIBRATION_LIMIT ) ? size : CALIBRATION_LIMIT );
+        pthread_mutex_lock( &state_lock );
+        calibrated[bucket] = best;
+        calibration_state[bucket] = CALIBRATION_DONE;
+        pthread_cond_broadcast( &calibration_finished );
+    }
+    return calibrated[bucket];
+}
+
+
+//! Makes the default selection if no selection has been made. Called with state_lock held.
+static void select_default( void )
+{
+    if( selection_made ) return;
+    selection_made = 1;
+    selected = NULL;
+
+    const char *name = getenv( GAUSSIAN_BACKEND_VARIABLE );
+    if( name != NULL && strcmp( name, GAUSSIAN_AUTO ) != 0 ) {
+        selected = backend_find( name );
+        if( selected == NULL ) {
+            fprintf( stderr, "libgaussian: unknown backend \"%s\" in %s; using %s\n", name, GAUSSIAN_BACKEND_VARIABLE, GAUSSIAN_AUTO );
+        }
+    }
+}
+
+
+//! Returns the backend to use for a system of the given size. NULL means there is no such backend.
+static const struct Backend *resolve( const char *name, size_t size )
+{
+    const struct Backend *backend;
+
+    // A named backend needs none of the shared state.
+    if( name != NULL && strcmp( name, GAUSSIAN_AUTO ) != 0 ) return backend_find( name );
+
+    pthread_mutex_lock( &state_lock );
+    if( name == NULL ) select_default( );
+    if( name == NULL && selected != NULL )
+        backend = selected;
+    else
+        backend = calibrated_backend( size );
+    pthread_mutex_unlock( &state_lock );
+    return backend;
+}
+
+
+int gaussian_abi_version( void )
+{
+    return GAUSSIAN_ABI_VERSION;
+}
+
+
+int gaussian_solve( size_t size, double *a, double *b )
+{
+    return gaussian_solve_with( NULL, size, a, b );
+}
+
+
+int gaussian_solve_with( const char *name, size_t size, double *a, double *b )
+{
+    // We can deal with a 1x1 system, but not an empty system.
+    if( size == 0 ) return GAUSSIAN_FAILED;
+
+    const struct Backend *backend = resolve( name, size );
+    if( backend == NULL || !is_available( backend ) ) return GAUSSIAN_UNAVAILABLE;
+    return run_backend( backend, size, a, b );
+}
+
+
+int gaussian_select_backend( const char *name )
+{
+    int result = GAUSSIAN_SUCCESS;
+
+    pthread_mutex_lock( &state_lock );
+    if( name == NULL ) {
+        selection_made = 0;
+        select_default( );
+    }
+    else if( strcmp( name, GAUSSIAN_AUTO ) == 0 ) {
+        selection_made = 1;
+        selected = NULL;
+    }
+    else {
+        const struct Backend *backend = backend_find( name );
+        if( backend == NULL ) {
+            result = GAUSSIAN_UNAVAILABLE;
+        }
+        else {
+            selection_made = 1;
+            selected = backend;
+        }
+    }
+    pthread_mutex_unlock( &state_lock );
+    return result;
+}
+
+
+const char *gaussian_selected_backend( void )
+{
+    const char *name;
+
+    pthread_mutex_lock( &state_lock );
+    select_default( );
+    name = ( selected != NULL ) ? selected->name : GAUSSIAN_AUTO;
+    pthread_mutex_unlock( &state_lock );
+    return name;
+}
+
+
+const char *gaussian_backend_for( size_t size )
+{
+    const struct Backend *backend = resolve( NULL, size );
+    return ( backend != NULL ) ? backend->name : NULL;
+}
+
+
+size_t gaussian_backend_count( void )
+{
+    return backend_count;
+}
+
+
+const char *gaussian_backend_name( size_t index )
+{
+    return ( index < backend_count ) ? backend_table[index].name : NULL;
+}
+
+
+const char *gaussian_backend_description( size_t index )
+{
+    return ( index < backend_count ) ? backend_table[index].description : NULL;
+}
@@ -0,0 +1,82 @@
+/*!
+ * \file   libgaussian.h
+ * \brief  The stable interface to the Gaussian Elimination library.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * The library contains every version of the solver (a "backend"; see backend.h) behind one
+ * function, gaussian_solve. Which backend it uses is decided at run time: by a call to
+ * gaussian_select_backend, otherwise by the environment variable GAUSSIAN_BACKEND, otherwise
+ * automatically. In the automatic mode the first solve of a system of a new size first times
+ * the backends on a small system of a similar size and then uses the fastest of them for every
+ * system of about that size.
+ *
+ * Only the functions and constants declared here are part of the interface. They use plain C
+ * types so the library can be called from C++, Python, and similar languages. Compatible
+ * changes keep GAUSSIAN_ABI_VERSION; a change that breaks existing callers increments it.
+ */
+
+#ifndef LIBGAUSSIAN_H
+#define LIBGAUSSIAN_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GAUSSIAN_ABI_VERSION 1
+
+#define GAUSSIAN_BACKEND_VARIABLE "GAUSSIAN_BACKEND"
+#define GAUSSIAN_AUTO             "auto"
+
+// Results.
+#define GAUSSIAN_SUCCESS       0   // The solution is in b.
+#define GAUSSIAN_FAILED      (-1)  // The system is degenerate (or the size is zero).
+#define GAUSSIAN_UNAVAILABLE (-2)  // The backend doesn't exist or couldn't be started.
+
+//! Returns the GAUSSIAN_ABI_VERSION the library was built with.
+int gaussian_abi_version( void );
+
+//! Solves a x = b in place with the selected backend.
+/*!
+ * The matrix a is size x size in row-major order. It is overwritten. On success the solution
+ * replaces b and GAUSSIAN_SUCCESS is returned. Several threads may call this function at
+ * once; backends that can't solve two systems at the same time run while no other system is
+ * being solved. Solves also wait while the backends are being calibrated.
+ */
+int gaussian_solve( size_t size, double *a, double *b );
+
+//! As gaussian_solve but uses the named backend (or GAUSSIAN_AUTO) for this call only.
+int gaussian_solve_with( const char *name, size_t size, double *a, double *b );
+
+//! Selects the backend used by gaussian_solve.
+/*!
+ * The name is one of those returned by gaussian_backend_name or GAUSSIAN_AUTO. A NULL name
+ * returns to the default: GAUSSIAN_BACKEND if it is set, otherwise GAUSSIAN_AUTO. Returns
+ * GAUSSIAN_UNAVAILABLE if there is no such backend; the selection is then unchanged.
+ */
+int gaussian_select_backend( const char *name );
+
+//! Returns the name of the selected backend, which may be GAUSSIAN_AUTO.
+const char *gaussian_selected_backend( void );
+
+//! Returns the name of the backend gaussian_solve would use for a system of the given size.
+/*!
+ * In the automatic mode this calibrates the backends for that size if it hasn't been done.
+ */
+const char *gaussian_backend_for( size_t size );
+
+//! Returns the number of backends in the library.
+size_t gaussian_backend_count( void );
+
+//! Returns the name of backend 'index' or NULL if index is out of range.
+const char *gaussian_backend_name( size_t index );
+
+//! Returns a one line description of backend 'index' or NULL if index is out of range.
+const char *gaussian_backend_description( size_t index );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,176 @@
+/*!
+ *  \file   solve_system.c
+ *  \brief  Solve a large system of simultaneous equations with any backend in libgaussian.
+ *  \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ *  Usage: GaussianSolve [-b backend] [-l] system-file
+ *
+ *  The backend is given by -b, otherwise by GAUSSIAN_BACKEND, otherwise it is chosen by
+ *  calibration (see libgaussian.h). Use -l to list the backends. The system file may be in the
+ *  text format or the dense binary format (see ../C/system_file.h).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../C/system_file.h"
+#include "libgaussian.h"
+#include "Timer.h"
+
+
+//! Reads the rest of a dense binary system after its header. Returns zero on success.
+static int read_binary( FILE *input_file, const struct system_file_header *header, double *a, double *b )
+{
+    const size_t size = header->size;
+    const size_t row_length = size + 1;
+    double *row = (double *)malloc( row_length * sizeof( double ) );
+    float  *single = (float *)malloc( row_length * sizeof( float ) );
+    int result = 0;
+
+    for( size_t i = 0; i < size && result == 0; ++i ) {
+        if( header->element_size == sizeof( float ) ) {
+            if( fread( single, sizeof( float ), row_length, input_file ) != row_length ) result = -1;
+            for( size_t j = 0; j < row_length; ++j ) row[j] = single[j];
+        }
+        else if( fread( row, sizeof( double ), row_length, input_file ) != row_length ) {
+            result = -1;
+        }
+        memcpy( &a[i * size], row, size * sizeof( double ) );
+        b[i] = row[size];
+    }
+    free( single );
+    free( row );
+    return result;
+}
+
+
+//! Reads the rest of a text system after its size. Returns zero on success.
+static int read_text( FILE *input_file, size_t size, double *a, double *b )
+{
+    for( size_t i = 0; i < size; ++i ) {
+        for( size_t j = 0; j < size; ++j ) {
+            if( fscanf( input_file, "%lf", &a[i * size + j] ) != 1 ) return -1;
+        }
+        if( fscanf( input_file, "%lf", &b[i] ) != 1 ) return -1;
+    }
+    return 0;
+}
+
+
+int main( int argc, char *argv[] )
+{
+    const char *backend = NULL;
+    const char *file_name = NULL;
+
+    for( int i = 1; i < argc; ++i ) {
+        if( strcmp( argv[i], "-b" ) == 0 && i + 1 < argc ) {
+            backend = argv[++i];
+        }
+        else if( strcmp( argv[i], "-l" ) == 0 ) {
+            for( size_t j = 0; j < gaussian_backend_count( ); ++j ) {
+                printf( "   %-14s %s\n", gaussian_backend_name( j ), gaussian_backend_description( j ) );
+            }
+            return EXIT_SUCCESS;
+        }
+        else if( file_name == NULL && argv[i][0] != '-' ) {
+            file_name = argv[i];
+        }
+        else {
+            file_name = NULL;
+            break;
+        }
+    }
+    if( file_name == NULL ) {
+        printf( "Usage: %s [-b backend] [-l] system-file\n", argv[0] );
+        return EXIT_FAILURE;
+    }
+    if( backend != NULL && gaussian_select_backend( backend ) != GAUSSIAN_SUCCESS ) {
+        printf( "Error: Unknown backend %s. Use -l to list the backends.\n", backend );
+        return EXIT_FAILURE;
+    }
+
+    // Open the file.
+    FILE *input_file;
+    if( ( input_file = fopen( file_name, "rb" ) ) == NULL ) {
+        printf( "Error: Can not open the system definition file.\n" );
+        return EXIT_FAILURE;
+    }
+
+    // Get the size, from the header of a binary file or the start of a text file.
+    struct system_file_header header;
+    size_t size = 0;
+    int binary = 0;
+    if( fread( &header, 1, sizeof( header ), input_file ) >= 4 && system_file_is_binary( &header, 4 ) ) {
+        if( !system_file_header_valid( &header ) || ( header.flags & SYSTEM_FILE_SPARSE ) ) {
+            printf( "Error: Unsupported binary system definition file.\n" );
+            fclose( input_file );
+            return EXIT_FAILURE;
+        }
+        size = header.size;
+        binary = 1;
+    }
+    else {
+        rewind( input_file );
+        if( fscanf( input_file, "%zu", &size ) != 1 ) size = 0;
+    }
+    if( size == 0 ) {
+        printf( "Error: Invalid or incomplete system definition file.\n" );
+        fclose( input_file );
+        return EXIT_FAILURE;
+    }
+
+    // Allocate the arrays and get the coefficients.
+    double *a = (double *)malloc( size * size * sizeof( double ) );
+    double *b = (double *)malloc( size * sizeof( double ) );
+    if( a == NULL || b == NULL ) {
+        printf( "Error: Not enough memory for a system of size %zu.\n", size );
+        fclose( input_file );
+        return EXIT_FAILURE;
+    }
+    const int read_error = binary ? read_binary( input_file, &header, a, b ) : read_text( input_file, size, a, b );
+    fclose( input_file );
+    if( read_error ) {
+        printf( "Error: Invalid or incomplete system definition file.\n" );
+        free( a );
+        free( b );
+        return EXIT_FAILURE;
+    }
+
+    // Settle on a backend (calibrating if necessary) before the timing starts.
+    const char *chosen = gaussian_backend_for( size );
+    printf( "Using backend %s", chosen );
+    if( strcmp( gaussian_selected_backend( ), GAUSSIAN_AUTO ) == 0 ) printf( " (chosen by calibration)" );
+    printf( "\n" );
+
+    // Do the calculations.
+    Timer stopwatch;
+    Timer_initialize( &stopwatch );
+    Timer_start( &stopwatch );
+    int result = gaussian_solve( size, a, b );
+    Timer_stop( &stopwatch );
+
+    // Display the results.
+    switch( result ) {
+    case GAUSSIAN_SUCCESS:
+        printf( "\nSolution is\n" );
+        for( size_t i = 0; i < size; ++i ) {
+            printf( " x[%4zu] = %9.5f\n", i, b[i] );
+        }
+        printf( "\nExecution time = %ld milliseconds\n", Timer_time( &stopwatch ) );
+        break;
+
+    case GAUSSIAN_FAILED:
+        printf( "System is degenerate. It does not have a unique solution.\n" );
+        break;
+
+    default:
+        printf( "The backend %s could not be started.\n", chosen );
+        break;
+    }
+
+    // Clean up the dynamically allocated space.
+    free( a );
+    free( b );
+    return ( result == GAUSSIAN_UNAVAILABLE ) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,465 @@
+/*!
+ * \file   linear_equations-2d.c
+ * \brief  A gaussian elimination solver using a two dimensional grid of processes.
+ * \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+ *
+ * In linear_equations.c each pivot row is broadcast, at full length, to every process. Each
+ * process thus receives O(n^2) values no matter how many processes there are. Here the
+ * processes are arranged in a P x Q grid and the matrix is divided into square tiles of
+ * GRID_BLOCK_SIZE rows and columns. Tile (I, J) belongs to the process in grid row I % P and
+ * grid column J % Q (a two dimensional block cyclic distribution, as in ScaLAPACK and HPL). The
+ * driving vector is stored as an extra column of the matrix so it is updated along with it.
+ *
+ * The matrix is factored one panel (a column of tiles) at a time:
+ *
+ * 1. The grid column owning the panel factors it with partial pivoting. The pivot searches
+ *    and the broadcasts of the pivot rows only involve the processes in that grid column.
+ * 2. The pivots are broadcast along each grid row and applied to the rest of the matrix.
+ * 3. The factored panel is broadcast along each grid row.
+ * 4. The grid row owning the panel's diagonal tile computes its part of the block row of U
+ *    and broadcasts it down each grid column.
+ * 5. Every process updates its tiles of the trailing matrix with the parts of the panel and
+ *    the block row it received.
+ *
+ * A process receives only the parts of the panel and block row that overlap its tiles, so per
+ * process communication is O(n^2 / P + n^2 / Q), which is O(n^2 / sqrt(p)) on a square grid.
+ * The statistics reported by gaussian_communication_volume show the difference; setting
+ * GAUSSIAN_GRID to "px1" gives a one dimensional (row cyclic) distribution for comparison.
+ *
+ * gaussian_solve_2d_distributed is given only this process's tiles (solve_system reads them
+ * directly from a binary file). gaussian_solve_2d is given the entire system, like
+ * gaussian_solve, and copies out the tiles. The back substitution is also done on the tiles, so
+ * no process ever holds more than its own part of the matrix.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#include "linear_equations.h"
+#include "../C/pivot_threshold.h"
+
+struct Grid {
+    int      rows;          //!< P, the number of grid rows.
+    int      columns;       //!< Q, the number of grid columns.
+    int      my_row;
+    int      my_column;
+    MPI_Comm row_comm;      //!< The processes in my grid row, ranked by grid column.
+    MPI_Comm column_comm;   //!< The processes in my grid column, ranked by grid row.
+    double   threshold;     //!< Pivots no larger than this are treated as zero.
+};
+
+// The layout of MPI_DOUBLE_INT, as used by the MPI_MAXLOC reduction.
+struct PivotCandidate {
+    double value;
+    int    row;
+};
+
+
+//! Returns how many of the indices [0, n) process 'process' of 'count' owns.
+static int owned_count( int n, int process, int count )
+{
+    const int block_count = n / GRID_BLOCK_SIZE;
+    const int extra = block_count % count;
+    int result = ( block_count / count ) * GRID_BLOCK_SIZE;
+
+    if( process < extra ) result += GRID_BLOCK_SIZE;
+    else if( process == extra ) result += n % GRID_BLOCK_SIZE;
+    return result;
+}
+
+//! Returns the process (of 'count') that owns a global index.
+static int owner( int global, int count )
+{
+    return ( global / GRID_BLOCK_SIZE ) % count;
+}
+
+//! Returns the local index of a global index on the process that owns it.
+static int local_index( int global, int count )
+{
+    return ( global / GRID_BLOCK_SIZE / count ) * GRID_BLOCK_SIZE + global % GRID_BLOCK_SIZE;
+}
+
+//! Returns the global index of a local index on the given process.
+static int global_index( int local, int process, int count )
+{
+    return ( ( local / GRID_BLOCK_SIZE ) * count + process ) * GRID_BLOCK_SIZE + local % GRID_BLOCK_SIZE;
+}
+
+
+// The following wrappers record the communication statistics.
+
+static void grid_bcast( floating_type *buffer, int count, int root, MPI_Comm comm )
+{
+    int my_rank;
+    MPI_Comm_rank( comm, &my_rank );
+    double wait_start = MPI_Wtime( );
+    MPI_Bcast( buffer, count, MPI_DOUBLE, root, comm );
+    gaussian_wait_time += MPI_Wtime( ) - wait_start;
+    if( my_rank != root ) gaussian_received_bytes += count * sizeof( floating_type );
+}
+
+static void grid_exchange( floating_type *buffer, int count, int partner, MPI_Comm comm )
+{
+    double wait_start = MPI_Wtime( );
+    MPI_Sendrecv_replace( buffer, count, MPI_DOUBLE, partner, 0, partner, 0, comm, MPI_STATUS_IGNORE );
+    gaussian_wait_time += MPI_Wtime( ) - wait_start;
+    gaussian_received_bytes += count * sizeof( floating_type );
+}
+
+
+//! Returns the number of grid rows to use for the given number of processes.
+static int grid_rows( int process_count )
+{
+    const char *setting = getenv( "GAUSSIAN_GRID" );
+    int rows, p, q;
+
+    if( setting != NULL && sscanf( setting, "%dx%d", &p, &q ) == 2 && p > 0 && q > 0 && p * q == process_count ) {
+        rows = p;
+    }
+    else {
+        // Use the largest number of rows that is a divisor no greater than the square root.
+        for( rows = (int)sqrt( (double)process_count ); rows > 1 && process_count % rows != 0; --rows ) ;
+    }
+    return rows;
+}
+
+
+//! Arranges the processes into a grid.
+static void make_grid( struct Grid *grid )
+{
+    int process_count;
+    int my_rank;
+
+    MPI_Comm_size( MPI_COMM_WORLD, &process_count );
+    MPI_Comm_rank( MPI_COMM_WORLD, &my_rank );
+
+    grid->rows      = grid_rows( process_count );
+    grid->columns   = process_count / grid->rows;
+    grid->my_row    = my_rank / grid->columns;
+    grid->my_column = my_rank % grid->columns;
+    MPI_Comm_split( MPI_COMM_WORLD, grid->my_row, grid->my_column, &grid->row_comm );
+    MPI_Comm_split( MPI_COMM_WORLD, grid->my_column, grid->my_row, &grid->column_comm );
+}
+
+
+//! Exchanges the parts of two (global) rows in the local columns [first, first + count).
+static void swap_rows(
+    const struct Grid *grid, floating_type *local, int local_columns,
+    int row_1, int row_2, int first, int count, floating_type *buffer )
+{
+    const int owner_1 = owner( row_1, grid->rows );
+    const int owner_2 = owner( row_2, grid->rows );
+    floating_type *part_1 = &local[(size_t)local_index( row_1, grid->rows ) * local_columns + first];
+    floating_type *part_2 = &local[(size_t)local_index( row_2, grid->rows ) * local_columns + first];
+
+    if( count <= 0 ) return;
+    if( owner_1 == grid->my_row && owner_2 == grid->my_row ) {
+        memcpy( buffer, part_1, count * sizeof( floating_type ) );
+        memcpy( part_1, part_2, count * sizeof( floating_type ) );
+        memcpy( part_2, buffer, count * sizeof( floating_type ) );
+    }
+    else if( owner_1 == grid->my_row ) {
+        grid_exchange( part_1, count, owner_2, grid->column_comm );
+    }
+    else if( owner_2 == grid->my_row ) {
+        grid_exchange( part_2, count, owner_1, grid->column_comm );
+    }
+}
+
+
+//! Factors the panel of columns [first, last). Only the grid column owning the panel calls this.
+/*!
+ * The pivot row for each column is recorded in pivots. Returns -2 if the system is degenerate.
+ */
+static int factor_panel(
+    const struct Grid *grid, int size, floating_type *local, int local_rows, int local_columns,
+    int first, int last, int *pivots, floating_type *buffer )
+{
+    const int width = last - first;
+    const int panel_column = local_index( first, grid->columns );
+
+    for( int k = first; k < last; ++k ) {
+        const int k_column = panel_column + ( k - first );
+
+        // Find the row with the largest value of |a[j][k]|, j = k, ..., n - 1
+        struct PivotCandidate candidate = { -1.0, size };
+        struct PivotCandidate pivot;
+        for( int j = owned_count( k, grid->my_row, grid->rows ); j < local_rows; ++j ) {
+            if( fabs( local[(size_t)j * local_columns + k_column] ) > candidate.value ) {
+                candidate.value = fabs( local[(size_t)j * local_columns + k_column] );
+                candidate.row = global_index( j, grid->my_row, grid->rows );
+            }
+        }
+        double wait_start = MPI_Wtime( );
+        MPI_Allreduce( &candidate, &pivot, 1, MPI_DOUBLE_INT, MPI_MAXLOC, grid->column_comm );
+        gaussian_wait_time += MPI_Wtime( ) - wait_start;
+
+        // Check for |a[k][k]| zero. The whole grid column sees the same pivot.
+        if( pivot.value <= grid->threshold ) return -2;
+        pivots[k - first] = pivot.row;
+        if( pivot.row != k )
+            swap_rows( grid, local, local_columns, k, pivot.row, panel_column, width, buffer );
+
+        // Broadcast the rest of the pivot row's part of the panel.
+        const int k_owner = owner( k, grid->rows );
+        const int count = last - k;
+        if( grid->my_row == k_owner )
+            memcpy( buffer, &local[(size_t)local_index( k, grid->rows ) * local_columns + k_column], count * sizeof( floating_type ) );
+        grid_bcast( buffer, count, k_owner, grid->column_comm );
+
+        // Compute the multipliers and update the rest of the panel for the rows below row k.
+        for( int j = owned_count( k + 1, grid->my_row, grid->rows ); j < local_rows; ++j ) {
+            floating_type *row = &local[(size_t)j * local_columns + k_column];
+            row[0] /= buffer[0];
+            for( int c = 1; c < count; ++c )
+                row[c] -= row[0] * buffer[c];
+        }
+    }
+    return 0;
+}
+
+
+//! Does the elimination step of reducing the system, one panel at a time.
+static int elimination(
+    const struct Grid *grid, int size, floating_type *local, int local_rows, int local_columns )
+{
+    const int buffer_size = ( local_columns > GRID_BLOCK_SIZE ) ? local_columns : GRID_BLOCK_SIZE;
+    floating_type *panel   = (floating_type *)malloc( ( local_rows + 1 ) * GRID_BLOCK_SIZE * sizeof( floating_type ) );
+    floating_type *u_block = (floating_type *)malloc( GRID_BLOCK_SIZE * ( local_columns + 1 ) * sizeof( floating_type ) );
+    floating_type *buffer  = (floating_type *)malloc( buffer_size * sizeof( floating_type ) );
+    int pivots[GRID_BLOCK_SIZE + 1];
+    int return_code = 0;
+
+    for( int first = 0; first < size; first += GRID_BLOCK_SIZE ) {
+        const int last = ( first + GRID_BLOCK_SIZE < size ) ? first + GRID_BLOCK_SIZE : size;
+        const int width = last - first;
+        const int panel_owner = owner( first, grid->columns );
+        const int diagonal_owner = owner( first, grid->rows );
+
+        // My local rows at or below the panel's first row, and below its last row.
+        const int panel_rows = owned_count( first, grid->my_row, grid->rows );
+        const int trailing_rows = owned_count( last, grid->my_row, grid->rows );
+
+        // My local columns to the right of the panel (including the driving vector).
+        const int trailing_columns = owned_count( last, grid->my_column, grid->columns );
+        const int trailing_width = local_columns - trailing_columns;
+
+        // Factor the panel and tell the other grid columns the pivots (and whether it worked).
+        if( grid->my_column == panel_owner ) {
+            pivots[width] = factor_panel(
+                grid, size, local, local_rows, local_columns, first, last, pivots, buffer );
+        }
+        double wait_start = MPI_Wtime( );
+        MPI_Bcast( pivots, width + 1, MPI_INT, panel_owner, grid->row_comm );
+        gaussian_wait_time += MPI_Wtime( ) - wait_start;
+        if( ( return_code = pivots[width] ) != 0 ) break;
+
+        // Apply the row exchanges to the trailing columns.
+        for( int k = first; k < last; ++k ) {
+            if( pivots[k - first] != k )
+                swap_rows( grid, local, local_columns, k, pivots[k - first], trailing_columns, trailing_width, buffer );
+        }
+
+        // Broadcast my grid row's part of the factored panel.
+        const int panel_count = ( local_rows - panel_rows ) * width;
+        if( grid->my_column == panel_owner ) {
+            const int panel_column = local_index( first, grid->columns );
+            for( int j = panel_rows; j < local_rows; ++j ) {
+                memcpy( &panel[( j - panel_rows ) * width],
+                        &local[(size_t)j * local_columns + panel_column], width * sizeof( floating_type ) );
+            }
+        }
+        if( panel_count > 0 ) grid_bcast( panel, panel_count, panel_owner, grid->row_comm );
+
+        // Compute the block row of U (U12 = L11^-1 A12) and broadcast my grid column's part of it.
+        const int u_count = width * trailing_width;
+        if( grid->my_row == diagonal_owner ) {
+            // The panel's rows are my local rows panel_rows, ..., panel_rows + width - 1.
+            for( int t = 0; t < width; ++t ) {
+                floating_type *target = &local[(size_t)( panel_rows + t ) * local_columns + trailing_columns];
+                for( int s = 0; s < t; ++s ) {
+                    const floating_type l = panel[t * width + s];
+                    const floating_type *source = &local[(size_t)( panel_rows + s ) * local_columns + trailing_columns];
+                    for( int c = 0; c < trailing_width; ++c )
+                        target[c] -= l * source[c];
+                }
+                memcpy( &u_block[t * trailing_width], target, trailing_width * sizeof( floating_type ) );
+            }
+        }
+        if( u_count > 0 ) grid_bcast( u_block, u_count, diagonal_owner, grid->column_comm );
+
+        // Update my part of the trailing matrix: A22 = A22 - L21 U12.
+        #pragma omp parallel for
+        for( int j = trailing_rows; j < local_rows; ++j ) {
+            const floating_type *l_row = &panel[( j - panel_rows ) * width];
+            floating_type *target = &local[(size_t)j * local_columns + trailing_columns];
+            for( int s = 0; s < width; ++s ) {
+                const floating_type l = l_row[s];
+                const floating_type *u_row = &u_block[s * trailing_width];
+                for( int c = 0; c < trailing_width; ++c )
+                    target[c] -= l * u_row[c];
+            }
+        }
+    }
+
+    free( buffer );
+    free( u_block );
+    free( panel );
+    return return_code;
+}
+
+
+//! Does the back substitution step of solving the system, leaving the solution in x everywhere.
+/*!
+ * Working up from the bottom, the unknowns are found one block of GRID_BLOCK_SIZE at a time.
+ * Each process keeps, for each of its rows, the sum of its columns' terms for the unknowns
+ * found so far. For each block the grid row holding the block's rows adds these sums (and the
+ * driving vector values) together on the process holding the diagonal tile. That process
+ * solves the small triangular system and broadcasts the block's unknowns to every process.
+ */
+static int back_substitution(
+    const struct Grid *grid, int size, const floating_type *local, int local_rows, int local_columns, floating_type *x )
+{
+    const int b_owner = owner( size, grid->columns );
+    const int b_column = local_index( size, grid->columns );
+    floating_type *partial = (floating_type *)calloc( local_rows + 1, sizeof( floating_type ) );
+    floating_type  sums[GRID_BLOCK_SIZE];
+    floating_type  block[GRID_BLOCK_SIZE + 1];   // The block's unknowns followed by a failure flag.
+    int return_code = 0;
+
+    for( int first = ( ( size - 1 ) / GRID_BLOCK_SIZE ) * GRID_BLOCK_SIZE; first >= 0; first -= GRID_BLOCK_SIZE ) {
+        const int last = ( first + GRID_BLOCK_SIZE < size ) ? first + GRID_BLOCK_SIZE : size;
+        const int width = last - first;
+        const int row_owner = owner( first, grid->rows );
+        const int column_owner = owner( first, grid->columns );
+        const int first_column = local_index( first, grid->columns );
+
+        if( grid->my_row == row_owner ) {
+            const int first_row = local_index( first, grid->rows );
+            for( int t = 0; t < width; ++t ) {
+                sums[t] = -partial[first_row + t];
+                if( grid->my_column == b_owner ) sums[t] += local[(size_t)( first_row + t ) * local_columns + b_column];
+            }
+            if( grid->my_column == column_owner )
+                MPI_Reduce( MPI_IN_PLACE, sums, width, MPI_DOUBLE, MPI_SUM, column_owner, grid->row_comm );
+            else
+                MPI_Reduce( sums, NULL, width, MPI_DOUBLE, MPI_SUM, column_owner, grid->row_comm );
+
+            // Solve the diagonal tile's upper triangle for the block's unknowns.
+            if( grid->my_column == column_owner ) {
+                block[width] = 0.0;
+                for( int t = width - 1; t >= 0; --t ) {
+                    const floating_type *row = &local[(size_t)( first_row + t ) * local_columns + first_column];
+                    floating_type sum = sums[t];
+                    for( int c = t + 1; c < width; ++c )
+                        sum -= row[c] * block[c];
+                    if( fabs( row[t] ) <= grid->threshold ) {
+                        block[width] = 1.0;
+                        break;
+                    }
+                    block[t] = sum / row[t];
+                }
+            }
+        }
+        MPI_Bcast( block, width + 1, MPI_DOUBLE, row_owner * grid->columns + column_owner, MPI_COMM_WORLD );
+        if( block[width] != 0.0 ) {
+            return_code = -2;
+            break;
+        }
+        memcpy( &x[first], block, width * sizeof( floating_type ) );
+
+        // Add the terms for the block's unknowns to the sums of my rows above the block.
+        if( grid->my_column == column_owner ) {
+            const int rows_above = owned_count( first, grid->my_row, grid->rows );
+            #pragma omp parallel for
+            for( int j = 0; j < rows_above; ++j ) {
+                const floating_type *row = &local[(size_t)j * local_columns + first_column];
+                floating_type sum = 0.0;
+                for( int c = 0; c < width; ++c )
+                    sum += row[c] * block[c];
+                partial[j] += sum;
+            }
+        }
+    }
+
+    free( partial );
+    return return_code;
+}
+
+
+void gaussian_grid_layout( int size, int *grid_row_count, int *grid_column_count, int *local_rows, int *local_columns )
+{
+    int process_count;
+    int my_rank;
+
+    MPI_Comm_size( MPI_COMM_WORLD, &process_count );
+    MPI_Comm_rank( MPI_COMM_WORLD, &my_rank );
+    *grid_row_count = grid_rows( process_count );
+    *grid_column_count = process_count / *grid_row_count;
+    *local_rows = owned_count( size, my_rank / *grid_column_count, *grid_row_count );
+    *local_columns = owned_count( size + 1, my_rank % *grid_column_count, *grid_column_count );
+}
+
+
+int gaussian_solve_2d_distributed( int size, floating_type *local, floating_type *x )
+{
+    struct Grid grid;
+
+    if( size <= 0 ) return -1;
+    make_grid( &grid );
+    const int local_rows = owned_count( size, grid.my_row, grid.rows );
+    const int local_columns = owned_count( size + 1, grid.my_column, grid.columns );
+
+    // The threshold depends on the largest coefficient of the whole matrix. The driving vector
+    // is the last of its owner's columns and isn't included.
+    const int matrix_columns = ( grid.my_column == owner( size, grid.columns ) ) ? local_columns - 1 : local_columns;
+    double my_threshold = pivot_threshold( local_rows, matrix_columns, local, local_columns );
+    MPI_Allreduce( &my_threshold, &grid.threshold, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD );
+
+    gaussian_wait_time = 0.0;
+    gaussian_received_bytes = 0.0;
+    double start_time = MPI_Wtime( );
+    int return_code = elimination( &grid, size, local, local_rows, local_columns );
+    gaussian_elimination_time = MPI_Wtime( ) - start_time;
+
+    if( return_code == 0 )
+        return_code = back_substitution( &grid, size, local, local_rows, local_columns, x );
+
+    MPI_Comm_free( &grid.column_comm );
+    MPI_Comm_free( &grid.row_comm );
+    return return_code;
+}
+
+
+int gaussian_solve_2d( int size, floating_type *a, floating_type *b )
+{
+    int grid_row_count, grid_column_count;
+    int local_rows, local_columns;
+    int my_rank;
+
+    if( size <= 0 ) return -1;
+    MPI_Comm_rank( MPI_COMM_WORLD, &my_rank );
+    gaussian_grid_layout( size, &grid_row_count, &grid_column_count, &local_rows, &local_columns );
+    const int my_row = my_rank / grid_column_count;
+    const int my_column = my_rank % grid_column_count;
+
+    // Copy out this process's tiles. The driving vector is the last column.
+    floating_type *local = (floating_type *)malloc( ( (size_t)local_rows * local_columns + 1 ) * sizeof( floating_type ) );
+    for( int i = 0; i < local_rows; ++i ) {
+        const int global_row = global_index( i, my_row, grid_row_count );
+        for( int j = 0; j < local_columns; ++j ) {
+            const int global_column = global_index( j, my_column, grid_column_count );
+            local[(size_t)i * local_columns + j] =
+                ( global_column < size ) ? MATRIX_GET( a, size, global_row, global_column ) : b[global_row];
+        }
+    }
+
+    // The solution can go directly into b since the original values have been copied.
+    int return_code = gaussian_solve_2d_distributed( size, local, b );
+
+    free( local );
+    return return_code;
+}
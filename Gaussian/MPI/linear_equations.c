@@ -3,7 +3,10 @@
  * \brief  A gaussian elimination solver.
  * \author (C) Copyright 2014 by Peter C. Chapin <pchapin@vtc.edu>
  *
- * This is the MPI version of the algorithm.
+ * This is the MPI version of the algorithm. The rows of the system are distributed cyclically
+ * over the processes and each process only stores its own rows. The processes share the work
+ * of both the elimination and the back substitution. The solution is assembled on every process
+ * at the end.
  */
 
 #include <math.h>
@@ -11,107 +14,364 @@
 #include <mpi.h>
 
 #include "linear_equations.h"
+#include "../C/pivot_threshold.h"
+
+// The number of unknowns found together in each step of the back substitution.
+#define BACK_SUBSTITUTION_BLOCK 64
+
+//! The rows of the system held by this process.
+struct LocalSystem {
+    int            size;
+    int            number_of_processes;
+    int            my_rank;
+    floating_type *a;   //!< Row j (where j % number_of_processes == my_rank) starts at a[(j / p) * size].
+    floating_type *b;   //!< Its driving vector value is b[j / p].
+    double         threshold;  //!< Pivots no larger than this are treated as zero.
+};
+
+// The layout of MPI_DOUBLE_INT, as used by the MPI_MAXLOC reduction.
+struct PivotCandidate {
+    double value;
+    int    row;
+};
+
+//! The state of the communication that installs the pivot row for one column.
+struct PivotExchange {
+    int            column;      //!< The column being eliminated (the pivot goes into this row).
+    int            row;         //!< The row holding the pivot before the exchange.
+    int            owner;       //!< The owner of that row.
+    floating_type *pivot;       //!< The pivot row (from 'column' on) followed by its b value.
+    floating_type *displaced;   //!< The old row 'column' in the same format.
+    MPI_Request    requests[2]; //!< The broadcast of pivot and the transfer of displaced.
+};
+
+// See linear_equations.h.
+double gaussian_wait_time;
+double gaussian_elimination_time;
+double gaussian_received_bytes;
+
+
+//! Returns a pointer to a row this process owns.
+static floating_type *local_row( const struct LocalSystem *system, int row )
+{
+    return system->a + (size_t)( row / system->number_of_processes ) * system->size;
+}
+
+//! Returns a pointer to the driving vector value of a row this process owns.
+static floating_type *local_b( const struct LocalSystem *system, int row )
+{
+    return &system->b[row / system->number_of_processes];
+}
+
+//! Returns the first row >= row that the given process owns.
+static int first_owned( const struct LocalSystem *system, int row, int rank )
+{
+    const int p = system->number_of_processes;
+    return row + ( rank - row % p + p ) % p;
+}
+
+
+//! Copies the part of an owned row from column 'first' on, followed by its b value, into a buffer.
+static void pack_row( const struct LocalSystem *system, int row, int first, floating_type *buffer )
+{
+    memcpy( buffer, local_row( system, row ) + first, ( system->size - first ) * sizeof( floating_type ) );
+    buffer[system->size - first] = *local_b( system, row );
+}
+
+
+//! The inverse of pack_row.
+static void unpack_row( const struct LocalSystem *system, int row, int first, const floating_type *buffer )
+{
+    memcpy( local_row( system, row ) + first, buffer, ( system->size - first ) * sizeof( floating_type ) );
+    *local_b( system, row ) = buffer[system->size - first];
+}
+
+
+//! Selects the pivot row for exchange->column given this process's best candidate.
+/*!
+ * Returns -2 (on every process) if the system is degenerate.
+ */
+static int select_pivot( const struct LocalSystem *system, struct PivotCandidate candidate, struct PivotExchange *exchange )
+{
+    struct PivotCandidate pivot;
+
+    double wait_start = MPI_Wtime( );
+    MPI_Allreduce( &candidate, &pivot, 1, MPI_DOUBLE_INT, MPI_MAXLOC, MPI_COMM_WORLD );
+    gaussian_wait_time += MPI_Wtime( ) - wait_start;
+
+    // Check for |a[k][i]| zero. Every process sees the same pivot so they all stop together.
+    if( pivot.value <= system->threshold ) return -2;
+    exchange->row = pivot.row;
+    exchange->owner = pivot.row % system->number_of_processes;
+    return 0;
+}
+
+
+//! Starts moving the selected pivot row into place.
+/*!
+ * The owner of the pivot row broadcasts it (with its b value, in one message) and the owner of
+ * the row it will replace sends that row to the pivot row's owner. The transfers are completed
+ * by finish_pivot so that the processes can update other rows in the meantime. Both rows must
+ * already be fully updated.
+ */
+static void start_pivot( const struct LocalSystem *system, struct PivotExchange *exchange )
+{
+    const int i = exchange->column;
+    const int i_owner = i % system->number_of_processes;
+    const int my_rank = system->my_rank;
+    const int count = system->size - i + 1;
+
+    if( my_rank == exchange->owner ) pack_row( system, exchange->row, i, exchange->pivot );
+    MPI_Ibcast( exchange->pivot, count, MPI_DOUBLE, exchange->owner, MPI_COMM_WORLD, &exchange->requests[0] );
+    if( my_rank != exchange->owner ) gaussian_received_bytes += count * sizeof( floating_type );
+
+    exchange->requests[1] = MPI_REQUEST_NULL;
+    if( exchange->row != i ) {
+        if( my_rank == i_owner ) {
+            pack_row( system, i, i, exchange->displaced );
+            if( my_rank != exchange->owner )
+                MPI_Isend( exchange->displaced, count, MPI_DOUBLE, exchange->owner, i, MPI_COMM_WORLD, &exchange->requests[1] );
+        }
+        else if( my_rank == exchange->owner ) {
+            MPI_Irecv( exchange->displaced, count, MPI_DOUBLE, i_owner, i, MPI_COMM_WORLD, &exchange->requests[1] );
+            gaussian_received_bytes += count * sizeof( floating_type );
+        }
+    }
+}
+
+
+//! Waits for the transfers started by start_pivot and puts the rows in their new places.
+/*!
+ * The owner of row i stores the pivot row there. The other processes only need the pivot row
+ * while they update their rows, so they use it from exchange->pivot.
+ */
+static void finish_pivot( const struct LocalSystem *system, struct PivotExchange *exchange )
+{
+    const int i = exchange->column;
+    const int my_rank = system->my_rank;
+
+    double wait_start = MPI_Wtime( );
+    MPI_Waitall( 2, exchange->requests, MPI_STATUSES_IGNORE );
+    gaussian_wait_time += MPI_Wtime( ) - wait_start;
+
+    if( my_rank == i % system->number_of_processes )
+        unpack_row( system, i, i, exchange->pivot );
+    if( exchange->row != i && my_rank == exchange->owner )
+        unpack_row( system, exchange->row, i, exchange->displaced );
+}
+
+
+//! Subtracts a multiple of the pivot row for column i from an owned row, for the columns from 'first' on.
+/*!
+ * The pivot row is in the format produced by pack_row. The multiplier has already been
+ * computed and stored in the row's (no longer needed) element in the pivot column.
+ */
+static void update_row( const struct LocalSystem *system, const floating_type *pivot, int i, int row, int first )
+{
+    const int size = system->size;
+    floating_type *target = local_row( system, row );
+    const floating_type m = target[i];
+
+    for( int k = first; k < size; ++k )
+        target[k] -= m * pivot[k - i];
+    *local_b( system, row ) -= m * pivot[size - i];
+}
+
 
 //! Does the elimination step of reducing the system.
-static int elimination(
-    int number_of_processes, int my_rank, int size, floating_type *a, floating_type *b )
+/*!
+ * The rows are distributed cyclically: row j belongs to rank j % number_of_processes. Only the
+ * owner of a row updates it. Because the rows that remain to be reduced are spread over all the
+ * ranks, every rank has work until the last few pivots. (With contiguous bands of rows, rank 0
+ * would be idle after the first 1/p of the pivots.)
+ *
+ * For each column the owners search their rows for the largest candidate pivot and a MAXLOC
+ * reduction selects the pivot row. Its owner broadcasts it to all ranks; the owner of the row
+ * it replaces sends that row to the pivot row's owner. In the end each process holds its rows
+ * of the upper triangle (everything at or to the right of the diagonal) and of the reduced
+ * driving vector.
+ *
+ * The communication for column i + 1 overlaps the updates for column i (a one step lookahead).
+ * First each process updates only column i + 1 of its rows, which is enough to select the
+ * next pivot. The owners of the next pivot row and of row i + 1 (which the pivot row replaces)
+ * then finish updating those two rows and start sending them. The remaining rows are updated
+ * while the messages are in flight. The pivot rows for columns i and i + 1 are thus needed at
+ * the same time, so two buffers are used for them alternately.
+ */
+static int elimination( const struct LocalSystem *system )
 {
-    floating_type *temp_array = (floating_type *)malloc( size * sizeof(floating_type) );
-    int            i, j, k;
-    floating_type  temp, m;
-    int            band_width = size / number_of_processes;
-    int            my_start, my_end;  // The range of rows to consider: [my_start, my_end).
-
-    // Adjust the bandwidth to account for remainder (if any). The last band is partial.
-    if( size % number_of_processes != 0 ) band_width++;
-
-    // Which rows is this process responsible for handling?
-    my_start = my_rank * band_width;
-    if( my_rank == number_of_processes - 1 ) {
-        my_end = size;
+    const int size = system->size;
+    const int p = system->number_of_processes;
+    const int my_rank = system->my_rank;
+    floating_type *buffers = (floating_type *)malloc( 3 * ( size + 1 ) * sizeof( floating_type ) );
+    floating_type *spare = buffers + 2 * ( size + 1 );
+    struct PivotExchange exchange = { 0, 0, 0, buffers, buffers + size + 1, { MPI_REQUEST_NULL, MPI_REQUEST_NULL } };
+    struct PivotCandidate candidate = { -1.0, size };
+    int return_code = 0;
+    int i, j;
+
+    gaussian_wait_time = 0.0;
+    gaussian_received_bytes = 0.0;
+    double start_time = MPI_Wtime( );
+
+    // Select the first pivot. There is nothing to overlap with it.
+    for( j = my_rank; j < size; j += p ) {
+        if( fabs( local_row( system, j )[0] ) > candidate.value ) {
+            candidate.value = fabs( local_row( system, j )[0] );
+            candidate.row = j;
+        }
     }
-    else {
-        my_end = my_start + band_width;
+    if( ( return_code = select_pivot( system, candidate, &exchange ) ) == 0 ) {
+        start_pivot( system, &exchange );
+        finish_pivot( system, &exchange );
     }
 
-    // It is necessary to process all rows so the last row is broadcast back to rank 0.
-    for( i = 0; i < size; ++i ) {
-
-        // For now, ignore the swapping. It's tricky to handle properly.
-        #ifdef NEVER
-        // Find the row with the largest value of |a[j][i]|, j = i, ..., n - 1
-        k = i;
-        m = fabs( MATRIX_GET( a, size, i, i ) );
-        for( j = i + 1; j < size; ++j ) {
-            if( fabs( MATRIX_GET( a, size, j, i ) ) > m ) {
-                k = j;
-                m = fabs( MATRIX_GET( a, size, j, i ) );
+    for( i = 0; return_code == 0 && i < size - 1; ++i ) {
+        // The pivot row for column i has arrived. Receive the next one into the spare buffer.
+        const floating_type *pivot = exchange.pivot;
+        exchange.pivot = spare;
+        spare = (floating_type *)pivot;
+
+        const int next = i + 1;
+        const int next_owner = next % p;
+
+        // The first row > i that this process owns.
+        const int my_first = first_owned( system, next, my_rank );
+
+        // Compute the multipliers and update column i + 1, looking for the next pivot.
+        candidate.value = -1.0;
+        candidate.row = size;
+        for( j = my_first; j < size; j += p ) {
+            floating_type *row = local_row( system, j );
+            row[i] /= pivot[0];
+            row[next] -= row[i] * pivot[1];
+            if( fabs( row[next] ) > candidate.value ) {
+                candidate.value = fabs( row[next] );
+                candidate.row = j;
             }
         }
 
-        // Check for |a[k][i]| zero.
-        if( fabs( MATRIX_GET( a, size, k, i ) ) <= 1.0E-6 ) {
-            return -2;
-        }
+        // Select the next pivot. Its row and row i + 1 must be finished before they can be sent.
+        exchange.column = next;
+        if( ( return_code = select_pivot( system, candidate, &exchange ) ) != 0 ) break;
+        const int early_1 = ( exchange.owner == my_rank ) ? exchange.row : -1;
+        const int early_2 = ( next_owner == my_rank && exchange.row != next ) ? next : -1;
+        if( early_1 >= 0 ) update_row( system, pivot, i, early_1, next + 1 );
+        if( early_2 >= 0 ) update_row( system, pivot, i, early_2, next + 1 );
+        start_pivot( system, &exchange );
 
-        // Exchange row i and row k, if necessary.
-        if( k != i ) {
-            memcpy( temp_array, MATRIX_GET_ROW( a, size, i ), size * sizeof( floating_type ) );
-            memcpy( MATRIX_GET_ROW( a, size, i ), MATRIX_GET_ROW( a, size, k ), size * sizeof( floating_type ) );
-            memcpy( MATRIX_GET_ROW( a, size, k ), temp_array, size * sizeof( floating_type ) );
-            
-            // Exchange corresponding elements of b.
-            temp = b[i];
-            b[i] = b[k];
-            b[k] = temp;
-        }
-        #endif
-
-        // Broadcast the current row.
-        MPI_Bcast( MATRIX_GET_ROW( a, size, i ),   // A pointer to the row.
-                   size,                           // Number of elements in the row.
-                   MPI_DOUBLE,                     // Type of each element.
-                   i / band_width,                 // The rank doing the broadcasting.
-                   MPI_COMM_WORLD );               // The scope of the broadcast.
-
-        // Broadcast the value in the driving vector.
-        MPI_Bcast( &b[i], 1, MPI_DOUBLE, i / band_width, MPI_COMM_WORLD );
-
-        // Subtract multiples of row i from subsequent rows.
-        for( j = i + 1; j < size; ++j ) {
-
-            // Only process rows that this process is responsible for handling.
-            if( j >= my_start && j < my_end ) {
-                m = MATRIX_GET( a, size, j, i ) / MATRIX_GET( a, size, i, i );
-                #pragma omp parallel for
-                for( k = 0; k < size; ++k )
-                    MATRIX_PUT( a, size, j, k, MATRIX_GET( a, size, j, k ) - m * MATRIX_GET( a, size, i, k ) );
-                b[j] -= m * b[i];
-            }
+        // Update the other rows while the pivot is in flight.
+        #pragma omp parallel for
+        for( j = my_first; j < size; j += p ) {
+            if( j != early_1 && j != early_2 ) update_row( system, pivot, i, j, next + 1 );
         }
+
+        finish_pivot( system, &exchange );
     }
-    return 0;
+
+    gaussian_elimination_time = MPI_Wtime( ) - start_time;
+    free( buffers );
+    return return_code;
 }
 
 
-//! Does the back substitution step of solving the system.
-static int back_substitution( int size, floating_type *a, floating_type *b )
+//! Does the back substitution step of solving the system, leaving the solution in x everywhere.
+/*!
+ * Working up from the bottom, the unknowns are found BACK_SUBSTITUTION_BLOCK at a time. The
+ * processes share the part of the block's rows in the block's columns (and their driving
+ * vector values) with an all gather, and each process solves the small triangular system for
+ * the block's unknowns. Each process then subtracts the contribution of those unknowns from
+ * the driving vector values of its rows above the block. The matrix is never collected on a
+ * single process and the solution is known by every process when the loop finishes.
+ */
+static int back_substitution( const struct LocalSystem *system, floating_type *x )
 {
-    floating_type sum;
-    int           i, j;
+    const int size = system->size;
+    const int p = system->number_of_processes;
+    const int my_rank = system->my_rank;
+    const int stride = BACK_SUBSTITUTION_BLOCK + 1;
+    floating_type *block = (floating_type *)malloc( BACK_SUBSTITUTION_BLOCK * stride * sizeof( floating_type ) );
+    floating_type *mine  = (floating_type *)malloc( BACK_SUBSTITUTION_BLOCK * stride * sizeof( floating_type ) );
+    int *counts  = (int *)malloc( p * sizeof( int ) );
+    int *offsets = (int *)malloc( p * sizeof( int ) );
+    int  return_code = 0;
 
-    for( i = size - 1; i >=0; --i ) {
-        if( fabs( MATRIX_GET( a, size, i, i ) ) <= 1.0E-6 ) {
-            return -2;
+    for( int last = size; last > 0; last -= BACK_SUBSTITUTION_BLOCK ) {
+        const int first = ( last > BACK_SUBSTITUTION_BLOCK ) ? last - BACK_SUBSTITUTION_BLOCK : 0;
+        const int width = last - first;
+
+        // Collect my rows of the block, each followed by its driving vector value.
+        int my_count = 0;
+        for( int j = first_owned( system, first, my_rank ); j < last; j += p ) {
+            memcpy( &mine[my_count * ( width + 1 )], local_row( system, j ) + first, width * sizeof( floating_type ) );
+            mine[my_count * ( width + 1 ) + width] = *local_b( system, j );
+            ++my_count;
+        }
+        int total = 0;
+        for( int rank = 0; rank < p; ++rank ) {
+            const int rank_first = first_owned( system, first, rank );
+            counts[rank] = ( rank_first < last ) ? ( ( last - 1 - rank_first ) / p + 1 ) * ( width + 1 ) : 0;
+            offsets[rank] = total;
+            total += counts[rank];
         }
+        MPI_Allgatherv( mine, my_count * ( width + 1 ), MPI_DOUBLE, block, counts, offsets, MPI_DOUBLE, MPI_COMM_WORLD );
 
-        sum = b[i];
-        for( j = i + 1; j < size; ++j ) {
-            sum -= MATRIX_GET( a, size, i, j ) * b[j];
+        // Solve for the block's unknowns. Every process gets the same answer.
+        for( int j = last - 1; j >= first; --j ) {
+            const int rank = j % p;
+            const floating_type *row =
+                &block[offsets[rank] + ( ( j - first_owned( system, first, rank ) ) / p ) * ( width + 1 )];
+            floating_type sum = row[width];
+            for( int c = j + 1; c < last; ++c )
+                sum -= row[c - first] * x[c];
+            if( fabs( row[j - first] ) <= system->threshold ) {
+                return_code = -2;
+                break;
+            }
+            x[j] = sum / row[j - first];
+        }
+        if( return_code != 0 ) break;
+
+        // Remove the block's unknowns from the rows above it.
+        #pragma omp parallel for
+        for( int j = my_rank; j < first; j += p ) {
+            const floating_type *row = local_row( system, j );
+            floating_type sum = 0.0;
+            for( int c = first; c < last; ++c )
+                sum += row[c] * x[c];
+            *local_b( system, j ) -= sum;
         }
-        b[i] = sum / MATRIX_GET( a, size, i, i );
     }
-    return 0;
+
+    free( offsets );
+    free( counts );
+    free( mine );
+    free( block );
+    return return_code;
+}
+
+
+int gaussian_solve_distributed( int size, floating_type *a, floating_type *b, floating_type *x )
+{
+    struct LocalSystem system;
+
+    if( size <= 0 ) return -1;
+    system.size = size;
+    system.a = a;
+    system.b = b;
+    MPI_Comm_size( MPI_COMM_WORLD, &system.number_of_processes );
+    MPI_Comm_rank( MPI_COMM_WORLD, &system.my_rank );
+
+    // The threshold depends on the largest coefficient of the whole matrix, wherever it is.
+    const int my_rows =
+        ( system.my_rank < size ) ? ( size - 1 - system.my_rank ) / system.number_of_processes + 1 : 0;
+    double my_threshold = pivot_threshold( my_rows, size, a, size );
+    MPI_Allreduce( &my_threshold, &system.threshold, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD );
+
+    int return_code = elimination( &system );
+    if( return_code == 0 )
+        return_code = back_substitution( &system, x );
+    return return_code;
 }
 
 
@@ -120,13 +380,36 @@ int gaussian_solve( int size, floating_type *a, floating_type *b )
     int number_of_processes;
     int my_rank;
 
+    if( size <= 0 ) return -1;
     MPI_Comm_size( MPI_COMM_WORLD, &number_of_processes );
     MPI_Comm_rank( MPI_COMM_WORLD, &my_rank );
 
-    int return_code = elimination( number_of_processes, my_rank, size, a, b );
+    // Copy out this process's rows.
+    const int my_rows = ( my_rank < size ) ? ( size - 1 - my_rank ) / number_of_processes + 1 : 0;
+    floating_type *local_a = (floating_type *)malloc( ( (size_t)my_rows * size + 1 ) * sizeof( floating_type ) );
+    floating_type *local_b = (floating_type *)malloc( ( my_rows + 1 ) * sizeof( floating_type ) );
+    for( int k = 0; k < my_rows; ++k ) {
+        const int row = my_rank + k * number_of_processes;
+        memcpy( &local_a[(size_t)k * size], MATRIX_GET_ROW( a, size, row ), size * sizeof( floating_type ) );
+        local_b[k] = b[row];
+    }
 
-    // Only the rank zero process does back_substitution. The other processes can terminate.
-    if( my_rank == 0 && return_code == 0 )
-        return_code = back_substitution( size, a, b );
+    // The solution can go directly into b since the original values have been copied.
+    int return_code = gaussian_solve_distributed( size, local_a, local_b, b );
+
+    free( local_b );
+    free( local_a );
     return return_code;
 }
+
+
+double gaussian_communication_fraction( void )
+{
+    return ( gaussian_elimination_time > 0.0 ) ? gaussian_wait_time / gaussian_elimination_time : 0.0;
+}
+
+
+double gaussian_communication_volume( void )
+{
+    return gaussian_received_bytes;
+}
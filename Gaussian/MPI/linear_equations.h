@@ -14,12 +14,16 @@ typedef double floating_type;
 // Macros for handling matricies.
 // These macros manipulate a linear array as if it was a two dimensional array.
 // TODO: Create a matrix abstraction? Or would the overhead of doing so be too great?
-#define MATRIX_MAKE( size )  ((floating_type *)malloc( (size) * (size) * sizeof( floating_type ) ))
+// The offsets are computed with size_t since size * size overflows an int for large systems.
+#define MATRIX_MAKE( size )  ((floating_type *)malloc( (size_t)(size) * (size) * sizeof( floating_type ) ))
 #define MATRIX_DESTROY( matrix )                       ( free( matrix ) )
-#define MATRIX_GET( matrix, size, row, column )        ( (matrix)[(row)*(size) + (column)] )
-#define MATRIX_GET_REF( matrix, size, row, column )    (&(matrix)[(row)*(size) + (column)] )
-#define MATRIX_GET_ROW( matrix, size, row )            (&(matrix)[(row)*(size)] )
-#define MATRIX_PUT( matrix, size, row, column, value ) ( (matrix)[(row)*(size) + (column)] = (value) )
+#define MATRIX_GET( matrix, size, row, column )        ( (matrix)[(size_t)(row)*(size) + (column)] )
+#define MATRIX_GET_REF( matrix, size, row, column )    (&(matrix)[(size_t)(row)*(size) + (column)] )
+#define MATRIX_GET_ROW( matrix, size, row )            (&(matrix)[(size_t)(row)*(size)] )
+#define MATRIX_PUT( matrix, size, row, column, value ) ( (matrix)[(size_t)(row)*(size) + (column)] = (value) )
+
+// The number of rows and columns in each tile of the two dimensional grid solver.
+#define GRID_BLOCK_SIZE 64
 
 //! Gaussian Elimination using 'a' as the matrix of coefficients and 'b' as the driving vector.
 /*!
@@ -28,4 +32,53 @@ typedef double floating_type;
  */
 int gaussian_solve( int size, floating_type *a, floating_type *b );
 
+//! As gaussian_solve but each process is given only its own rows of the system.
+/*!
+ * With p processes, the process of rank r holds rows r, r + p, r + 2p, ... one after another in
+ * 'a' and their driving vector values in 'b'. Both arrays are overwritten. On success the full
+ * solution is returned in 'x' (of 'size' elements) on every process.
+ */
+int gaussian_solve_distributed( int size, floating_type *a, floating_type *b, floating_type *x );
+
+//! As gaussian_solve but distributes the system over a two dimensional grid of processes.
+/*!
+ * The grid is as square as the number of processes allows unless the environment variable
+ * GAUSSIAN_GRID gives its shape (for example "2x3" for two rows of three processes).
+ */
+int gaussian_solve_2d( int size, floating_type *a, floating_type *b );
+
+//! Gets the shape of the process grid used by the 2D solver and the size of this process's part.
+/*!
+ * The grid has grid_rows x grid_columns processes and the process of rank r is in grid row
+ * r / grid_columns and grid column r % grid_columns. The driving vector is treated as column
+ * 'size' of the matrix. The matrix is divided into tiles of GRID_BLOCK_SIZE rows and columns and
+ * tile (I, J) belongs to grid row I % grid_rows and grid column J % grid_columns. This is the
+ * distribution of MPI_Type_create_darray with MPI_DISTRIBUTE_CYCLIC and GRID_BLOCK_SIZE. This
+ * process's elements form a local_rows x local_columns matrix.
+ */
+void gaussian_grid_layout( int size, int *grid_rows, int *grid_columns, int *local_rows, int *local_columns );
+
+//! As gaussian_solve_2d but each process is given only its own part of the system.
+/*!
+ * The part is the local_rows x local_columns matrix described by gaussian_grid_layout, in
+ * row-major order. It is overwritten. On success the full solution is returned in 'x' (of
+ * 'size' elements) on every process.
+ */
+int gaussian_solve_2d_distributed( int size, floating_type *local, floating_type *x );
+
+//! Returns the fraction of the last elimination this process spent waiting for communication.
+/*!
+ * The time counted is the time spent blocked in MPI calls; communication that overlaps
+ * computation isn't counted.
+ */
+double gaussian_communication_fraction( void );
+
+//! Returns the number of bytes of matrix data this process received in the last elimination.
+double gaussian_communication_volume( void );
+
+// Statistics recorded by both solvers for the functions above.
+extern double gaussian_wait_time;
+extern double gaussian_elimination_time;
+extern double gaussian_received_bytes;
+
 #endif
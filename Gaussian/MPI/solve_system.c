@@ -2,58 +2,316 @@
  *  \file   solve_system.c
  *  \brief  Solve a large system of simultaneous equations.
  *  \author (C) Copyright 2014 by Peter C. Chapin <pchapin@vtc.edu>
+ *
+ * A system in the binary format (see ../C/system_file.h) is read with collective MPI-IO: each
+ * process reads only the rows it owns (or with -2d, the tiles it owns) directly from the file
+ * and the system is solved without ever being assembled on one process. A system in the text
+ * format is read by every process and distributed by the solver.
  */
 
+#include <limits.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <mpi.h>
 #include <Timer.h>
 
 #include "linear_equations.h"
+#include "../C/system_file.h"
+
+// The (approximate) amount of the file, in bytes, each process reads in one collective call.
+#define READ_BATCH_BYTES ( 8 * 1024 * 1024 )
+
+//! Opens a binary system file and checks that it holds a dense system.
+/*!
+ * Every process must call this function. Returns zero on success and non-zero (on every
+ * process, with the file closed) if the file can't be read or isn't a dense binary system.
+ */
+static int open_binary_system( const char *name, MPI_File *file, struct system_file_header *header )
+{
+    MPI_Offset file_length;
+
+    if( MPI_File_open( MPI_COMM_WORLD, (char *)name, MPI_MODE_RDONLY, MPI_INFO_NULL, file ) != MPI_SUCCESS )
+        return -1;
+
+    // The header is small; every process reads it.
+    MPI_File_read_all( *file, header, sizeof( *header ), MPI_BYTE, MPI_STATUS_IGNORE );
+    MPI_File_get_size( *file, &file_length );
+    if( !system_file_header_valid( header ) ||
+        ( header->flags & SYSTEM_FILE_SPARSE ) != 0 ||
+        header->size >= INT_MAX ||
+        system_file_length( header ) > (uint64_t)file_length ) {
+        MPI_File_close( file );
+        return -1;
+    }
+    return 0;
+}
+
+
+//! Reads 'rows' rows of 'length' elements each through the file's view.
+/*!
+ * The rows are read in batches of about READ_BATCH_BYTES. Each row is converted to
+ * floating_type and passed to store along with its index and the context. Every process must
+ * call this function (the reads are collective) even if it has no rows.
+ */
+static void read_rows(
+    MPI_File file, size_t element_size, int rows, int length,
+    void ( *store )( int index, const floating_type *row, void *context ), void *context )
+{
+    const size_t row_bytes = (size_t)length * element_size;
+    MPI_Datatype element = ( element_size == sizeof( double ) ) ? MPI_DOUBLE : MPI_FLOAT;
+    MPI_Datatype row;
+
+    MPI_Type_contiguous( length, element, &row );
+    MPI_Type_commit( &row );
+
+    int batch_rows = ( row_bytes > 0 ) ? (int)( READ_BATCH_BYTES / row_bytes ) : rows;
+    if( batch_rows < 1 ) batch_rows = 1;
+    if( batch_rows > rows && rows > 0 ) batch_rows = rows;
+
+    // The reads are collective so every process makes the same number of them, even if it has run out of rows.
+    int max_rows;
+    MPI_Allreduce( &rows, &max_rows, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD );
+    int max_batch;
+    MPI_Allreduce( &batch_rows, &max_batch, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD );
+    const int batch_count = ( max_batch > 0 ) ? ( max_rows + max_batch - 1 ) / max_batch : 0;
+
+    unsigned char *buffer = (unsigned char *)malloc( max_batch * row_bytes + 1 );
+    floating_type *converted = (floating_type *)malloc( ( length + 1 ) * sizeof( floating_type ) );
+
+    for( int batch = 0, done = 0; batch < batch_count; ++batch ) {
+        const int count = ( rows - done < max_batch ) ? rows - done : max_batch;
+        MPI_File_read_all( file, buffer, count, row, MPI_STATUS_IGNORE );
+
+        for( int r = 0; r < count; ++r ) {
+            if( element == MPI_DOUBLE ) {
+                store( done + r, (const double *)( buffer + r * row_bytes ), context );
+            }
+            else {
+                const float *source = (const float *)( buffer + r * row_bytes );
+                for( int c = 0; c < length; ++c ) converted[c] = source[c];
+                store( done + r, converted, context );
+            }
+        }
+        done += count;
+    }
+
+    free( converted );
+    free( buffer );
+    MPI_Type_free( &row );
+}
+
+
+struct RowTarget {
+    int            size;
+    floating_type *a;
+    floating_type *b;
+};
+
+//! Splits a row of the file into its coefficients and driving vector value.
+static void store_row( int index, const floating_type *row, void *context )
+{
+    struct RowTarget *target = (struct RowTarget *)context;
+    memcpy( &target->a[(size_t)index * target->size], row, target->size * sizeof( floating_type ) );
+    target->b[index] = row[target->size];
+}
+
+
+//! Reads rows first, first + step, first + 2*step, ... of a dense binary system file.
+/*!
+ * Every process must call this function. The rows are returned in *a (one after another) and
+ * their driving vector values in *b; both should be released with free( ). Returns zero on
+ * success and non-zero (on every process) if the file can't be read or isn't a dense binary
+ * system.
+ */
+static int read_binary_system( const char *name, int first, int step, int *size, floating_type **a, floating_type **b )
+{
+    MPI_File file;
+    struct system_file_header header;
+
+    if( open_binary_system( name, &file, &header ) != 0 ) return -1;
+
+    const int n = (int)header.size;
+    const size_t row_bytes = ( n + 1 ) * header.element_size;
+    MPI_Datatype element = ( header.element_size == sizeof( double ) ) ? MPI_DOUBLE : MPI_FLOAT;
+    MPI_Datatype row, strided_row;
+
+    // The file is viewed as this process's rows only: one row followed by a gap of step - 1 rows.
+    MPI_Type_contiguous( n + 1, element, &row );
+    MPI_Type_create_resized( row, 0, (MPI_Aint)( step * row_bytes ), &strided_row );
+    MPI_Type_commit( &strided_row );
+    MPI_File_set_view(
+        file, (MPI_Offset)( sizeof( header ) + (size_t)first * row_bytes ), element, strided_row, "native", MPI_INFO_NULL );
+
+    const int my_rows = ( first < n ) ? ( n - 1 - first ) / step + 1 : 0;
+    struct RowTarget target;
+    target.size = n;
+    target.a = (floating_type *)malloc( ( (size_t)my_rows * n + 1 ) * sizeof( floating_type ) );
+    target.b = (floating_type *)malloc( ( my_rows + 1 ) * sizeof( floating_type ) );
+    read_rows( file, header.element_size, my_rows, n + 1, store_row, &target );
+
+    *size = n;
+    *a = target.a;
+    *b = target.b;
+    MPI_Type_free( &strided_row );
+    MPI_Type_free( &row );
+    MPI_File_close( &file );
+    return 0;
+}
+
+
+struct TileTarget {
+    int            local_columns;
+    floating_type *local;
+};
+
+//! Stores one of this process's rows of tiles.
+static void store_tile_row( int index, const floating_type *row, void *context )
+{
+    struct TileTarget *target = (struct TileTarget *)context;
+    memcpy( &target->local[(size_t)index * target->local_columns], row, target->local_columns * sizeof( floating_type ) );
+}
+
+
+//! Reads this process's tiles of a dense binary system file for gaussian_solve_2d_distributed.
+/*!
+ * Every process must call this function. The tiles are returned in *local, which should be
+ * released with free( ). Returns zero on success and non-zero (on every process) if the file
+ * can't be read or isn't a dense binary system.
+ */
+static int read_binary_tiles( const char *name, int *size, floating_type **local )
+{
+    MPI_File file;
+    struct system_file_header header;
+    int my_rank;
+
+    if( open_binary_system( name, &file, &header ) != 0 ) return -1;
+    MPI_Comm_rank( MPI_COMM_WORLD, &my_rank );
+
+    const int n = (int)header.size;
+    int grid_rows, grid_columns, local_rows, local_columns;
+    gaussian_grid_layout( n, &grid_rows, &grid_columns, &local_rows, &local_columns );
+
+    // The file (after the header) is an n x (n + 1) matrix distributed as the solver expects.
+    MPI_Datatype element = ( header.element_size == sizeof( double ) ) ? MPI_DOUBLE : MPI_FLOAT;
+    MPI_Datatype tiles;
+    int global_sizes[2] = { n, n + 1 };
+    int distributions[2] = { MPI_DISTRIBUTE_CYCLIC, MPI_DISTRIBUTE_CYCLIC };
+    int block_sizes[2] = { GRID_BLOCK_SIZE, GRID_BLOCK_SIZE };
+    int grid_sizes[2] = { grid_rows, grid_columns };
+    MPI_Type_create_darray(
+        grid_rows * grid_columns, my_rank, 2, global_sizes, distributions, block_sizes, grid_sizes, MPI_ORDER_C, element, &tiles );
+    MPI_Type_commit( &tiles );
+    MPI_File_set_view( file, (MPI_Offset)sizeof( header ), element, tiles, "native", MPI_INFO_NULL );
+
+    struct TileTarget target;
+    target.local_columns = local_columns;
+    target.local = (floating_type *)malloc( ( (size_t)local_rows * local_columns + 1 ) * sizeof( floating_type ) );
+    read_rows( file, header.element_size, local_rows, local_columns, store_tile_row, &target );
+
+    *size = n;
+    *local = target.local;
+    MPI_Type_free( &tiles );
+    MPI_File_close( &file );
+    return 0;
+}
+
 
 int main( int argc, char *argv[] )
 {
     FILE *input_file;
     int   size;
     int   my_rank;
+    int   use_grid = 0;
 
     MPI_Init( &argc, &argv );
     MPI_Comm_rank( MPI_COMM_WORLD, &my_rank );
 
+    // The option -2d selects the solver that uses a two dimensional grid of processes.
+    if( argc == 3 && strcmp( argv[1], "-2d" ) == 0 ) {
+        use_grid = 1;
+        --argc;
+        ++argv;
+    }
+
     if( argc != 2 ) {
         printf( "Error: Expected the name of a system definition file.\n" );
+        printf( "Usage: LinEqMPI [-2d] system-file\n" );
         MPI_Finalize( );
         return EXIT_FAILURE;
     }
 
-    if( (input_file = fopen( argv[1], "r" )) == NULL ) {
+    if( (input_file = fopen( argv[1], "rb" )) == NULL ) {
         printf("Error: Can not open the system definition file.\n");
         MPI_Finalize( );
         return EXIT_FAILURE;
     }
 
-    // Get the size.
-    fscanf( input_file, "%d", &size );
+    char magic[4];
+    const int binary = system_file_is_binary( magic, fread( magic, 1, sizeof( magic ), input_file ) );
+    rewind( input_file );
+
+    floating_type *a;
+    floating_type *b;
+    floating_type *x = NULL;
+
+    if( binary ) {
+        fclose( input_file );
+
+        // Read only the rows (or for the 2D solver, the tiles) I own.
+        int number_of_processes;
+        MPI_Comm_size( MPI_COMM_WORLD, &number_of_processes );
+        b = NULL;
+        int read_error = use_grid ? read_binary_tiles( argv[1], &size, &a )
+                                  : read_binary_system( argv[1], my_rank, number_of_processes, &size, &a, &b );
+        if( read_error ) {
+            if( my_rank == 0 ) printf( "Error: The system definition file is not a dense binary system.\n" );
+            MPI_Finalize( );
+            return EXIT_FAILURE;
+        }
+        x = (floating_type *)malloc( size * sizeof( floating_type ) );
+    }
+    else {
+        // Get the size.
+        fscanf( input_file, "%d", &size );
 
-    // Allocate the arrays.
-    floating_type *a = MATRIX_MAKE( size );
-    floating_type *b = (floating_type *)malloc( size * sizeof( floating_type ) );
+        // Allocate the arrays.
+        a = MATRIX_MAKE( size );
+        b = (floating_type *)malloc( size * sizeof( floating_type ) );
 
-    // Get coefficients.
-    for( size_t i = 0; i < size; ++i ) {
-        for( size_t j = 0; j < size; ++j ) {
-            fscanf( input_file, "%lf", MATRIX_GET_REF( a, size, i, j ) );  // Nasty type unsafety!
+        // Get coefficients.
+        for( size_t i = 0; i < size; ++i ) {
+            for( size_t j = 0; j < size; ++j ) {
+                fscanf( input_file, "%lf", MATRIX_GET_REF( a, size, i, j ) );  // Nasty type unsafety!
+            }
+            fscanf( input_file, "%lf", &b[i] );  // Here too!
         }
-        fscanf( input_file, "%lf", &b[i] );  // Here too!
+        fclose( input_file );
     }
-    fclose( input_file );
 
     Timer stopwatch;
 
     Timer_initialize( &stopwatch );
     Timer_start( &stopwatch );
-    int error = gaussian_solve( size, a, b );
+    int error;
+    if( use_grid && x != NULL ) error = gaussian_solve_2d_distributed( size, a, x );
+    else if( use_grid ) error = gaussian_solve_2d( size, a, b );
+    else if( x != NULL ) error = gaussian_solve_distributed( size, a, b, x );
+    else error = gaussian_solve( size, a, b );
     Timer_stop( &stopwatch );
+    const floating_type *solution = ( x != NULL ) ? x : b;
+
+    // Summarize the time each process spent waiting for communication and how much it received.
+    double wait_fraction = gaussian_communication_fraction( );
+    double volume = gaussian_communication_volume( );
+    double wait_sum, wait_max;
+    double volume_sum, volume_max;
+    int    number_of_processes;
+    MPI_Comm_size( MPI_COMM_WORLD, &number_of_processes );
+    MPI_Reduce( &wait_fraction, &wait_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
+    MPI_Reduce( &wait_fraction, &wait_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD );
+    MPI_Reduce( &volume, &volume_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD );
+    MPI_Reduce( &volume, &volume_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD );
 
     // Only the rank zero process displays the results.
     if( my_rank == 0 ) {
@@ -63,16 +321,21 @@ int main( int argc, char *argv[] )
         else {
             printf( "\nSolution is\n" );
             for( int i = 0; i < size; ++i ) {
-                printf( " x(%4d) = %9.5f\n", i, b[i] );
+                printf( " x(%4d) = %9.5f\n", i, solution[i] );
             }
 
             printf( "\nExecution time = %ld milliseconds\n", Timer_time( &stopwatch ) );
+            printf( "Communication wait = %.1f%% of the elimination (mean), %.1f%% (max)\n",
+                    100.0 * wait_sum / number_of_processes, 100.0 * wait_max );
+            printf( "Data received = %.2f MB per process (mean), %.2f MB (max)\n",
+                    volume_sum / number_of_processes / 1.0E6, volume_max / 1.0E6 );
         }
     }
 
     // Clean up the dynamically allocated space.
     MATRIX_DESTROY( a );
     free( b );
+    free( x );
 
     MPI_Finalize( );
     return EXIT_SUCCESS;
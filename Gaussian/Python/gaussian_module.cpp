@@ -0,0 +1,353 @@
+/*!
+    \file   gaussian_module.cpp
+    \brief  A CPython extension module that gives Python access to libgaussian.
+    \author (C) Copyright 2026 by Peter Chapin <pchapin@vermontstate.edu>
+
+    The arrays are taken through the buffer protocol, so NumPy arrays (and array.array, or
+    memoryview objects cast to the right shape) are used in place. Nothing is copied: the
+    matrix is factored or eliminated where it is and the solution replaces the driving vector,
+    just as with the C interface. The arrays must hold C doubles in row-major order.
+
+    The GIL is released while a system is being solved, so several Python threads can solve
+    systems at the same time. The buffers stay locked (they can't be resized) until the solve
+    finishes, but the caller must not otherwise use the arrays from another thread meanwhile.
+
+    Functions:
+
+        solve(a, b, backend=None)   Solves a x = b in place with libgaussian; returns b.
+        lu_factor(a, threads=0)     Factors a in place; returns the pivots.
+        lu_solve(lu, pivots, b, threads=0)
+                                    Solves for b (n or n x k) in place with the factors; returns b.
+        backends()                  Returns the names of the backends.
+        select_backend(name)        Selects the backend used by solve (None for the default).
+        backend_for(size)           Returns the backend solve uses for a system of that size.
+*/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <cstddef>
+#include <cstring>
+#include "../Cpp/lu_decomposition.hpp"
+#include "../Library/libgaussian.h"
+
+namespace {
+
+    //! Releases a buffer when it goes out of scope.
+    class BufferHolder {
+    public:
+        BufferHolder( ) : valid( false ) { }
+       ~BufferHolder( ) { if( valid ) PyBuffer_Release( &view ); }
+
+        BufferHolder( const BufferHolder & ) = delete;
+        BufferHolder &operator=( const BufferHolder & ) = delete;
+
+        Py_buffer view;
+        bool      valid;
+    };
+
+
+    //! Returns true if format describes one native element of the given kind.
+    bool format_is( const char *format, const char *kinds )
+    {
+        if( format == nullptr ) return false;
+        if( *format == '@' || *format == '=' ) ++format;
+        #if PY_BIG_ENDIAN
+        else if( *format == '>' || *format == '!' ) ++format;
+        #else
+        else if( *format == '<' ) ++format;
+        #endif
+        return format[0] != '\0' && format[1] == '\0' && std::strchr( kinds, format[0] ) != nullptr;
+    }
+
+
+    //! Gets a writable, C contiguous buffer of doubles with one or two dimensions.
+    /*!
+     *  Sets a Python exception and returns false if the object isn't suitable.
+     */
+    bool get_doubles( PyObject *object, const char *name, int max_dimensions, BufferHolder &holder )
+    {
+        if( PyObject_GetBuffer( object, &holder.view, PyBUF_WRITABLE | PyBUF_FORMAT | PyBUF_C_CONTIGUOUS ) != 0 ) {
+            PyErr_Format( PyExc_TypeError, "%s must be a writable, C contiguous array of float64", name );
+            return false;
+        }
+        holder.valid = true;
+        if( !format_is( holder.view.format, "d" ) || holder.view.itemsize != sizeof( double ) ) {
+            PyErr_Format( PyExc_TypeError, "%s must hold float64 values", name );
+            return false;
+        }
+        if( holder.view.ndim < 1 || holder.view.ndim > max_dimensions ) {
+            PyErr_Format( PyExc_ValueError, "%s has the wrong number of dimensions", name );
+            return false;
+        }
+        return true;
+    }
+
+
+    //! Gets the matrix of a system. Sets a Python exception and returns false if it isn't square.
+    bool get_matrix( PyObject *object, BufferHolder &holder, std::size_t &size )
+    {
+        if( !get_doubles( object, "a", 2, holder ) ) return false;
+        if( holder.view.ndim != 2 || holder.view.shape[0] != holder.view.shape[1] || holder.view.shape[0] == 0 ) {
+            PyErr_SetString( PyExc_ValueError, "a must be a square, non-empty matrix" );
+            return false;
+        }
+        size = static_cast<std::size_t>( holder.view.shape[0] );
+        return true;
+    }
+
+
+    //! Returns true if two buffers share memory.
+    bool overlap( const Py_buffer &first, const Py_buffer &second )
+    {
+        const char *first_start  = static_cast<const char *>( first.buf );
+        const char *second_start = static_cast<const char *>( second.buf );
+        return first_start < second_start + second.len && second_start < first_start + first.len;
+    }
+
+
+    //! Turns a result code from libgaussian into a Python exception.
+    PyObject *solve_error( int result )
+    {
+        if( result == GAUSSIAN_UNAVAILABLE ) {
+            PyErr_SetString( PyExc_RuntimeError, "the solver is unknown or could not be started" );
+        }
+        else {
+            PyErr_SetString( PyExc_ArithmeticError, "the system is degenerate" );
+        }
+        return nullptr;
+    }
+
+
+    PyObject *gaussian_module_solve( PyObject *, PyObject *args, PyObject *keywords )
+    {
+        static const char *keyword_list[] = { "a", "b", "backend", nullptr };
+        PyObject   *a_object;
+        PyObject   *b_object;
+        const char *backend = nullptr;
+
+        if( !PyArg_ParseTupleAndKeywords(
+                args, keywords, "OO|z", const_cast<char **>( keyword_list ), &a_object, &b_object, &backend ) ) {
+            return nullptr;
+        }
+
+        BufferHolder a;
+        BufferHolder b;
+        std::size_t  size;
+        if( !get_matrix( a_object, a, size ) || !get_doubles( b_object, "b", 1, b ) ) return nullptr;
+        if( static_cast<std::size_t>( b.view.shape[0] ) != size ) {
+            PyErr_SetString( PyExc_ValueError, "b must have one element for each row of a" );
+            return nullptr;
+        }
+        if( overlap( a.view, b.view ) ) {
+            PyErr_SetString( PyExc_ValueError, "a and b must not share memory" );
+            return nullptr;
+        }
+
+        int result;
+        double *a_data = static_cast<double *>( a.view.buf );
+        double *b_data = static_cast<double *>( b.view.buf );
+        Py_BEGIN_ALLOW_THREADS
+        result = gaussian_solve_with( backend, size, a_data, b_data );
+        Py_END_ALLOW_THREADS
+
+        if( result != GAUSSIAN_SUCCESS ) return solve_error( result );
+        Py_INCREF( b_object );
+        return b_object;
+    }
+
+
+    PyObject *gaussian_module_lu_factor( PyObject *, PyObject *args, PyObject *keywords )
+    {
+        static const char *keyword_list[] = { "a", "threads", nullptr };
+        PyObject *a_object;
+        unsigned  thread_count = 0;
+
+        if( !PyArg_ParseTupleAndKeywords(
+                args, keywords, "O|I", const_cast<char **>( keyword_list ), &a_object, &thread_count ) ) {
+            return nullptr;
+        }
+
+        BufferHolder a;
+        std::size_t  size;
+        if( !get_matrix( a_object, a, size ) ) return nullptr;
+
+        // The pivots are returned as a memoryview of size_t over a bytearray, so Python can index
+        // them and lu_solve can use them without conversion.
+        PyObject *storage = PyByteArray_FromStringAndSize( nullptr, static_cast<Py_ssize_t>( size * sizeof( std::size_t ) ) );
+        if( storage == nullptr ) return nullptr;
+        std::size_t *pivots = reinterpret_cast<std::size_t *>( PyByteArray_AS_STRING( storage ) );
+
+        int result = GAUSSIAN_SUCCESS;
+        Matrix<double> lu( static_cast<double *>( a.view.buf ), size, size );
+        Py_BEGIN_ALLOW_THREADS
+        try {
+            if( !lu_factor( lu, pivots, thread_count ) ) result = GAUSSIAN_FAILED;
+        }
+        catch( ... ) {
+            result = GAUSSIAN_UNAVAILABLE;
+        }
+        Py_END_ALLOW_THREADS
+
+        if( result != GAUSSIAN_SUCCESS ) {
+            Py_DECREF( storage );
+            return solve_error( result );
+        }
+        PyObject *bytes_view = PyMemoryView_FromObject( storage );
+        Py_DECREF( storage );
+        if( bytes_view == nullptr ) return nullptr;
+        PyObject *pivot_view = PyObject_CallMethod( bytes_view, "cast", "s", "N" );
+        Py_DECREF( bytes_view );
+        return pivot_view;
+    }
+
+
+    PyObject *gaussian_module_lu_solve( PyObject *, PyObject *args, PyObject *keywords )
+    {
+        static const char *keyword_list[] = { "lu", "pivots", "b", "threads", nullptr };
+        PyObject *lu_object;
+        PyObject *pivots_object;
+        PyObject *b_object;
+        unsigned  thread_count = 0;
+
+        if( !PyArg_ParseTupleAndKeywords(
+                args, keywords, "OOO|I", const_cast<char **>( keyword_list ),
+                &lu_object, &pivots_object, &b_object, &thread_count ) ) {
+            return nullptr;
+        }
+
+        BufferHolder lu;
+        BufferHolder pivots;
+        BufferHolder b;
+        std::size_t  size;
+        if( !get_matrix( lu_object, lu, size ) || !get_doubles( b_object, "b", 2, b ) ) return nullptr;
+        if( PyObject_GetBuffer( pivots_object, &pivots.view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS ) != 0 ) {
+            PyErr_SetString( PyExc_TypeError, "pivots must be the array returned by lu_factor" );
+            return nullptr;
+        }
+        pivots.valid = true;
+        if( pivots.view.ndim != 1 || static_cast<std::size_t>( pivots.view.shape[0] ) != size ||
+            pivots.view.itemsize != sizeof( std::size_t ) || !format_is( pivots.view.format, "NLQ" ) ) {
+            PyErr_SetString( PyExc_ValueError, "pivots must be the array returned by lu_factor" );
+            return nullptr;
+        }
+        if( static_cast<std::size_t>( b.view.shape[0] ) != size ) {
+            PyErr_SetString( PyExc_ValueError, "b must have one row for each row of lu" );
+            return nullptr;
+        }
+        if( overlap( lu.view, b.view ) ) {
+            PyErr_SetString( PyExc_ValueError, "lu and b must not share memory" );
+            return nullptr;
+        }
+
+        // Check the pivots now; a bad one would make lu_solve write outside of b.
+        const std::size_t *pivot_data = static_cast<const std::size_t *>( pivots.view.buf );
+        for( std::size_t i = 0; i < size; ++i ) {
+            if( pivot_data[i] < i || pivot_data[i] >= size ) {
+                PyErr_SetString( PyExc_ValueError, "pivots must be the array returned by lu_factor" );
+                return nullptr;
+            }
+        }
+
+        const std::size_t rhs_count = ( b.view.ndim == 2 ) ? static_cast<std::size_t>( b.view.shape[1] ) : 1;
+        const Matrix<double> factors( static_cast<double *>( lu.view.buf ), size, size );
+        double *b_data = static_cast<double *>( b.view.buf );
+        int result = GAUSSIAN_SUCCESS;
+        Py_BEGIN_ALLOW_THREADS
+        try {
+            if( rhs_count != 0 ) lu_solve( factors, pivot_data, b_data, rhs_count, thread_count );
+        }
+        catch( ... ) {
+            result = GAUSSIAN_UNAVAILABLE;
+        }
+        Py_END_ALLOW_THREADS
+
+        if( result != GAUSSIAN_SUCCESS ) return solve_error( result );
+        Py_INCREF( b_object );
+        return b_object;
+    }
+
+
+    PyObject *gaussian_module_backends( PyObject *, PyObject * )
+    {
+        const std::size_t count = gaussian_backend_count( );
+        PyObject *names = PyList_New( static_cast<Py_ssize_t>( count ) );
+        if( names == nullptr ) return nullptr;
+        for( std::size_t i = 0; i < count; ++i ) {
+            PyObject *name = PyUnicode_FromString( gaussian_backend_name( i ) );
+            if( name == nullptr ) {
+                Py_DECREF( names );
+                return nullptr;
+            }
+            PyList_SET_ITEM( names, static_cast<Py_ssize_t>( i ), name );
+        }
+        return names;
+    }
+
+
+    PyObject *gaussian_module_select_backend( PyObject *, PyObject *args )
+    {
+        const char *name;
+        if( !PyArg_ParseTuple( args, "z", &name ) ) return nullptr;
+        if( gaussian_select_backend( name ) != GAUSSIAN_SUCCESS ) {
+            PyErr_Format( PyExc_ValueError, "unknown backend: %s", name );
+            return nullptr;
+        }
+        Py_RETURN_NONE;
+    }
+
+
+    PyObject *gaussian_module_backend_for( PyObject *, PyObject *args )
+    {
+        Py_ssize_t size;
+        if( !PyArg_ParseTuple( args, "n", &size ) ) return nullptr;
+        if( size <= 0 ) {
+            PyErr_SetString( PyExc_ValueError, "size must be positive" );
+            return nullptr;
+        }
+
+        // Calibration can take a while.
+        const char *name;
+        Py_BEGIN_ALLOW_THREADS
+        name = gaussian_backend_for( static_cast<std::size_t>( size ) );
+        Py_END_ALLOW_THREADS
+        return PyUnicode_FromString( name );
+    }
+
+
+    PyMethodDef gaussian_methods[] = {
+        { "solve", reinterpret_cast<PyCFunction>( reinterpret_cast<void (*)( void )>( gaussian_module_solve ) ),
+          METH_VARARGS | METH_KEYWORDS,
+          "solve(a, b, backend=None)\n\nSolves a x = b in place. a (n x n) is overwritten and b (n) is replaced by x." },
+        { "lu_factor", reinterpret_cast<PyCFunction>( reinterpret_cast<void (*)( void )>( gaussian_module_lu_factor ) ),
+          METH_VARARGS | METH_KEYWORDS,
+          "lu_factor(a, threads=0)\n\nFactors a (n x n) in place so that P a = L U and returns the pivots." },
+        { "lu_solve", reinterpret_cast<PyCFunction>( reinterpret_cast<void (*)( void )>( gaussian_module_lu_solve ) ),
+          METH_VARARGS | METH_KEYWORDS,
+          "lu_solve(lu, pivots, b, threads=0)\n\nSolves for each column of b (n or n x k) in place using the factors from lu_factor." },
+        { "backends", gaussian_module_backends, METH_NOARGS,
+          "backends()\n\nReturns the names of the backends that solve can use." },
+        { "select_backend", gaussian_module_select_backend, METH_VARARGS,
+          "select_backend(name)\n\nSelects the backend used by solve: a name, 'auto', or None for the default." },
+        { "backend_for", gaussian_module_backend_for, METH_VARARGS,
+          "backend_for(size)\n\nReturns the backend solve uses for a system of that size, calibrating if necessary." },
+        { nullptr, nullptr, 0, nullptr }
+    };
+
+
+    PyModuleDef gaussian_module = {
+        PyModuleDef_HEAD_INIT,
+        "gaussian",
+        "Solves systems of linear equations in place with libgaussian.",
+        -1,
+        gaussian_methods,
+        nullptr, nullptr, nullptr, nullptr
+    };
+
+}
+
+
+PyMODINIT_FUNC PyInit_gaussian( void )
+{
+    return PyModule_Create( &gaussian_module );
+}
@@ -0,0 +1,51 @@
+#!/usr/bin/python3
+
+import numpy as np
+import timeit
+
+# The extension module built by the Makefile in this folder.
+import gaussian
+
+# Read the coefficients.
+input_file = open("../TestData/2000x2000.dat")
+
+size = 0
+i = 0
+j = 0
+for line in input_file:
+    # If we haven't seen the size yet, deal with that right away (it's in the first line).
+    if size == 0:
+        size = int(line)
+
+        # Create the arrays of the appropriate size up front.
+        a = np.zeros((size, size), dtype=float)
+        b = np.zeros((size), dtype=float)
+
+    else:
+        if j < size:
+            # Get row i.
+            a[i, j] = float(line)
+            j += 1
+        else:
+            # Get the driving vector value. Reset for next row.
+            b[i] = float(line)
+            i += 1
+            j  = 0
+input_file.close()
+print("Coefficients read")
+
+# The elimination step...
+print("Elimination...")
+
+# The arrays are used in place: a is overwritten and b is replaced by the solution. The backend
+# is chosen as described in ../Library/README.md (GAUSSIAN_BACKEND or calibration).
+print("Using backend", gaussian.backend_for(size))
+start_time = timeit.default_timer()
+result = gaussian.solve(a, b)
+stop_time = timeit.default_timer()
+
+# Print result...
+print("\nSolution is")
+print(result)
+    
+print("Time =", stop_time - start_time, "seconds")
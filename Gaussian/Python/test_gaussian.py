@@ -0,0 +1,110 @@
+#!/usr/bin/python3
+
+# Checks the gaussian extension module. Build it first (see README.md), then run this script in
+# this folder or use "make check". It exits with a non-zero status if a check fails.
+#
+# Every backend must recover from a degenerate system: a solver that finds a zero pivot has to
+# release everything it started (threads, barriers, pool work) so that the next solve works.
+# Each backend is therefore given a singular system, which must raise ArithmeticError, and then
+# a valid one, which must be solved accurately, several times in a row. The MPI backends, if the
+# library was built with them, can't be used without MPI and must raise RuntimeError instead.
+#
+# Whether a system is singular must not depend on its scale (see ../C/pivot_threshold.h), so the
+# systems are also given to each backend scaled by SCALE and 1/SCALE.
+
+import sys
+import numpy as np
+
+import gaussian
+
+SIZE = 200
+ATTEMPTS = 3
+SCALE = 1.0E+9
+
+
+def singular_system(rng):
+    # Column 1 is a multiple of column 0, so elimination fails on its second pass rather than
+    # only in back substitution.
+    a = rng.uniform(-1, 1, (SIZE, SIZE))
+    a[:, 1] = 2 * a[:, 0]
+    return a, np.ones(SIZE)
+
+
+def valid_system(rng):
+    a = rng.uniform(-1, 1, (SIZE, SIZE)) + SIZE * np.eye(SIZE)
+    return a, rng.uniform(-1, 1, SIZE)
+
+
+def check_backend(name, rng):
+    for attempt in range(ATTEMPTS):
+        a, b = singular_system(rng)
+        try:
+            gaussian.solve(a, b, name)
+            return "the singular system didn't raise ArithmeticError"
+        except ArithmeticError:
+            pass
+
+        a, b = valid_system(rng)
+        x = gaussian.solve(a.copy(), b.copy(), name)
+        residual = np.abs(a @ x - b).max()
+        if residual > 1e-9:
+            return "the residual after a singular system is {:.3e}".format(residual)
+
+    a, b = singular_system(rng)
+    try:
+        gaussian.solve(a * SCALE, b, name)
+        return "the scaled singular system didn't raise ArithmeticError"
+    except ArithmeticError:
+        pass
+
+    a, b = valid_system(rng)
+    try:
+        x = gaussian.solve(a / SCALE, b.copy(), name)
+    except ArithmeticError:
+        return "the scaled valid system raised ArithmeticError"
+    residual = np.abs(a @ x / SCALE - b).max()
+    if residual > 1e-9:
+        return "the residual of the scaled system is {:.3e}".format(residual)
+    return None
+
+
+def check_mpi_backend(name, rng):
+    a, b = valid_system(rng)
+    try:
+        gaussian.solve(a, b, name)
+        return "solved without MPI"
+    except RuntimeError:
+        return None
+
+
+def check_lu(rng):
+    a, b = valid_system(rng)
+    lu = a.copy()
+    pivots = gaussian.lu_factor(lu)
+    x = gaussian.lu_solve(lu, pivots, b.copy())
+    residual = np.abs(a @ x - b).max()
+    if residual > 1e-9:
+        return "the lu_solve residual is {:.3e}".format(residual)
+
+    a, b = singular_system(rng)
+    try:
+        gaussian.lu_factor(a)
+        return "lu_factor of a singular system didn't raise ArithmeticError"
+    except ArithmeticError:
+        return None
+
+
+rng = np.random.default_rng(1)
+failures = 0
+for name in gaussian.backends():
+    error = check_mpi_backend(name, rng) if name.startswith("mpi") else check_backend(name, rng)
+    print("{:14s} {}".format(name, "ok" if error is None else "FAILED: " + error))
+    if error is not None:
+        failures += 1
+
+error = check_lu(rng)
+print("{:14s} {}".format("lu_factor", "ok" if error is None else "FAILED: " + error))
+if error is not None:
+    failures += 1
+
+sys.exit(1 if failures != 0 else 0)